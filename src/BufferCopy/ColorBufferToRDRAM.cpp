@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <string.h>
 #include <algorithm>
 
 #include "ColorBufferToRDRAM.h"
@@ -239,7 +240,7 @@ u32 ColorBufferToRDRAM::_RGBAtoRGBA32(u32 _c) {
 	return (c.r << 24) | (c.g << 16) | (c.b << 8) | c.a;
 }
 
-void ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
+bool ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
 {
 	const u32 stride = m_pCurFrameBuffer->m_width << m_pCurFrameBuffer->m_size >> 1;
 	const u32 max_height = std::min((u32)VI_GetMaxBufferHeight(m_pCurFrameBuffer->m_width), cutHeight(_startAddress, m_pCurFrameBuffer->m_height, stride));
@@ -259,7 +260,7 @@ void ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
 	const u8* pPixels = m_bufferReader->readPixels(x0, y0, width, height, m_pCurFrameBuffer->m_size, _sync);
 	frameBufferList().setCurrentDrawBuffer();
 	if (pPixels == nullptr)
-		return;
+		return false;
 
 	if (m_pCurFrameBuffer->m_size == G_IM_SIZ_32b) {
 		u32 *ptr_src = (u32*)pPixels;
@@ -284,6 +285,33 @@ void ColorBufferToRDRAM::_copy(u32 _startAddress, u32 _endAddress, bool _sync)
 	m_bufferReader->cleanUp();
 
 	gDP.changed |= CHANGED_SCISSOR;
+	return true;
+}
+
+bool ColorBufferToRDRAM::_getDirtyRows(u32 & _y0, u32 & _y1) const
+{
+	const FrameBuffer * pBuffer = m_pCurFrameBuffer;
+	const u32 stride = pBuffer->m_width << pBuffer->m_size >> 1;
+	const u32 height = cutHeight(pBuffer->m_startAddress, pBuffer->m_height, stride);
+	if (height == 0 || pBuffer->m_RdramCopy.size() != height * stride)
+		return false;
+
+	u32 y0 = 0, y1 = 0;
+	if (pBuffer->isDirty()) {
+		y0 = std::min(pBuffer->m_dirty.uly, height);
+		y1 = std::min(pBuffer->m_dirty.lry, height);
+	}
+
+	// Clean rows can be skipped only if RDRAM still holds what the last copy wrote there.
+	const u8 * pRdram = RDRAM + pBuffer->m_startAddress;
+	const u8 * pCopy = pBuffer->m_RdramCopy.data();
+	if (memcmp(pRdram, pCopy, y0 * stride) != 0 ||
+		memcmp(pRdram + y1 * stride, pCopy + y1 * stride, (height - y1) * stride) != 0)
+		return false;
+
+	_y0 = y0;
+	_y1 = y1;
+	return true;
 }
 
 u32 ColorBufferToRDRAM::_getRealWidth(u32 _viWidth)
@@ -301,8 +329,19 @@ void ColorBufferToRDRAM::copyToRDRAM(u32 _address, bool _sync)
 {
 	if (!_prepareCopy(_address))
 		return;
-	const u32 numBytes = (m_pCurFrameBuffer->m_width*m_pCurFrameBuffer->m_height) << m_pCurFrameBuffer->m_size >> 1;
-	_copy(m_pCurFrameBuffer->m_startAddress, m_pCurFrameBuffer->m_startAddress + numBytes, _sync);
+	const u32 stride = m_pCurFrameBuffer->m_width << m_pCurFrameBuffer->m_size >> 1;
+	u32 y0 = 0;
+	u32 y1 = m_pCurFrameBuffer->m_height;
+	// Async read returns pixels of the previous request, so it always reads the whole buffer.
+	if (_sync && _getDirtyRows(y0, y1) && y0 == y1) {
+		// Nothing was drawn since the last copy.
+		frameBufferList().setCurrentDrawBuffer();
+		m_pCurFrameBuffer->m_copiedToRdram = true;
+		gDP.changed |= CHANGED_SCISSOR;
+		return;
+	}
+	if (_copy(m_pCurFrameBuffer->m_startAddress + y0 * stride, m_pCurFrameBuffer->m_startAddress + y1 * stride, _sync) && _sync)
+		m_pCurFrameBuffer->clearDirty();
 }
 
 void ColorBufferToRDRAM::copyChunkToRDRAM(u32 _address)
@@ -44,7 +44,9 @@ private:
 
 	bool _prepareCopy(u32 _startAddress);
 
-	void _copy(u32 _startAddress, u32 _endAddress, bool _sync);
+	bool _copy(u32 _startAddress, u32 _endAddress, bool _sync);
+
+	bool _getDirtyRows(u32 & _y0, u32 & _y1) const;
 
 	u32 _getRealWidth(u32 _viWidth);
 
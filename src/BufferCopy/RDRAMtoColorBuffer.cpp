@@ -185,17 +185,26 @@ void RDRAMtoColorBuffer::copyFromRDRAM(u32 _address, bool _bCFB)
 	if (m_pCurBuffer->m_startAddress == _address && gDP.colorImage.changed != 0)
 		return;
 
-	const u32 address = m_pCurBuffer->m_startAddress;
-
-	const u32 height = cutHeight(address, m_pCurBuffer->m_startAddress == _address ? VI.real_height : VI_GetMaxBufferHeight(m_pCurBuffer->m_width), m_pCurBuffer->m_width << m_pCurBuffer->m_size >> 1);
-	if (height == 0)
+	const u32 stride = m_pCurBuffer->m_width << m_pCurBuffer->m_size >> 1;
+	const u32 bufferHeight = cutHeight(m_pCurBuffer->m_startAddress, m_pCurBuffer->m_startAddress == _address ? VI.real_height : VI_GetMaxBufferHeight(m_pCurBuffer->m_width), stride);
+	if (bufferHeight == 0)
 		return;
 
 	const u32 width = m_pCurBuffer->m_width;
 
 	const u32 x0 = 0;
-	const u32 y0 = 0;
-	const u32 y1 = y0 + height;
+	u32 y0 = 0;
+	u32 y1 = bufferHeight;
+	if (!m_vecAddress.empty()) {
+		// Upload only the rows written by FBWrite.
+		const auto range = std::minmax_element(m_vecAddress.begin(), m_vecAddress.end());
+		if (*range.first >= m_pCurBuffer->m_startAddress) {
+			y0 = std::min((*range.first - m_pCurBuffer->m_startAddress) / stride, bufferHeight - 1);
+			y1 = std::min((*range.second - m_pCurBuffer->m_startAddress) / stride + 1, bufferHeight);
+		}
+	}
+	const u32 address = m_pCurBuffer->m_startAddress + y0 * stride;
+	const u32 height = y1 - y0;
 
 	const bool bUseAlpha = !_bCFB && m_pCurBuffer->m_changed;
 
@@ -251,10 +260,10 @@ void RDRAMtoColorBuffer::copyFromRDRAM(u32 _address, bool _bCFB)
 	}
 
 	if (bUseAlpha) {
-		u32 totalBytes = (width * height) << m_pCurBuffer->m_size >> 1;
-		if (address + totalBytes > RDRAMSize + 1)
-			totalBytes = RDRAMSize + 1 - address;
-		memset(RDRAM + address, 0, totalBytes);
+		u32 totalBytes = bufferHeight * stride;
+		if (m_pCurBuffer->m_startAddress + totalBytes > RDRAMSize + 1)
+			totalBytes = RDRAMSize + 1 - m_pCurBuffer->m_startAddress;
+		memset(RDRAM + m_pCurBuffer->m_startAddress, 0, totalBytes);
 	}
 
 	m_pbuf->closeWriteBuffer();
@@ -299,7 +308,7 @@ void RDRAMtoColorBuffer::copyFromRDRAM(u32 _address, bool _bCFB)
 
 	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, m_pCurBuffer->m_FBO);
 
-	GraphicsDrawer::TexturedRectParams texRectParams((float)x0, (float)y0, (float)width, (float)height,
+	GraphicsDrawer::TexturedRectParams texRectParams((float)x0, (float)y0, (float)width, (float)y1,
 										 0.0f, 0.0f, width - 1.0f, height - 1.0f, 1.0f, 1.0f,
 										 false, true, false, m_pCurBuffer);
 	dwnd().getDrawer().drawTexturedRect(texRectParams);
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <string.h>
+#include "CRC.h"
+#include "CRC32.h"
+
+typedef u32(*CRCFunc)(u32 crc, const void *buffer, u32 count);
+
+// Texture and vertex hashes are only compared within one run and against
+// the texture cache file, which records CRC_HashId. Any good hash will do.
+static CRCFunc s_calculate = XXH_Calculate;
+static u32 s_hashId = 0;
+
+// Lane layouts differ between the backends, so each variant has its own id.
+enum HashId {
+	hashXXH64 = 1,
+	hashXXH32,
+	hashCRC32C_SSE42_64,
+	hashCRC32C_SSE42_32,
+	hashCRC32C_ARMV8
+};
+
+void CRC_Init()
+{
+	CRC32_Init();
+
+	s_calculate = XXH_Calculate;
+#if defined(__x86_64__) || defined(_M_X64)
+	s_hashId = hashXXH64;
+#else
+	s_hashId = hashXXH32;
+#endif
+#if defined(CRC32_ARMV8)
+	s_calculate = CRC32C_ARMV8_Calculate;
+	s_hashId = hashCRC32C_ARMV8;
+#elif defined(CRC32_SSE42)
+	if (CRC32C_SSE42_Supported()) {
+		s_calculate = CRC32C_SSE42_Calculate;
+#if defined(__x86_64__) || defined(_M_X64)
+		s_hashId = hashCRC32C_SSE42_64;
+#else
+		s_hashId = hashCRC32C_SSE42_32;
+#endif
+	}
+#endif
+}
+
+u32 CRC_HashId()
+{
+	return s_hashId;
+}
+
+u32 CRC_Calculate_Strict( u32 crc, const void * buffer, u32 count )
+{
+#ifdef CRC32_ARMV8
+	return CRC32_ARMV8_Calculate(crc, buffer, count);
+#else
+	return CRC32_Calculate(crc, buffer, count);
+#endif
+}
+
+u32 CRC_Calculate( u32 crc, const void * buffer, u32 count )
+{
+	return s_calculate(crc, buffer, count);
+}
+
+u32 CRC_CalculatePalette( u32 crc, const void * buffer, u32 count )
+{
+	// Palette entries are quadrupled in TMEM. Gather one copy of each entry
+	// and hash them in one call.
+	const u8 *p = (const u8*) buffer;
+	u16 entries[64];
+	while (count > 0) {
+		const u32 batch = std::min(count, 64U);
+		for (u32 i = 0; i < batch; ++i)
+			memcpy(&entries[i], p + i * 8, 2);
+		crc = s_calculate(crc, entries, batch * 2);
+		p += batch * 8;
+		count -= batch;
+	}
+	return crc;
+}
@@ -1,6 +1,8 @@
 #include "Types.h"
 
 void CRC_Init();
+// Identifies the hash behind CRC_Calculate. Texture checksums saved to disk are only valid for the same id.
+u32 CRC_HashId();
 
 u32 CRC_Calculate_Strict( u32 crc, const void *buffer, u32 count );
 u32 CRC_Calculate( u32 crc, const void *buffer, u32 count );
@@ -1,8 +1,8 @@
-#include "CRC.h"
+#include "CRC32.h"
 
 #define CRC32_POLYNOMIAL     0x04C11DB7
 
-unsigned int CRCTable[ 256 ];
+static unsigned int CRCTable[ 256 ];
 
 static
 u32 Reflect( u32 ref, char ch )
@@ -19,7 +19,7 @@ u32 Reflect( u32 ref, char ch )
 	 return value;
 }
 
-void CRC_Init()
+void CRC32_Init()
 {
 	u32 crc;
 
@@ -32,7 +32,7 @@ void CRC_Init()
 	}
 }
 
-u32 CRC_Calculate( u32 crc, const void * buffer, u32 count )
+u32 CRC32_Calculate( u32 crc, const void * buffer, u32 count )
 {
 	u8 *p;
 	u32 orig = crc;
@@ -43,24 +43,3 @@ u32 CRC_Calculate( u32 crc, const void * buffer, u32 count )
 
 	return crc ^ orig;
 }
-
-u32 CRC_Calculate_Strict( u32 crc, const void * buffer, u32 count )
-{
-	return CRC_Calculate(crc, buffer, count);
-}
-
-u32 CRC_CalculatePalette(u32 crc, const void * buffer, u32 count )
-{
-	u8 *p;
-	u32 orig = crc;
-
-	p = (u8*) buffer;
-	while (count--) {
-		crc = (crc >> 8) ^ CRCTable[(crc & 0xFF) ^ *p++];
-		crc = (crc >> 8) ^ CRCTable[(crc & 0xFF) ^ *p++];
-
-		p += 6;
-	}
-
-	return crc ^ orig;
-}
@@ -0,0 +1,30 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include "Types.h"
+
+// Hash functions behind CRC_Calculate. CRC_Init picks the fastest one the CPU supports.
+
+// Table driven CRC-32. Microcode identification depends on its exact values.
+void CRC32_Init();
+u32 CRC32_Calculate(u32 crc, const void *buffer, u32 count);
+
+// xxHash. Available everywhere.
+u32 XXH_Calculate(u32 crc, const void *buffer, u32 count);
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRC32_SSE42
+// CRC-32C with the SSE4.2 crc32 instruction, checked at runtime.
+bool CRC32C_SSE42_Supported();
+u32 CRC32C_SSE42_Calculate(u32 crc, const void *buffer, u32 count);
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#define CRC32_ARMV8
+// ARMv8 CRC instructions. Requires a compiler targeting armv8-a+crc.
+// CRC32_ARMV8_Calculate gives the same values as CRC32_Calculate.
+u32 CRC32_ARMV8_Calculate(u32 crc, const void *buffer, u32 count);
+u32 CRC32C_ARMV8_Calculate(u32 crc, const void *buffer, u32 count);
+#endif
+
+#endif // CRC32_H
@@ -1,11 +1,10 @@
-#include "CRC.h"
-#include <arm_acle.h>
+#include "CRC32.h"
 
-void CRC_Init()
-{
-}
+#ifdef CRC32_ARMV8
+#include <arm_acle.h>
+#include <string.h>
 
-u32 CRC_Calculate( u32 crc, const void * buffer, u32 count )
+u32 CRC32_ARMV8_Calculate( u32 crc, const void * buffer, u32 count )
 {
 	u8 *p;
 	u32 orig = crc;
@@ -35,22 +34,49 @@ u32 CRC_Calculate( u32 crc, const void * buffer, u32 count )
 	return crc ^ orig;
 }
 
-u32 CRC_Calculate_Strict( u32 crc, const void * buffer, u32 count )
+u32 CRC32C_ARMV8_Calculate( u32 crc, const void * buffer, u32 count )
 {
-	return CRC_Calculate(crc, buffer, count);
-}
+	const u8 *p = (const u8*) buffer;
+	u64 data[3];
 
-u32 CRC_CalculatePalette(u32 crc, const void * buffer, u32 count )
-{
-	u8 *p;
-	u32 orig = crc;
+	// Three independent lanes hide the latency of the crc instruction.
+	if (count >= 24) {
+		u32 crc1 = 0, crc2 = 0;
+		do {
+			memcpy(data, p, 24);
+			crc = __crc32cd(crc, data[0]);
+			crc1 = __crc32cd(crc1, data[1]);
+			crc2 = __crc32cd(crc2, data[2]);
+			p += 24;
+			count -= 24;
+		} while (count >= 24);
+		crc = __crc32cd(crc, crc1 | ((u64)crc2 << 32));
+	}
 
-	p = (u8*) buffer;
-	while (count--) {
-		// use two byte intrinsic __crc32h
-		crc = __crc32h(crc, *((u16*)p));
+	while (count >= 8) {
+		memcpy(data, p, 8);
+		crc = __crc32cd(crc, data[0]);
 		p += 8;
+		count -= 8;
+	}
+	if (count >= 4) {
+		u32 word;
+		memcpy(&word, p, 4);
+		crc = __crc32cw(crc, word);
+		p += 4;
+		count -= 4;
+	}
+	if (count >= 2) {
+		u16 half;
+		memcpy(&half, p, 2);
+		crc = __crc32ch(crc, half);
+		p += 2;
+		count -= 2;
 	}
+	if (count == 1)
+		crc = __crc32cb(crc, *p);
 
-	return crc ^ orig;
+	return crc;
 }
+
+#endif // CRC32_ARMV8
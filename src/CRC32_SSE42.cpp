@@ -0,0 +1,94 @@
+#include "CRC32.h"
+
+#ifdef CRC32_SSE42
+#include <string.h>
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SSE42_TARGET
+#else
+#define SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+
+bool CRC32C_SSE42_Supported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+
+SSE42_TARGET
+u32 CRC32C_SSE42_Calculate( u32 crc, const void * buffer, u32 count )
+{
+	const u8 *p = (const u8*) buffer;
+
+#if defined(__x86_64__) || defined(_M_X64)
+	u64 data[3];
+
+	// Three independent lanes hide the latency of the crc32 instruction.
+	if (count >= 24) {
+		u64 crc0 = crc, crc1 = 0, crc2 = 0;
+		do {
+			memcpy(data, p, 24);
+			crc0 = _mm_crc32_u64(crc0, data[0]);
+			crc1 = _mm_crc32_u64(crc1, data[1]);
+			crc2 = _mm_crc32_u64(crc2, data[2]);
+			p += 24;
+			count -= 24;
+		} while (count >= 24);
+		crc = (u32)_mm_crc32_u64(crc0, crc1 | (crc2 << 32));
+	}
+
+	if (count >= 8) {
+		u64 crc0 = crc;
+		do {
+			memcpy(data, p, 8);
+			crc0 = _mm_crc32_u64(crc0, data[0]);
+			p += 8;
+			count -= 8;
+		} while (count >= 8);
+		crc = (u32)crc0;
+	}
+#else
+	u32 data[3];
+
+	if (count >= 12) {
+		u32 crc1 = 0, crc2 = 0;
+		do {
+			memcpy(data, p, 12);
+			crc = _mm_crc32_u32(crc, data[0]);
+			crc1 = _mm_crc32_u32(crc1, data[1]);
+			crc2 = _mm_crc32_u32(crc2, data[2]);
+			p += 12;
+			count -= 12;
+		} while (count >= 12);
+		crc = _mm_crc32_u32(_mm_crc32_u32(crc, crc1), crc2);
+	}
+#endif
+
+	while (count >= 4) {
+		u32 word;
+		memcpy(&word, p, 4);
+		crc = _mm_crc32_u32(crc, word);
+		p += 4;
+		count -= 4;
+	}
+	if (count >= 2) {
+		u16 half;
+		memcpy(&half, p, 2);
+		crc = _mm_crc32_u16(crc, half);
+		p += 2;
+		count -= 2;
+	}
+	if (count == 1)
+		crc = _mm_crc32_u8(crc, *p);
+
+	return crc;
+}
+
+#endif // CRC32_SSE42
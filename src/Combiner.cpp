@@ -94,13 +94,8 @@ void CombinerInfo::init()
 {
 	m_pCurrent = nullptr;
 	m_bShaderCacheSupported = config.generalEmulation.enableShadersStorage != 0 && gfxContext.isSupported(SpecialFeatures::ShaderProgramBinary);
-
-	m_shadersLoaded = 0;
-	if (m_bShaderCacheSupported && !_loadShadersStorage()) {
-		for (auto cur = m_combiners.begin(); cur != m_combiners.end(); ++cur)
-			delete cur->second;
-		m_combiners.clear();
-	}
+	if (m_bShaderCacheSupported)
+		m_bShaderCacheSupported = gfxContext.openShadersStorage();
 
 	if (m_combiners.empty()) {
 		setPolygonMode(DrawingState::TexRect);
@@ -123,8 +118,7 @@ void CombinerInfo::destroy()
 
 	m_pCurrent = nullptr;
 	if (m_bShaderCacheSupported)
-		_saveShadersStorage();
-	m_shadersLoaded = 0;
+		gfxContext.closeShadersStorage();
 	for (auto cur = m_combiners.begin(); cur != m_combiners.end(); ++cur)
 		delete cur->second;
 	m_combiners.clear();
@@ -297,7 +291,12 @@ void CombinerInfo::setCombine(u64 _mux )
 	if (iter != m_combiners.end()) {
 		m_pCurrent = iter->second;
 	} else {
-		m_pCurrent = _compile(_mux);
+		m_pCurrent = m_bShaderCacheSupported ? gfxContext.loadShaderProgram(key) : nullptr;
+		if (m_pCurrent == nullptr) {
+			m_pCurrent = _compile(_mux);
+			if (m_bShaderCacheSupported)
+				gfxContext.storeShaderProgram(m_pCurrent);
+		}
 		m_pCurrent->update(true);
 		m_combiners[m_pCurrent->getKey()] = m_pCurrent;
 	}
@@ -342,21 +341,3 @@ void CombinerInfo::setPolygonMode(DrawingState _drawingState)
 		break;
 	}
 }
-
-void CombinerInfo::_saveShadersStorage() const
-{
-	if (m_shadersLoaded >= m_combiners.size())
-		return;
-
-	gfxContext.saveShadersStorage(m_combiners);
-}
-
-bool CombinerInfo::_loadShadersStorage()
-{
-	if (gfxContext.loadShadersStorage(m_combiners)) {
-		m_shadersLoaded = m_combiners.size();
-		return true;
-	}
-
-	return false;
-}
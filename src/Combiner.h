@@ -144,20 +144,16 @@ private:
 		: m_bChanged(false)
 		, m_bShaderCacheSupported(false)
 		, m_rectMode(true)
-		, m_shadersLoaded(0)
 		, m_configOptionsBitSet(0)
 		, m_pCurrent(nullptr) {}
 	CombinerInfo(const CombinerInfo &);
 
-	void _saveShadersStorage() const;
-	bool _loadShadersStorage();
 	u32 _getConfigOptionsBitSet() const;
 	graphics::CombinerProgram * _compile(u64 mux) const;
 
 	bool m_bChanged;
 	bool m_bShaderCacheSupported;
 	bool m_rectMode;
-	u32 m_shadersLoaded;
 	u32 m_configOptionsBitSet;
 
 	graphics::CombinerProgram * m_pCurrent;
@@ -29,11 +29,16 @@ void Config::resetToDefaults()
 	texture.maxAnisotropy = 0;
 	texture.bilinearMode = BILINEAR_STANDARD;
 	texture.maxBytes = 500 * gc_uMegabyte;
+	texture.cachePolicy = tcpLRU;
+	texture.enableTextureArray = 0;
 	texture.screenShotFormat = 0;
 
 	generalEmulation.enableLOD = 1;
 	generalEmulation.enableNoise = 1;
 	generalEmulation.enableHWLighting = 0;
+	generalEmulation.enableShaderLighting = 0;
+	generalEmulation.enableVertexCache = 1;
+	generalEmulation.enableDrawBatching = 1;
 	generalEmulation.enableCustomSettings = 1;
 	generalEmulation.enableShadersStorage = 1;
 	generalEmulation.correctTexrectCoords = tcDisable;
@@ -77,9 +82,12 @@ void Config::resetToDefaults()
 	textureFilter.txHiresFullAlphaChannel = 0;
 	textureFilter.txHresAltCRC = 0;
 	textureFilter.txDump = 0;
+	textureFilter.txHiresStream = 0;
+	textureFilter.txHiresCacheSize = 512 * gc_uMegabyte;
 
 	textureFilter.txForce16bpp = 0;
 	textureFilter.txCacheCompression = 1;
+	textureFilter.txBlockCompression = 0;
 	textureFilter.txSaveCache = 1;
 
 	api().GetUserDataPath(textureFilter.txPath);
@@ -114,7 +122,10 @@ void Config::resetToDefaults()
 	onScreenDisplay.vis = 0;
 	onScreenDisplay.fps = 0;
 	onScreenDisplay.percent = 0;
+	onScreenDisplay.gpuTime = 0;
+	onScreenDisplay.statistics = 0;
 	onScreenDisplay.pos = posBottomLeft;
 
 	debug.dumpMode = 0;
+	debug.frameCapture = fcDisable;
 }
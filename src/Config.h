@@ -4,7 +4,7 @@
 #include <string>
 #include "Types.h"
 
-#define CONFIG_VERSION_CURRENT 17U
+#define CONFIG_VERSION_CURRENT 28U
 
 #define BILINEAR_3POINT   0
 #define BILINEAR_STANDARD 1
@@ -35,12 +35,19 @@ struct Config
 		u32 cropHeight;
 	} video;
 
+	enum TextureCachePolicy {
+		tcpLRU = 0,
+		tcp2Q
+	};
+
 	struct
 	{
 		u32 maxAnisotropy;
 		f32 maxAnisotropyF;
 		u32 bilinearMode;
 		u32 maxBytes;
+		u32 cachePolicy;
+		u32 enableTextureArray;
 		u32 screenShotFormat;
 	} texture;
 
@@ -54,6 +61,9 @@ struct Config
 		u32 enableNoise;
 		u32 enableLOD;
 		u32 enableHWLighting;
+		u32 enableShaderLighting;
+		u32 enableVertexCache;
+		u32 enableDrawBatching;
 		u32 enableCustomSettings;
 		u32 enableShadersStorage;
 		u32 correctTexrectCoords;
@@ -126,9 +136,12 @@ struct Config
 		u32 txHiresFullAlphaChannel;	// Use alpha channel fully
 		u32 txHresAltCRC;				// Use alternative method of paletted textures CRC calculation
 		u32 txDump;						// Dump textures
+		u32 txHiresStream;				// Load hi-res textures on first use instead of at startup
+		u32 txHiresCacheSize;			// Memory budget of streamed hi-res textures in Mbytes
 
 		u32 txForce16bpp;				// Force use 16bit color textures
 		u32 txCacheCompression;			// Zip textures cache
+		u32 txBlockCompression;			// Store textures in GPU block compressed format
 		u32 txSaveCache;				// Save texture cache to hard disk
 
 		wchar_t txPath[PLUGIN_PATH_SIZE];
@@ -170,11 +183,21 @@ struct Config
 		u32 vis;
 		u32 fps;
 		u32 percent;
+		u32 gpuTime;
+		u32 statistics;
 		u32 pos;
 	} onScreenDisplay;
 
+	enum FrameCaptureMode {
+		fcDisable = 0,
+		fcRawRGB,
+		fcY4M,
+		fcCompareY4M
+	};
+
 	struct {
 		u32 dumpMode;
+		u32 frameCapture;
 	} debug;
 
 	void resetToDefaults();
@@ -511,6 +511,9 @@ void Debugger::_drawTextureCache()
 	auto infoIter = texInfos.begin();
 	std::advance(infoIter, m_startTexRow[m_tmu] * m_cacheViewerCols);
 
+	for (u32 i = 0; i < 4; ++i)
+		rect[i].texArray = TexArrayAttribs::none;
+
 	for (u32 r = 0; r < m_cacheViewerRows; ++r) {
 
 		for (u32 c = 0; c < m_cacheViewerCols; ++c) {
@@ -1059,6 +1062,9 @@ void Debugger::_drawTexture(f32 _ulx, f32 _uly, f32 _lrx, f32 _lry, f32 _yShift)
 	rect[3].s0 = s1;
 	rect[3].t0 = t1;
 
+	for (u32 i = 0; i < 4; ++i)
+		rect[i].texArray = TexArrayAttribs::none;
+
 	_setTextureCombiner();
 	Context::TexParameters texParams;
 	texParams.handle = m_pCurTexInfo->texture->name;
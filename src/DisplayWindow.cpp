@@ -1,7 +1,12 @@
 #include <assert.h>
 #include <cstdlib>
+#include <string>
 #include "Config.h"
 #include "VI.h"
+#include "RSP.h"
+#include "FrameCapture.h"
+#include "VertexBatchCache.h"
+#include "Textures.h"
 #include "Graphics/Context.h"
 #include "DisplayWindow.h"
 
@@ -10,11 +15,13 @@ void DisplayWindow::start()
 	_start(); // TODO: process initialization error
 	gfxContext.init();
 	m_drawer._initData();
+	FrameCapture::get().init();
 	m_buffersSwapCount = 0;
 }
 
 void DisplayWindow::stop()
 {
+	FrameCapture::get().destroy();
 	m_drawer._destroyData();
 	gfxContext.destroy();
 	_stop();
@@ -27,7 +34,13 @@ void DisplayWindow::restart()
 
 void DisplayWindow::swapBuffers()
 {
+	FrameCapture::get().captureFrame();
 	m_drawer.drawOSD();
+	gfxContext.resolveGPUTimers();
+	gfxContext.frameEnd();
+	VertexBatchCache::get().frameEnd();
+	textureCache().frameEnd();
+	RSP_FrameEnd();
 	_swapBuffers();
 	gDP.otherMode.l = 0;
 	if ((config.generalEmulation.hacks & hack_doNotResetTLUTmode) == 0)
@@ -45,7 +58,11 @@ void DisplayWindow::saveScreenshot()
 {
 	if (!m_bCaptureScreen)
 		return;
-	_saveScreenshot();
+	const std::wstring folder(m_strScreenDirectory);
+	const std::string name(RSP.romname);
+	FrameCapture::get().requestScreenshot([this, folder, name](u32 _width, u32 _height, const u8 * _data) {
+		_saveScreenshot(folder.c_str(), name.c_str(), _width, _height, _data);
+	});
 	m_bCaptureScreen = false;
 }
 
@@ -69,7 +69,8 @@ private:
 	virtual bool _start() = 0;
 	virtual void _stop() = 0;
 	virtual void _swapBuffers() = 0;
-	virtual void _saveScreenshot() = 0;
+	// Runs on the frame capture thread. _data is bottom-up RGB.
+	virtual void _saveScreenshot(const wchar_t * _folder, const char * _name, u32 _width, u32 _height, const u8 * _data) = 0;
 	virtual void _changeWindow() = 0;
 	virtual bool _resizeWindow() = 0;
 	virtual void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) = 0;
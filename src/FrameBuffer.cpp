@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 #include <algorithm>
 #include <vector>
 #include "FrameBuffer.h"
@@ -40,6 +41,7 @@ FrameBuffer::FrameBuffer() :
 	m_pSubTexture(nullptr)
 {
 	m_loadTileOrigin.uls = m_loadTileOrigin.ult = 0;
+	clearDirty();
 	m_pTexture = textureCache().addFrameBufferTexture(config.video.multisampling != 0);
 	m_FBO = gfxContext.createFramebuffer();
 }
@@ -159,6 +161,7 @@ void FrameBuffer::init(u32 _address, u16 _format, u16 _size, u16 _width, bool _c
 	m_cfb = _cfb;
 	m_cleared = false;
 	m_fingerprint = false;
+	setDirty();
 
 	const u16 maxHeight = VI_GetMaxBufferHeight(_width);
 	_initTexture(_width, maxHeight, _format, _size, m_pTexture);
@@ -235,6 +238,39 @@ void FrameBuffer::copyRdram()
 	}
 	m_RdramCopy.resize(dataSize);
 	memcpy(m_RdramCopy.data(), RDRAM + m_startAddress, dataSize);
+	// Rows outside of the dirty region are checked against this copy before they are skipped.
+	// The buffer may differ from it anywhere until a copy to RDRAM resets the region.
+	setDirty();
+}
+
+void FrameBuffer::setDirty(u32 _ulx, u32 _uly, u32 _lrx, u32 _lry)
+{
+	if (_lrx <= _ulx || _lry <= _uly)
+		return;
+	if (!isDirty()) {
+		m_dirty.ulx = _ulx;
+		m_dirty.uly = _uly;
+		m_dirty.lrx = _lrx;
+		m_dirty.lry = _lry;
+		return;
+	}
+	m_dirty.ulx = min(m_dirty.ulx, _ulx);
+	m_dirty.uly = min(m_dirty.uly, _uly);
+	m_dirty.lrx = max(m_dirty.lrx, _lrx);
+	m_dirty.lry = max(m_dirty.lry, _lry);
+}
+
+void FrameBuffer::setDirty()
+{
+	m_dirty.ulx = 0;
+	m_dirty.uly = 0;
+	m_dirty.lrx = max(1U, m_width);
+	m_dirty.lry = VI_GetMaxBufferHeight(m_width);
+}
+
+void FrameBuffer::clearDirty()
+{
+	m_dirty.ulx = m_dirty.uly = m_dirty.lrx = m_dirty.lry = 0;
 }
 
 bool FrameBuffer::isValid(bool _forceCheck) const
@@ -257,15 +293,20 @@ bool FrameBuffer::isValid(bool _forceCheck) const
 		const u32 ci_width_in_dwords = m_width >> (3 - m_size);
 		const u32 start = (m_startAddress >> 2) + m_clearParams.uly * ci_width_in_dwords;
 		const u32 * dst = pData + start;
+		const u32 maxWrongPixels = (m_endAddress - m_startAddress) / 400; // threshold level 1% of dwords
+		if (maxWrongPixels == 0)
+			return false;
 		u32 wrongPixels = 0;
 		for (u32 y = m_clearParams.uly; y < lry; ++y) {
 			for (u32 x = m_clearParams.ulx; x < m_clearParams.lrx; ++x) {
 				if ((dst[x] & 0xFFFEFFFE) != testColor)
 					++wrongPixels;
 			}
+			if (wrongPixels >= maxWrongPixels)
+				return false;
 			dst += ci_width_in_dwords;
 		}
-		return wrongPixels < (m_endAddress - m_startAddress) / 400; // threshold level 1% of dwords
+		return true;
 	} else if (m_fingerprint) {
 			//check if our fingerprint is still there
 			u32 start = m_startAddress >> 2;
@@ -277,13 +318,18 @@ bool FrameBuffer::isValid(bool _forceCheck) const
 		const u32 * const pCopy = (const u32*)m_RdramCopy.data();
 		const u32 size = m_RdramCopy.size();
 		const u32 size_dwords = size >> 2;
-		u32 start = m_startAddress >> 2;
+		const u32 maxWrongPixels = size / 400; // threshold level 1% of dwords
+		if (maxWrongPixels == 0)
+			return false;
+		const u32 * pRdram = pData + (m_startAddress >> 2);
+		if (memcmp(pRdram, pCopy, size_dwords << 2) == 0)
+			return true;
 		u32 wrongPixels = 0;
 		for (u32 i = 0; i < size_dwords; ++i) {
-			if ((pData[start++] & 0xFFFEFFFE) != (pCopy[i] & 0xFFFEFFFE))
-				++wrongPixels;
+			if ((pRdram[i] & 0xFFFEFFFE) != (pCopy[i] & 0xFFFEFFFE) && ++wrongPixels >= maxWrongPixels)
+				return false;
 		}
-		return wrongPixels < size / 400; // threshold level 1% of dwords
+		return true;
 	}
 	return true; // No data to decide
 }
@@ -473,16 +519,22 @@ void FrameBufferList::destroy() {
 	gfxContext.bindFramebuffer(bufferTarget::DRAW_FRAMEBUFFER, ObjectHandle::null);
 }
 
-void FrameBufferList::setBufferChanged(f32 _maxY)
+void FrameBufferList::setBufferChanged(f32 _ulx, f32 _uly, f32 _lrx, f32 _lry)
 {
 	gDP.colorImage.changed = TRUE;
-	gDP.colorImage.height = max(gDP.colorImage.height, (u32)_maxY);
+	gDP.colorImage.height = max(gDP.colorImage.height, (u32)max(0.0f, _lry));
 	gDP.colorImage.height = min(gDP.colorImage.height, (u32)gDP.scissor.lry);
 	if (m_pCurrent != nullptr) {
 		m_pCurrent->m_height = max(m_pCurrent->m_height, gDP.colorImage.height);
 		m_pCurrent->m_cfb = false;
 		m_pCurrent->m_changed = true;
 		m_pCurrent->m_copiedToRdram = false;
+		const f32 ulx = max(_ulx, gDP.scissor.ulx);
+		const f32 uly = max(_uly, gDP.scissor.uly);
+		const f32 lrx = min(_lrx, gDP.scissor.lrx);
+		const f32 lry = min(_lry, gDP.scissor.lry);
+		if (lrx > ulx && lry > uly)
+			m_pCurrent->setDirty((u32)ulx, (u32)uly, (u32)ceilf(lrx), (u32)ceilf(lry));
 	}
 }
 
@@ -607,6 +659,7 @@ void FrameBufferList::saveBuffer(u32 _address, u16 _format, u16 _size, u16 _widt
 				f32 fillColor[4];
 				gDPGetFillColor(fillColor);
 				wnd.getDrawer().clearColorBuffer(fillColor);
+				m_pCurrent->setDirty();
 				m_pCurrent->m_size = _size;
 				m_pCurrent->m_pTexture->format = _format;
 				m_pCurrent->m_pTexture->size = _size;
@@ -798,8 +851,7 @@ void FrameBufferList::_renderScreenSizeBuffer()
 	GraphicsDrawer & drawer = wnd.getDrawer();
 	FrameBuffer *pBuffer = &m_list.back();
 	PostProcessor & postProcessor = PostProcessor::get();
-	FrameBuffer * pFilteredBuffer = postProcessor.doBlur(postProcessor.doGammaCorrection(
-		postProcessor.doOrientationCorrection(pBuffer)));
+	FrameBuffer * pFilteredBuffer = postProcessor.doPostProcessing(pBuffer);
 	CachedTexture * pBufferTexture = pFilteredBuffer->m_pTexture;
 
 
@@ -1057,8 +1109,7 @@ void FrameBufferList::renderBuffer()
 		srcY1 = srcY0 + srcHeight;
 	}
 	PostProcessor & postProcessor = PostProcessor::get();
-	FrameBuffer * pFilteredBuffer = postProcessor.doBlur(postProcessor.doGammaCorrection(
-		postProcessor.doOrientationCorrection(pBuffer)));
+	FrameBuffer * pFilteredBuffer = postProcessor.doPostProcessing(pBuffer);
 
 	if (rdpRes.vi_fsaa && rdpRes.vi_divot)
 		Xdivot = 1;
@@ -1134,8 +1185,7 @@ void FrameBufferList::renderBuffer()
 
 	if (pNextBuffer != nullptr) {
 		pNextBuffer->m_isMainBuffer = true;
-		pFilteredBuffer = postProcessor.doBlur(postProcessor.doGammaCorrection(
-			postProcessor.doOrientationCorrection(pNextBuffer)));
+		pFilteredBuffer = postProcessor.doPostProcessing(pNextBuffer);
 		srcY1 = srcPartHeight;
 		dstY0 = dstY1;
 		dstY1 = dstY0 + dstPartHeight;
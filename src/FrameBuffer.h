@@ -25,6 +25,10 @@ struct FrameBuffer
 	void setBufferClearParams(u32 _fillcolor, s32 _ulx, s32 _uly, s32 _lrx, s32 _lry);
 	void copyRdram();
 	bool isValid(bool _forceCheck) const;
+	void setDirty(u32 _ulx, u32 _uly, u32 _lrx, u32 _lry);
+	void setDirty();
+	void clearDirty();
+	bool isDirty() const { return m_dirty.lrx > m_dirty.ulx && m_dirty.lry > m_dirty.uly; }
 	bool _isMarioTennisScoreboard() const;
 	bool isAuxiliary() const;
 
@@ -62,6 +66,11 @@ struct FrameBuffer
 
 	std::vector<u8> m_RdramCopy;
 
+	// Conservative bounds of everything drawn since the last copy to RDRAM
+	struct {
+		u32 ulx, uly, lrx, lry;
+	} m_dirty;
+
 private:
 	struct {
 		u32 fillcolor;
@@ -91,7 +100,7 @@ public:
 	FrameBuffer * findTmpBuffer(u32 _address);
 	FrameBuffer * getCurrent() const {return m_pCurrent;}
 	void renderBuffer();
-	void setBufferChanged(f32 _maxY);
+	void setBufferChanged(f32 _ulx, f32 _uly, f32 _lrx, f32 _lry);
 	void clearBuffersChanged();
 	void setCurrentDrawBuffer() const;
 	void fillRDRAM(s32 ulx, s32 uly, s32 lrx, s32 lry);
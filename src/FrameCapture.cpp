@@ -0,0 +1,389 @@
+#include <assert.h>
+#include <cwchar>
+#include <string>
+
+#include "FrameCapture.h"
+#include "FrameCompare.h"
+#include "Config.h"
+#include "DisplayWindow.h"
+#include "VI.h"
+#include "RSP.h"
+#include "Log.h"
+#include "PluginAPI.h"
+#include <osal_files.h>
+
+#include <Graphics/Context.h>
+#include <Graphics/Parameters.h>
+#include <Graphics/PixelBuffer.h>
+
+#define FRAME_CAPTURE_FOLDER_NAME L"capture"
+
+using namespace graphics;
+
+FrameCapture & FrameCapture::get()
+{
+	static FrameCapture frameCapture;
+	return frameCapture;
+}
+
+void FrameCapture::init()
+{
+	m_mode = config.debug.frameCapture;
+	m_supported = true;
+
+	if (m_mode != Config::fcDisable) {
+		wchar_t strDataPath[PLUGIN_PATH_SIZE];
+		api().GetUserDataPath(strDataPath);
+		wchar_t strCapturePath[PLUGIN_PATH_SIZE];
+		swprintf(strCapturePath, PLUGIN_PATH_SIZE, L"%ls/%ls", strDataPath, FRAME_CAPTURE_FOLDER_NAME);
+		if (!osal_path_existsW(strCapturePath) && osal_mkdirp(strCapturePath) != 0)
+			m_streamFolder = strDataPath;
+		else
+			m_streamFolder = strCapturePath;
+
+		wchar_t strRomName[sizeof(RSP.romname)];
+		::mbstowcs(strRomName, RSP.romname, sizeof(RSP.romname));
+		m_streamName = strRomName;
+		for (wchar_t & c : m_streamName) {
+			if (c == L' ' || c == L':' || c == L'/' || c == L'\\')
+				c = L'_';
+		}
+	}
+	m_streamFailed = false;
+	m_droppedFrames = 0;
+
+	m_stop = false;
+	m_encoder = std::thread(&FrameCapture::_encoderThread, this);
+}
+
+void FrameCapture::destroy()
+{
+	if (!m_encoder.joinable())
+		return;
+
+	_collect(m_pendingSlots);
+	for (Slot & slot : m_slots)
+		slot.buffer.reset();
+	if (m_droppedFrames != 0)
+		LOG(LOG_WARNING, "Frame capture dropped %u frames\n", m_droppedFrames);
+	m_droppedFrames = 0;
+	m_nextSlot = 0;
+	m_bufferWidth = m_bufferHeight = 0;
+	m_screenshot = nullptr;
+	m_lastCaptureTime = std::chrono::steady_clock::time_point();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_cv.notify_all();
+	m_encoder.join();
+}
+
+void FrameCapture::requestScreenshot(ScreenshotWriter _writer)
+{
+	m_screenshot = std::move(_writer);
+}
+
+void FrameCapture::captureFrame()
+{
+	if (!m_encoder.joinable())
+		return;
+
+	_collect(0);
+
+	const bool stream = m_mode != Config::fcDisable;
+	if (!stream && !m_screenshot)
+		return;
+
+	DisplayWindow & wnd = dwnd();
+	const u32 width = wnd.getScreenWidth();
+	const u32 height = wnd.getScreenHeight();
+	if (!m_supported || width == 0 || height == 0) {
+		m_screenshot = nullptr;
+		return;
+	}
+
+	if (width != m_bufferWidth || height != m_bufferHeight) {
+		_collect(m_pendingSlots);
+		for (Slot & slot : m_slots) {
+			slot.buffer.reset(gfxContext.createPixelReadBuffer(width * height * 4));
+			if (!slot.buffer) {
+				LOG(LOG_WARNING, "Frame capture is not supported by this context\n");
+				m_supported = false;
+				m_screenshot = nullptr;
+				return;
+			}
+		}
+		m_nextSlot = 0;
+		m_bufferWidth = width;
+		m_bufferHeight = height;
+	}
+
+	// All buffers in flight: the GPU is behind, wait for the oldest one.
+	if (m_pendingSlots == s_numSlots)
+		_collect(1);
+
+	Slot & slot = m_slots[m_nextSlot];
+	slot.frame.width = width;
+	slot.frame.height = height;
+	slot.frame.rate = VI.PAL ? 50 : 60;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (m_lastCaptureTime != std::chrono::steady_clock::time_point())
+		slot.frame.frameTime = std::chrono::duration<f32, std::milli>(now - m_lastCaptureTime).count();
+	m_lastCaptureTime = now;
+	GPUTimings timings;
+	if (gfxContext.getGPUTimings(timings))
+		slot.frame.gpuTime = timings.frameTime;
+	slot.frame.stream = stream;
+	slot.frame.screenshot = std::move(m_screenshot);
+	m_screenshot = nullptr;
+
+	gfxContext.bindFramebuffer(bufferTarget::READ_FRAMEBUFFER, ObjectHandle::null);
+	PixelBufferBinder<PixelReadBuffer> binder(slot.buffer.get());
+	slot.buffer->readPixels(0, wnd.getHeightOffset(), width, height, colorFormat::RGBA, datatype::UNSIGNED_BYTE);
+	slot.buffer->fence();
+
+	m_nextSlot = (m_nextSlot + 1) % s_numSlots;
+	++m_pendingSlots;
+}
+
+void FrameCapture::_collect(u32 _minCount)
+{
+	u32 count = 0;
+	while (m_pendingSlots != 0) {
+		Slot & slot = m_slots[(m_nextSlot + s_numSlots - m_pendingSlots) % s_numSlots];
+		if (count >= _minCount && !slot.buffer->isReady())
+			break;
+
+		Frame frame = std::move(slot.frame);
+		slot.frame = Frame();
+		--m_pendingSlots;
+		++count;
+
+		bool bDrop;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			// Stream encoding fell behind. Waiting for it would stall the render thread.
+			bDrop = !frame.screenshot && m_frames.size() >= s_maxQueuedFrames;
+		}
+
+		if (!bDrop) {
+			const u32 size = frame.width * frame.height * 4;
+			PixelBufferBinder<PixelReadBuffer> binder(slot.buffer.get());
+			const u8 * pData = reinterpret_cast<const u8*>(slot.buffer->getDataRange(0, size));
+			if (pData != nullptr) {
+				frame.data.assign(pData, pData + size);
+				slot.buffer->closeReadBuffer();
+			} else {
+				LOG(LOG_WARNING, "Frame capture: can't map the read back frame\n");
+				// The frame is gone. Take the screenshot from the next one.
+				if (frame.screenshot && !m_screenshot)
+					m_screenshot = std::move(frame.screenshot);
+				frame.screenshot = nullptr;
+				bDrop = true;
+			}
+		}
+
+		if (bDrop) {
+			// Queued without pixels, so the golden compare stays in step.
+			++m_droppedFrames;
+			if (!frame.stream)
+				continue;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_frames.push_back(std::move(frame));
+		}
+		m_cv.notify_all();
+	}
+}
+
+void FrameCapture::_encoderThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_cv.wait(lock, [this]() { return m_stop || !m_frames.empty(); });
+		if (m_frames.empty())
+			break;
+
+		Frame frame = std::move(m_frames.front());
+		m_frames.pop_front();
+		lock.unlock();
+
+		_encode(frame);
+
+		lock.lock();
+	}
+
+	m_stream.close();
+	m_streamWidth = m_streamHeight = 0;
+
+	if (m_report.is_open()) {
+		LOG(LOG_MINIMAL, "Frame compare: %u of %u frames differ from golden\n", m_failedFrames, m_comparedFrames);
+		m_report.close();
+	}
+	m_golden.close();
+	m_comparedFrames = m_failedFrames = 0;
+}
+
+void FrameCapture::_encode(Frame & _frame)
+{
+	if (_frame.screenshot) {
+		const u32 numPixels = _frame.width * _frame.height;
+		m_encodeBuffer.resize(numPixels * 3);
+		const u8 * src = _frame.data.data();
+		u8 * dst = m_encodeBuffer.data();
+		for (u32 i = 0; i < numPixels; ++i) {
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			src += 4;
+			dst += 3;
+		}
+		_frame.screenshot(_frame.width, _frame.height, m_encodeBuffer.data());
+	}
+
+	if (!_frame.stream || m_streamFailed)
+		return;
+
+	if (m_mode == Config::fcCompareY4M)
+		_compareFrame(_frame);
+	else if (!_frame.data.empty())
+		_writeStreamFrame(_frame);
+}
+
+template<class Stream>
+static
+bool _openFile(Stream & _stream, const wchar_t * _fileName, std::ios_base::openmode _mode)
+{
+#if defined(OS_WINDOWS) && !defined(MINGW)
+	_stream.open(_fileName, _mode);
+#else
+	char fileName_c[PATH_MAX];
+	wcstombs(fileName_c, _fileName, PATH_MAX);
+	_stream.open(fileName_c, _mode);
+#endif
+	return _stream.is_open();
+}
+
+bool FrameCapture::_openNewFile(std::ofstream & _stream, const wchar_t * _suffix)
+{
+	wchar_t fileName[PLUGIN_PATH_SIZE];
+	for (u32 i = 0; i < 1000; ++i) {
+		swprintf(fileName, PLUGIN_PATH_SIZE, L"%ls/GLideN64_%ls_%03u%ls",
+			m_streamFolder.c_str(), m_streamName.c_str(), i, _suffix);
+		if (osal_path_existsW(fileName) == 0)
+			return _openFile(_stream, fileName, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	}
+	return false;
+}
+
+bool FrameCapture::_openStream(const Frame & _frame)
+{
+	m_stream.close();
+	m_streamWidth = m_streamHeight = 0;
+
+	const bool y4m = m_mode == Config::fcY4M;
+	wchar_t suffix[32];
+	if (y4m)
+		swprintf(suffix, 32, L".y4m");
+	else
+		swprintf(suffix, 32, L"_%ux%u.rgb", _frame.width, _frame.height);
+	if (!_openNewFile(m_stream, suffix))
+		return false;
+
+	m_streamWidth = _frame.width;
+	m_streamHeight = _frame.height;
+	if (y4m)
+		FrameCompare::writeY4MHeader(m_stream, m_streamWidth, m_streamHeight, _frame.rate);
+	return true;
+}
+
+void FrameCapture::_writeStreamFrame(const Frame & _frame)
+{
+	if (!m_stream.is_open() || _frame.width != m_streamWidth || _frame.height != m_streamHeight) {
+		if (!_openStream(_frame)) {
+			LOG(LOG_WARNING, "Can't open frame capture file\n");
+			m_streamFailed = true;
+			return;
+		}
+	}
+
+	if (m_mode == Config::fcRawRGB) {
+		// Frame data is bottom-up, files are top-down.
+		const u32 srcStride = _frame.width * 4;
+		m_encodeBuffer.resize(_frame.width * _frame.height * 3);
+		u8 * dst = m_encodeBuffer.data();
+		for (u32 y = 0; y < _frame.height; ++y) {
+			const u8 * src = _frame.data.data() + (_frame.height - 1 - y) * srcStride;
+			for (u32 x = 0; x < _frame.width; ++x) {
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+				src += 4;
+				dst += 3;
+			}
+		}
+		m_stream.write(reinterpret_cast<const char*>(m_encodeBuffer.data()), m_encodeBuffer.size());
+	} else {
+		FrameCompare::convertToI420(_frame.data.data(), _frame.width, _frame.height, m_encodeBuffer);
+		FrameCompare::writeY4MFrame(m_stream, m_encodeBuffer);
+	}
+}
+
+bool FrameCapture::_openGolden()
+{
+	wchar_t fileName[PLUGIN_PATH_SIZE];
+	swprintf(fileName, PLUGIN_PATH_SIZE, L"%ls/GLideN64_%ls.golden.y4m", m_streamFolder.c_str(), m_streamName.c_str());
+	if (!_openFile(m_golden, fileName, std::ifstream::in | std::ifstream::binary))
+		return false;
+
+	if (!FrameCompare::readY4MHeader(m_golden, m_goldenWidth, m_goldenHeight))
+		return false;
+
+	if (!_openNewFile(m_report, L".csv"))
+		return false;
+	m_report << "frame,frame_ms,gpu_ms,psnr_db,max_diff,diff_samples,result\n";
+	return true;
+}
+
+void FrameCapture::_compareFrame(const Frame & _frame)
+{
+	if (!m_golden.is_open() && !_openGolden()) {
+		LOG(LOG_WARNING, "Can't open golden frame capture\n");
+		m_golden.close();
+		m_streamFailed = true;
+		return;
+	}
+
+	m_report << m_comparedFrames++ << ',' << _frame.frameTime << ',';
+	if (_frame.gpuTime >= 0.0f)
+		m_report << _frame.gpuTime;
+	m_report << ',';
+
+	// The golden frame is consumed even if this frame can't be compared, so later frames stay in step.
+	if (!FrameCompare::readY4MFrame(m_golden, m_goldenWidth, m_goldenHeight, m_goldenFrame)) {
+		m_report << ",,,missing\n";
+		++m_failedFrames;
+		return;
+	}
+
+	if (_frame.data.empty()) {
+		m_report << ",,,dropped\n";
+		return;
+	}
+
+	if ((_frame.width & ~1U) != m_goldenWidth || (_frame.height & ~1U) != m_goldenHeight) {
+		m_report << ",,,size\n";
+		++m_failedFrames;
+		return;
+	}
+
+	FrameCompare::convertToI420(_frame.data.data(), _frame.width, _frame.height, m_encodeBuffer);
+	const FrameCompare::Result result = FrameCompare::compare(m_encodeBuffer, m_goldenFrame);
+	if (!result.pass)
+		++m_failedFrames;
+	m_report << result.psnr << ',' << result.maxDiff << ',' << result.diffSamples << ',' << (result.pass ? "pass" : "fail") << '\n';
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Types.h"
+
+namespace graphics {
+	class PixelReadBuffer;
+}
+
+// Reads presented frames back through a ring of fenced pixel buffers and
+// encodes them on a worker thread, so the render thread never waits for the GPU.
+class FrameCapture
+{
+public:
+	typedef std::function<void(u32 _width, u32 _height, const u8 * _data)> ScreenshotWriter;
+
+	void init();
+	void destroy();
+
+	// _writer gets the next presented frame as bottom-up RGB and runs on the encoder thread.
+	void requestScreenshot(ScreenshotWriter _writer);
+
+	// Called before the frame is presented.
+	void captureFrame();
+
+	static FrameCapture & get();
+
+private:
+	FrameCapture() = default;
+	FrameCapture(const FrameCapture & _other) = delete;
+
+	struct Frame {
+		u32 width = 0;
+		u32 height = 0;
+		u32 rate = 0;
+		f32 frameTime = 0.0f;
+		f32 gpuTime = -1.0f;
+		bool stream = false;
+		ScreenshotWriter screenshot;
+		std::vector<u8> data; // empty if the frame was dropped
+	};
+
+	struct Slot {
+		std::unique_ptr<graphics::PixelReadBuffer> buffer;
+		Frame frame;
+	};
+
+	void _collect(u32 _minCount);
+	void _encoderThread();
+	void _encode(Frame & _frame);
+	bool _openNewFile(std::ofstream & _stream, const wchar_t * _suffix);
+	bool _openStream(const Frame & _frame);
+	void _writeStreamFrame(const Frame & _frame);
+	bool _openGolden();
+	void _compareFrame(const Frame & _frame);
+
+	static const u32 s_numSlots = 3;
+	static const size_t s_maxQueuedFrames = 32;
+
+	Slot m_slots[s_numSlots];
+	u32 m_nextSlot = 0;
+	u32 m_pendingSlots = 0;
+	u32 m_bufferWidth = 0;
+	u32 m_bufferHeight = 0;
+	u32 m_mode = 0;
+	u32 m_droppedFrames = 0;
+	bool m_supported = true;
+	ScreenshotWriter m_screenshot;
+	std::chrono::steady_clock::time_point m_lastCaptureTime;
+
+	std::thread m_encoder;
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::deque<Frame> m_frames;
+	bool m_stop = false;
+
+	// Encoder thread only
+	std::wstring m_streamFolder;
+	std::wstring m_streamName;
+	std::ofstream m_stream;
+	bool m_streamFailed = false;
+	u32 m_streamWidth = 0;
+	u32 m_streamHeight = 0;
+	std::vector<u8> m_encodeBuffer;
+	std::ifstream m_golden;
+	std::ofstream m_report;
+	std::vector<u8> m_goldenFrame;
+	u32 m_goldenWidth = 0;
+	u32 m_goldenHeight = 0;
+	u32 m_comparedFrames = 0;
+	u32 m_failedFrames = 0;
+};
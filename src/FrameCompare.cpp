@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include "FrameCompare.h"
+
+namespace FrameCompare {
+
+// Samples may differ by up to s_tolerance levels.
+// A frame fails when more than 1/s_maxDiffRatio of its samples differ by more.
+static const u32 s_tolerance = 6;
+static const size_t s_maxDiffRatio = 1000;
+
+static
+size_t frameSize(u32 _width, u32 _height)
+{
+	return _width * _height + 2 * ((_width + 1) / 2) * ((_height + 1) / 2);
+}
+
+void convertToI420(const u8 * _rgba, u32 _width, u32 _height, std::vector<u8> & _i420)
+{
+	const u32 srcStride = _width * 4;
+	const u32 width = _width & ~1U;
+	const u32 height = _height & ~1U;
+	const u32 chromaWidth = width / 2;
+	_i420.resize(width * height + 2 * chromaWidth * (height / 2));
+	u8 * dstY = _i420.data();
+	u8 * dstU = dstY + width * height;
+	u8 * dstV = dstU + chromaWidth * (height / 2);
+	for (u32 y = 0; y < height; y += 2) {
+		const u8 * src0 = _rgba + (_height - 1 - y) * srcStride;
+		const u8 * src1 = src0 - srcStride;
+		u8 * dstY0 = dstY + y * width;
+		u8 * dstY1 = dstY0 + width;
+		for (u32 x = 0; x < width; x += 2) {
+			s32 r = 0, g = 0, b = 0;
+			const u8 * quad[4] = { src0 + x * 4, src0 + x * 4 + 4, src1 + x * 4, src1 + x * 4 + 4 };
+			u8 * quadY[4] = { dstY0 + x, dstY0 + x + 1, dstY1 + x, dstY1 + x + 1 };
+			for (u32 i = 0; i < 4; ++i) {
+				const s32 pr = quad[i][0], pg = quad[i][1], pb = quad[i][2];
+				*quadY[i] = u8(((66 * pr + 129 * pg + 25 * pb + 128) >> 8) + 16);
+				r += pr;
+				g += pg;
+				b += pb;
+			}
+			r >>= 2;
+			g >>= 2;
+			b >>= 2;
+			*dstU++ = u8(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			*dstV++ = u8(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+}
+
+void writeY4MHeader(std::ostream & _stream, u32 _width, u32 _height, u32 _rate)
+{
+	_stream << "YUV4MPEG2 W" << (_width & ~1U) << " H" << (_height & ~1U)
+		<< " F" << _rate << ":1 Ip A1:1 C420jpeg\n";
+}
+
+void writeY4MFrame(std::ostream & _stream, const std::vector<u8> & _i420)
+{
+	_stream << "FRAME\n";
+	_stream.write(reinterpret_cast<const char*>(_i420.data()), _i420.size());
+}
+
+bool readY4MHeader(std::istream & _stream, u32 & _width, u32 & _height)
+{
+	std::string header;
+	std::getline(_stream, header);
+	if (header.compare(0, 10, "YUV4MPEG2 ") != 0)
+		return false;
+
+	_width = _height = 0;
+	std::istringstream tokens(header);
+	std::string token;
+	while (tokens >> token) {
+		if (token[0] == 'W')
+			_width = std::atoi(token.c_str() + 1);
+		else if (token[0] == 'H')
+			_height = std::atoi(token.c_str() + 1);
+		else if (token[0] == 'C' && token.compare(0, 4, "C420") != 0)
+			return false;
+	}
+	return _width != 0 && _height != 0;
+}
+
+bool readY4MFrame(std::istream & _stream, u32 _width, u32 _height, std::vector<u8> & _i420)
+{
+	_i420.resize(frameSize(_width, _height));
+	std::string frameHeader;
+	std::getline(_stream, frameHeader);
+	return frameHeader.compare(0, 5, "FRAME") == 0 &&
+		_stream.read(reinterpret_cast<char*>(_i420.data()), _i420.size());
+}
+
+Result compare(const std::vector<u8> & _frame, const std::vector<u8> & _golden)
+{
+	Result result;
+	const size_t size = _golden.size();
+	if (_frame.size() != size || size == 0)
+		return result;
+
+	// Small per-sample deltas come from rounding and filtering changes and are not visible.
+	u64 squaredError = 0;
+	for (size_t i = 0; i < size; ++i) {
+		const u32 diff = u32(std::abs(s32(_frame[i]) - s32(_golden[i])));
+		squaredError += diff * diff;
+		result.maxDiff = std::max(result.maxDiff, diff);
+		if (diff > s_tolerance)
+			++result.diffSamples;
+	}
+
+	const f64 mse = f64(squaredError) / f64(size);
+	result.psnr = mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+	result.pass = result.diffSamples <= size / s_maxDiffRatio;
+	return result;
+}
+
+}
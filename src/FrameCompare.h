@@ -0,0 +1,32 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "Types.h"
+
+// Y4M streams of presented frames and their comparison against golden frames.
+// Frames are 4:2:0 with even dimensions. An odd last row or column is dropped.
+namespace FrameCompare {
+
+	// _rgba is a bottom-up RGBA frame. _i420 gets it top-down in BT.601 studio range.
+	void convertToI420(const u8 * _rgba, u32 _width, u32 _height, std::vector<u8> & _i420);
+
+	void writeY4MHeader(std::ostream & _stream, u32 _width, u32 _height, u32 _rate);
+	void writeY4MFrame(std::ostream & _stream, const std::vector<u8> & _i420);
+
+	// Returns false if the stream is not 4:2:0 Y4M.
+	bool readY4MHeader(std::istream & _stream, u32 & _width, u32 & _height);
+	// Reads the next frame of a stream with the given header size.
+	bool readY4MFrame(std::istream & _stream, u32 _width, u32 _height, std::vector<u8> & _i420);
+
+	struct Result
+	{
+		f64 psnr = 0.0;
+		u32 maxDiff = 0;
+		u32 diffSamples = 0;
+		bool pass = false;
+	};
+
+	// Frames of equal size pass if few samples differ by more than rounding and filtering changes do.
+	Result compare(const std::vector<u8> & _frame, const std::vector<u8> & _golden);
+}
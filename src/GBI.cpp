@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <cctype>
+#include <fstream>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -31,6 +32,8 @@
 #include "CRC.h"
 #include "Log.h"
 #include "DebugDump.h"
+#include "PluginAPI.h"
+#include <osal_files.h>
 #include "Graphics/Context.h"
 #include "Graphics/Parameters.h"
 
@@ -123,14 +126,122 @@ void GBIInfo::init()
 {
 	m_pCurrent = nullptr;
 	_flushCommands();
+	_loadRegistry();
 }
 
 void GBIInfo::destroy()
 {
+	_saveRegistry();
 	m_pCurrent = nullptr;
 	m_list.clear();
 }
 
+static const char * registryHeader = "GLideN64 microcode registry 1";
+
+template<class Stream>
+static
+bool _openRegistryFile(Stream & _stream, std::ios_base::openmode _mode)
+{
+	wchar_t strCacheFolderPath[PLUGIN_PATH_SIZE];
+	api().GetUserCachePath(strCacheFolderPath);
+	if (!osal_path_existsW(strCacheFolderPath) && osal_mkdirp(strCacheFolderPath) != 0)
+		return false;
+	wchar_t fileName[PLUGIN_PATH_SIZE];
+	swprintf(fileName, PLUGIN_PATH_SIZE, L"%ls/GLideN64.ucodes", strCacheFolderPath);
+#if defined(OS_WINDOWS) && !defined(MINGW)
+	_stream.open(fileName, _mode);
+#else
+	char fileName_c[PATH_MAX];
+	wcstombs(fileName_c, fileName, PATH_MAX);
+	_stream.open(fileName_c, _mode);
+#endif
+	return _stream.is_open();
+}
+
+// Each microcode is stored as
+//   ucode <code crc> <data crc> <type> <NoN> <negativeY> <textureGen> <texturePersp> <name>
+// followed by the ROMs microcodes were seen in:
+//   rom <code crc> <data crc> <ROM name>
+void GBIInfo::_loadRegistry()
+{
+	m_registry.clear();
+	m_registryRoms.clear();
+	m_registryChanged = false;
+
+	std::ifstream file;
+	if (!_openRegistryFile(file, std::ifstream::in))
+		return;
+
+	std::string line;
+	if (!std::getline(file, line) || line != registryHeader)
+		return;
+
+	while (std::getline(file, line)) {
+		u32 crc, dataCrc, type, NoN, negativeY, textureGen, texturePersp;
+		int pos = 0;
+		if (sscanf(line.c_str(), "ucode %x %x %u %u %u %u %u %n", &crc, &dataCrc,
+				&type, &NoN, &negativeY, &textureGen, &texturePersp, &pos) == 7 && pos > 0) {
+			if (type >= NONE)
+				continue;
+			RegisteredMicrocode & registered = m_registry[(u64(crc) << 32) | dataCrc];
+			registered.type = type;
+			registered.NoN = NoN != 0;
+			registered.negativeY = negativeY != 0;
+			registered.textureGen = textureGen != 0;
+			registered.texturePersp = texturePersp != 0;
+			registered.name = line.substr(pos);
+		} else if (sscanf(line.c_str(), "rom %x %x %n", &crc, &dataCrc, &pos) == 2 && pos > 0) {
+			m_registryRoms.emplace(line.substr(pos), (u64(crc) << 32) | dataCrc);
+		}
+	}
+}
+
+void GBIInfo::_saveRegistry()
+{
+	if (!m_registryChanged)
+		return;
+	m_registryChanged = false;
+
+	std::ofstream file;
+	if (!_openRegistryFile(file, std::ofstream::out | std::ofstream::trunc))
+		return;
+
+	char buf[128];
+	file << registryHeader << "\n";
+	for (const auto & entry : m_registry) {
+		const RegisteredMicrocode & registered = entry.second;
+		sprintf(buf, "ucode %08x %08x %u %u %u %u %u ", u32(entry.first >> 32), u32(entry.first),
+			registered.type, u32(registered.NoN), u32(registered.negativeY),
+			u32(registered.textureGen), u32(registered.texturePersp));
+		file << buf << registered.name << "\n";
+	}
+	for (const auto & rom : m_registryRoms) {
+		sprintf(buf, "rom %08x %08x ", u32(rom.second >> 32), u32(rom.second));
+		file << buf << rom.first << "\n";
+	}
+}
+
+void GBIInfo::_registerMicrocode(const MicrocodeInfo & _info, const char * _name)
+{
+	const u64 key = (u64(_info.crc) << 32) | _info.dataCrc;
+	if (m_registry.count(key) == 0) {
+		RegisteredMicrocode & registered = m_registry[key];
+		registered.type = _info.type;
+		registered.NoN = _info.NoN;
+		registered.negativeY = _info.negativeY;
+		registered.textureGen = _info.textureGen;
+		registered.texturePersp = _info.texturePersp;
+		registered.name = _name;
+		for (char & c : registered.name) {
+			if (c < ' ')
+				c = ' ';
+		}
+		m_registryChanged = true;
+	}
+	if (m_registryRoms.emplace(RSP.romname, key).second)
+		m_registryChanged = true;
+}
+
 bool GBIInfo::isHWLSupported() const
 {
 	if (m_pCurrent == nullptr)
@@ -250,20 +361,37 @@ void GBIInfo::loadMicrocode(u32 uc_start, u32 uc_dstart, u16 uc_dsize)
 
 	// See if we can identify it by CRC
 	const u32 uc_crc = CRC_Calculate_Strict( 0xFFFFFFFF, &RDRAM[uc_start & 0x1FFFFFFF], 4096 );
+	char uc_data[2048];
+	UnswapCopyWrap(RDRAM, uc_dstart & 0x1FFFFFFF, (u8*)uc_data, 0, 0x7FF, 2048);
+	current.crc = uc_crc;
+	current.dataCrc = CRC_Calculate_Strict(0xFFFFFFFF, uc_data, 2048);
+
 	const u32 numSpecialMicrocodes = sizeof(specialMicrocodes) / sizeof(SpecialMicrocodeInfo);
 	for (u32 i = 0; i < numSpecialMicrocodes; ++i) {
 		if (uc_crc == specialMicrocodes[i].crc) {
 			current.type = specialMicrocodes[i].type;
 			current.NoN = specialMicrocodes[i].NoN;
 			current.negativeY = specialMicrocodes[i].negativeY;
+			_registerMicrocode(current, specialMicrocodes[i].text);
 			_makeCurrent(&current);
 			return;
 		}
 	}
 
+	// See if it was identified before
+	MicrocodeRegistry::const_iterator registered = m_registry.find((u64(current.crc) << 32) | current.dataCrc);
+	if (registered != m_registry.end()) {
+		current.type = registered->second.type;
+		current.NoN = registered->second.NoN;
+		current.negativeY = registered->second.negativeY;
+		current.textureGen = registered->second.textureGen;
+		current.texturePersp = registered->second.texturePersp;
+		_registerMicrocode(current, registered->second.name.c_str());
+		_makeCurrent(&current);
+		return;
+	}
+
 	// See if we can identify it by text
-	char uc_data[2048];
-	UnswapCopyWrap(RDRAM, uc_dstart & 0x1FFFFFFF, (u8*)uc_data, 0, 0x7FF, 2048);
 	char uc_str[256];
 	strcpy(uc_str, "Not Found");
 
@@ -326,6 +454,7 @@ void GBIInfo::loadMicrocode(u32 uc_start, u32 uc_dstart, u16 uc_dsize)
 
 			if (type != NONE) {
 				current.type = type;
+				_registerMicrocode(current, uc_str);
 				_makeCurrent(&current);
 				return;
 			}
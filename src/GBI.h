@@ -2,6 +2,9 @@
 #define GBI_H
 
 #include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 #include "Types.h"
 
@@ -487,7 +490,7 @@ struct MicrocodeInfo
 	u32 address, dataAddress;
 	u16 dataSize;
 	u32 type;
-	u32 crc;
+	u32 crc, dataCrc;
 	bool NoN;
 	bool negativeY;
 	bool textureGen;
@@ -516,10 +519,30 @@ private:
 	void _makeCurrent(MicrocodeInfo * _pCurrent);
 	bool _makeExistingMicrocodeCurrent(u32 uc_start, u32 uc_dstart, u32 uc_dsize);
 
+	void _loadRegistry();
+	void _saveRegistry();
+	void _registerMicrocode(const MicrocodeInfo & _info, const char * _name);
+
 	MicrocodeInfo * m_pCurrent;
 
 	typedef std::list<MicrocodeInfo> Microcodes;
 	Microcodes m_list;
+
+	// Microcodes identified in this or earlier sessions, keyed by code and data CRC.
+	// Stored in the user cache folder together with the ROMs each one was seen in.
+	struct RegisteredMicrocode
+	{
+		u32 type;
+		bool NoN;
+		bool negativeY;
+		bool textureGen;
+		bool texturePersp;
+		std::string name;
+	};
+	typedef std::unordered_map<u64, RegisteredMicrocode> MicrocodeRegistry;
+	MicrocodeRegistry m_registry;
+	std::set<std::pair<std::string, u64>> m_registryRoms;
+	bool m_registryChanged;
 };
 
 extern GBIInfo GBI;
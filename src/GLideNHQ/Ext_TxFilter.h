@@ -85,6 +85,7 @@ typedef unsigned char boolean;
 #define BRZ6X_ENHANCEMENT   0x00000c00
 
 #define DEPOSTERIZE         0x00001000
+#define STREAM_HIRESTEX     0x00002000 /* load hires textures on first use */
 
 #define HIRESTEXTURES_MASK  0x000f0000
 #define NO_HIRESTEXTURES    0x00000000
@@ -92,14 +93,14 @@ typedef unsigned char boolean;
 #define RICE_HIRESTEXTURES  0x00020000
 #define JABO_HIRESTEXTURES  0x00030000
 
-//#define COMPRESS_TEX        0x00100000 // Not used anymore
-//#define COMPRESS_HIRESTEX   0x00200000 // Not used anymore
+#define COMPRESS_TEX        0x00100000 /* GPU block compression of enhanced textures */
+#define COMPRESS_HIRESTEX   0x00200000 /* GPU block compression of hires textures */
 #define GZ_TEXCACHE         0x00400000
 #define GZ_HIRESTEXCACHE    0x00800000
 #define DUMP_TEXCACHE       0x01000000
 #define DUMP_HIRESTEXCACHE  0x02000000
 #define TILE_HIRESTEX       0x04000000
-#define UNDEFINED_0         0x08000000
+#define ETC2_COMPRESSION    0x08000000 /* use ETC2 instead of S3TC for COMPRESS_TEX/COMPRESS_HIRESTEX */
 #define FORCE16BPP_HIRESTEX 0x10000000
 #define FORCE16BPP_TEX      0x20000000
 #define LET_TEXARTISTS_FLY  0x40000000 /* a little freedom for texture artists */
@@ -219,7 +220,7 @@ extern "C"{
 #endif
 
 TAPI boolean TAPIENTRY
-txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize, int hirescachesize, int hashid,
 	const wchar_t *path, const wchar_t * texPackPath, const wchar_t*ident, dispInfoFuncExt callback);
 
 TAPI void TAPIENTRY
@@ -241,6 +242,9 @@ txfilter_dmptx(uint8 *src, int width, int height, int rowStridePixel, uint16 gfm
 TAPI boolean TAPIENTRY
 txfilter_reloadhirestex();
 
+TAPI boolean TAPIENTRY
+txfilter_hirestexpending(uint64 r_crc64);
+
 #ifdef __cplusplus
 }
 #endif
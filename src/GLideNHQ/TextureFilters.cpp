@@ -23,9 +23,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <vector>
 #include "TextureFilters.h"
 #include "TxUtil.h"
+#include "TxThreadPool.h"
 
 /************************************************************************/
 /* 2X filters                                                           */
@@ -814,3 +816,96 @@ void filter_8888(uint32 *src, uint32 srcwidth, uint32 srcheight, uint32 *dest, u
 	return;
 	}
 }
+
+boolean filter_8888_sliceable(uint32 filter) {
+	switch (filter & ENHANCEMENT_MASK) {
+	case BRZ2X_ENHANCEMENT:
+	case BRZ3X_ENHANCEMENT:
+	case BRZ4X_ENHANCEMENT:
+	case BRZ5X_ENHANCEMENT:
+	case BRZ6X_ENHANCEMENT:
+	case HQ4X_ENHANCEMENT:
+	case HQ2X_ENHANCEMENT:
+	case HQ2XS_ENHANCEMENT:
+	case LQ2X_ENHANCEMENT:
+	case LQ2XS_ENHANCEMENT:
+		return 1;
+	}
+	return 0;
+}
+
+static
+void filter_8888_slice(uint32 *src, uint32 srcwidth, uint32 srcheight, uint32 *dest, uint32 filter, int yFirst, int yLast) {
+	switch (filter & ENHANCEMENT_MASK) {
+	case BRZ2X_ENHANCEMENT:
+		xbrz::scale(2, (const uint32_t *)src, (uint32_t *)dest, srcwidth, srcheight, xbrz::ColorFormat::ABGR, xbrz::ScalerCfg(), yFirst, yLast);
+	return;
+	case BRZ3X_ENHANCEMENT:
+		xbrz::scale(3, (const uint32_t *)src, (uint32_t *)dest, srcwidth, srcheight, xbrz::ColorFormat::ABGR, xbrz::ScalerCfg(), yFirst, yLast);
+	return;
+	case BRZ4X_ENHANCEMENT:
+		xbrz::scale(4, (const uint32_t *)src, (uint32_t *)dest, srcwidth, srcheight, xbrz::ColorFormat::ABGR, xbrz::ScalerCfg(), yFirst, yLast);
+	return;
+	case BRZ5X_ENHANCEMENT:
+		xbrz::scale(5, (const uint32_t *)src, (uint32_t *)dest, srcwidth, srcheight, xbrz::ColorFormat::ABGR, xbrz::ScalerCfg(), yFirst, yLast);
+	return;
+	case BRZ6X_ENHANCEMENT:
+		xbrz::scale(6, (const uint32_t *)src, (uint32_t *)dest, srcwidth, srcheight, xbrz::ColorFormat::ABGR, xbrz::ScalerCfg(), yFirst, yLast);
+	return;
+	case HQ4X_ENHANCEMENT:
+		hq4x_8888((uint8*)src, (uint8*)dest, srcwidth, srcheight, srcwidth, (srcwidth << 4), yFirst, yLast);
+	return;
+	case HQ2X_ENHANCEMENT:
+		hq2x_32((uint8*)src, (srcwidth << 2), (uint8*)dest, (srcwidth << 3), srcwidth, srcheight, yFirst, yLast);
+	return;
+	case HQ2XS_ENHANCEMENT:
+		hq2xS_32((uint8*)src, (srcwidth << 2), (uint8*)dest, (srcwidth << 3), srcwidth, srcheight, yFirst, yLast);
+	return;
+	case LQ2X_ENHANCEMENT:
+		lq2x_32((uint8*)src, (srcwidth << 2), (uint8*)dest, (srcwidth << 3), srcwidth, srcheight, yFirst, yLast);
+	return;
+	case LQ2XS_ENHANCEMENT:
+		lq2xS_32((uint8*)src, (srcwidth << 2), (uint8*)dest, (srcwidth << 3), srcwidth, srcheight, yFirst, yLast);
+	return;
+	}
+}
+
+/* Filters slices of rows of the whole image on the shared thread pool.
+ * Unlike splitting the texture into separate blocks, every slice sees its
+ * neighbour rows, so there are no seams where the slices meet. */
+void filter_8888_sliced(uint32 *src, uint32 srcwidth, uint32 srcheight, uint32 *dest, uint32 filter) {
+	static const uint32 minSliceRows = 8;
+	TxThreadPool * pool = TxThreadPool::getInstance();
+	/* a few slices per thread even out the uneven cost of the rows */
+	uint32 sliceRows = (srcheight + pool->concurrency() * 4 - 1) / (pool->concurrency() * 4);
+	if (sliceRows < minSliceRows)
+		sliceRows = minSliceRows;
+	const uint32 numSlices = (srcheight + sliceRows - 1) / sliceRows;
+
+	if (filter & DEPOSTERIZE) {
+		const auto bufSize = srcwidth * srcheight;
+		uint32 * tex = TxMemBuf::getInstance()->getThreadBuf(0, 0, bufSize);
+		uint32 * buf = TxMemBuf::getInstance()->getThreadBuf(0, 1, bufSize);
+		if (tex != nullptr && buf != nullptr) {
+			/* each pass reads the neighbour rows of the previous one, so the passes run one after another */
+			const int w = srcwidth, h = srcheight;
+			pool->parallelFor(numSlices, [=](uint32 i) {
+				deposterizeH(src, buf, w, i * sliceRows, std::min((i + 1) * sliceRows, srcheight));
+			});
+			pool->parallelFor(numSlices, [=](uint32 i) {
+				deposterizeV(buf, tex, w, h, i * sliceRows, std::min((i + 1) * sliceRows, srcheight));
+			});
+			pool->parallelFor(numSlices, [=](uint32 i) {
+				deposterizeH(tex, buf, w, i * sliceRows, std::min((i + 1) * sliceRows, srcheight));
+			});
+			pool->parallelFor(numSlices, [=](uint32 i) {
+				deposterizeV(buf, tex, w, h, i * sliceRows, std::min((i + 1) * sliceRows, srcheight));
+			});
+			src = tex;
+		}
+	}
+
+	pool->parallelFor(numSlices, [=](uint32 i) {
+		filter_8888_slice(src, srcwidth, srcheight, dest, filter, i * sliceRows, std::min((i + 1) * sliceRows, srcheight));
+	});
+}
@@ -25,6 +25,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "TextureFilters.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HQ2X_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HQ2X_NEON
+#include <arm_neon.h>
+#endif
+
 /************************************************************************/
 /* hq2x filters                                                         */
 /************************************************************************/
@@ -268,6 +276,122 @@ static int hq2x_interp_32_diff(uint32 p1, uint32 p2)
   return 0;
 }
 
+#if defined(HQ2X_SSE2)
+/* hq2x_interp_32_diff for 4 pixels. lanes are all ones where the pixels differ */
+static __m128i hq2x_interp_32_diff4(__m128i p1, __m128i p2)
+{
+  const __m128i m = _mm_set1_epi32(0xF8F8F8);
+  const __m128i ff = _mm_set1_epi32(0xFF);
+  const __m128i same = _mm_cmpeq_epi32(_mm_and_si128(p1, m), _mm_and_si128(p2, m));
+
+  const __m128i r = _mm_sub_epi32(_mm_and_si128(p1, ff), _mm_and_si128(p2, ff));
+  const __m128i g = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 8), ff), _mm_and_si128(_mm_srli_epi32(p2, 8), ff));
+  const __m128i b = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 16), ff), _mm_and_si128(_mm_srli_epi32(p2, 16), ff));
+
+  const __m128i y = _mm_add_epi32(_mm_add_epi32(r, g), b);
+  const __m128i u = _mm_sub_epi32(r, b);
+  const __m128i v = _mm_sub_epi32(_mm_add_epi32(g, g), _mm_add_epi32(r, b));
+
+  __m128i out = _mm_or_si128(_mm_cmpgt_epi32(y, _mm_set1_epi32(INTERP_Y_LIMIT)), _mm_cmplt_epi32(y, _mm_set1_epi32(-INTERP_Y_LIMIT)));
+  out = _mm_or_si128(out, _mm_or_si128(_mm_cmpgt_epi32(u, _mm_set1_epi32(INTERP_U_LIMIT)), _mm_cmplt_epi32(u, _mm_set1_epi32(-INTERP_U_LIMIT))));
+  out = _mm_or_si128(out, _mm_or_si128(_mm_cmpgt_epi32(v, _mm_set1_epi32(INTERP_V_LIMIT)), _mm_cmplt_epi32(v, _mm_set1_epi32(-INTERP_V_LIMIT))));
+  return _mm_andnot_si128(same, out);
+}
+#elif defined(HQ2X_NEON)
+static uint32x4_t hq2x_interp_32_diff4(uint32x4_t p1, uint32x4_t p2)
+{
+  const uint32x4_t m = vdupq_n_u32(0xF8F8F8);
+  const uint32x4_t ff = vdupq_n_u32(0xFF);
+  const uint32x4_t same = vceqq_u32(vandq_u32(p1, m), vandq_u32(p2, m));
+
+  const int32x4_t r = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(p1, ff)), vreinterpretq_s32_u32(vandq_u32(p2, ff)));
+  const int32x4_t g = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p1, 8), ff)), vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p2, 8), ff)));
+  const int32x4_t b = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p1, 16), ff)), vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p2, 16), ff)));
+
+  const int32x4_t y = vaddq_s32(vaddq_s32(r, g), b);
+  const int32x4_t u = vsubq_s32(r, b);
+  const int32x4_t v = vsubq_s32(vaddq_s32(g, g), vaddq_s32(r, b));
+
+  uint32x4_t out = vorrq_u32(vcgtq_s32(y, vdupq_n_s32(INTERP_Y_LIMIT)), vcltq_s32(y, vdupq_n_s32(-INTERP_Y_LIMIT)));
+  out = vorrq_u32(out, vorrq_u32(vcgtq_s32(u, vdupq_n_s32(INTERP_U_LIMIT)), vcltq_s32(u, vdupq_n_s32(-INTERP_U_LIMIT))));
+  out = vorrq_u32(out, vorrq_u32(vcgtq_s32(v, vdupq_n_s32(INTERP_V_LIMIT)), vcltq_s32(v, vdupq_n_s32(-INTERP_V_LIMIT))));
+  return vbicq_u32(out, same);
+}
+#endif
+
+static unsigned char hq2x_32_mask_pixel(const uint32* src0, const uint32* src1, const uint32* src2, int l, int r)
+{
+  const uint32 c4 = src1[0];
+  unsigned char mask = 0;
+
+  if (hq2x_interp_32_diff(src0[l], c4))
+	mask |= 1 << 0;
+  if (hq2x_interp_32_diff(src0[0], c4))
+	mask |= 1 << 1;
+  if (hq2x_interp_32_diff(src0[r], c4))
+	mask |= 1 << 2;
+  if (hq2x_interp_32_diff(src1[l], c4))
+	mask |= 1 << 3;
+  if (hq2x_interp_32_diff(src1[r], c4))
+	mask |= 1 << 4;
+  if (hq2x_interp_32_diff(src2[l], c4))
+	mask |= 1 << 5;
+  if (hq2x_interp_32_diff(src2[0], c4))
+	mask |= 1 << 6;
+  if (hq2x_interp_32_diff(src2[r], c4))
+	mask |= 1 << 7;
+
+  return mask;
+}
+
+/* masks of the pixels [first, first + n) of a line of count pixels. src pointers point at pixel first */
+static void hq2x_32_mask(unsigned char* mask, const uint32* src0, const uint32* src1, const uint32* src2, unsigned first, unsigned n, unsigned count)
+{
+  unsigned t = 0;
+
+#if defined(HQ2X_SSE2) || defined(HQ2X_NEON)
+  /* the vector path needs both neighbours of all 4 pixels inside the line */
+  if (first == 0 && n > 0) {
+	mask[0] = hq2x_32_mask_pixel(src0, src1, src2, 0, count > 1 ? 1 : 0);
+	t = 1;
+  }
+  for (; t + 4 <= n && first + t + 4 < count; t += 4) {
+	uint32 m[4];
+#if defined(HQ2X_SSE2)
+	const __m128i c4 = _mm_loadu_si128((const __m128i*)(src1 + t));
+	const __m128i c[8] = {
+	  _mm_loadu_si128((const __m128i*)(src0 + t - 1)),
+	  _mm_loadu_si128((const __m128i*)(src0 + t)),
+	  _mm_loadu_si128((const __m128i*)(src0 + t + 1)),
+	  _mm_loadu_si128((const __m128i*)(src1 + t - 1)),
+	  _mm_loadu_si128((const __m128i*)(src1 + t + 1)),
+	  _mm_loadu_si128((const __m128i*)(src2 + t - 1)),
+	  _mm_loadu_si128((const __m128i*)(src2 + t)),
+	  _mm_loadu_si128((const __m128i*)(src2 + t + 1))
+	};
+	__m128i acc = _mm_setzero_si128();
+	for (int k = 0; k < 8; ++k)
+	  acc = _mm_or_si128(acc, _mm_and_si128(hq2x_interp_32_diff4(c[k], c4), _mm_set1_epi32(1 << k)));
+	_mm_storeu_si128((__m128i*)m, acc);
+#else
+	const uint32x4_t c4 = vld1q_u32(src1 + t);
+	const uint32* c[8] = { src0 + t - 1, src0 + t, src0 + t + 1, src1 + t - 1, src1 + t + 1, src2 + t - 1, src2 + t, src2 + t + 1 };
+	uint32x4_t acc = vdupq_n_u32(0);
+	for (int k = 0; k < 8; ++k)
+	  acc = vorrq_u32(acc, vandq_u32(hq2x_interp_32_diff4(vld1q_u32(c[k]), c4), vdupq_n_u32(1u << k)));
+	vst1q_u32(m, acc);
+#endif
+	mask[t] = (unsigned char)m[0];
+	mask[t + 1] = (unsigned char)m[1];
+	mask[t + 2] = (unsigned char)m[2];
+	mask[t + 3] = (unsigned char)m[3];
+  }
+#endif
+
+  for (; t < n; ++t)
+	mask[t] = hq2x_32_mask_pixel(src0 + t, src1 + t, src2 + t, (first + t > 0) ? -1 : 0, (first + t < count - 1) ? 1 : 0);
+}
+
 /*static void interp_set(unsigned bits_per_pixel)
 {
    interp_bits_per_pixel = bits_per_pixel;
@@ -525,6 +649,8 @@ static void hq2xS_16_def(uint16* dst0, uint16* dst1, const uint16* src0, const u
 
 static void hq2x_32_def(uint32* dst0, uint32* dst1, const uint32* src0, const uint32* src1, const uint32* src2, unsigned count)
 {
+  static const unsigned maskChunk = 64;
+  unsigned char masks[maskChunk];
   unsigned i;
 
   for(i=0;i<count;++i) {
@@ -556,24 +682,9 @@ static void hq2x_32_def(uint32* dst0, uint32* dst1, const uint32* src0, const ui
 	  c[8] = src2[0];
 	}
 
-	mask = 0;
-
-	if (hq2x_interp_32_diff(c[0], c[4]))
-	  mask |= 1 << 0;
-	if (hq2x_interp_32_diff(c[1], c[4]))
-	  mask |= 1 << 1;
-	if (hq2x_interp_32_diff(c[2], c[4]))
-	  mask |= 1 << 2;
-	if (hq2x_interp_32_diff(c[3], c[4]))
-	  mask |= 1 << 3;
-	if (hq2x_interp_32_diff(c[5], c[4]))
-	  mask |= 1 << 4;
-	if (hq2x_interp_32_diff(c[6], c[4]))
-	  mask |= 1 << 5;
-	if (hq2x_interp_32_diff(c[7], c[4]))
-	  mask |= 1 << 6;
-	if (hq2x_interp_32_diff(c[8], c[4]))
-	  mask |= 1 << 7;
+	if (i % maskChunk == 0)
+	  hq2x_32_mask(masks, src0, src1, src2, i, count - i < maskChunk ? count - i : maskChunk, count);
+	mask = masks[i % maskChunk];
 
 #define P0 dst0[0]
 #define P1 dst0[1]
@@ -1312,62 +1423,35 @@ void hq2xS_16(u8 *srcPtr, u32 srcPitch, u8 * /* deltaPtr */,
 }
 #endif /* !_16BPP_HACK */
 
-void hq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
-{
-  uint32 *dst0 = (uint32 *)dstPtr;
-  uint32 *dst1 = dst0 + (dstPitch >> 2);
-
-  uint32 *src0 = (uint32 *)srcPtr;
-  uint32 *src1 = src0 + (srcPitch >> 2);
-  uint32 *src2 = src1 + (srcPitch >> 2);
-
-  int count;
-
-  hq2x_32_def(dst0, dst1, src0, src0, src1, width);
-  if( height == 1 ) return;
+typedef void (*hq2x_32_line)(uint32* dst0, uint32* dst1, const uint32* src0, const uint32* src1, const uint32* src2, unsigned count);
 
-  count = height;
-
-  count -= 2;
-  while(count>0) {
-	dst0 += dstPitch >> 1;
-	dst1 += dstPitch >> 1;
-	hq2x_32_def(dst0, dst1, src0, src1, src2, width);
-	src0 = src1;
-	src1 = src2;
-	src2 += srcPitch >> 2;
-	--count;
+/* filters the source lines [yFirst, yLast). edge runs on the first and last line of the image, inner on the others */
+static void hq2x_32_lines(hq2x_32_line edge, hq2x_32_line inner, uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int yFirst, int yLast)
+{
+  if (yFirst < 0) yFirst = 0;
+  if (yLast > height) yLast = height;
+
+  for (int y = yFirst; y < yLast; ++y) {
+	const uint32 *src0 = (const uint32 *)(srcPtr + (y > 0 ? y - 1 : y) * srcPitch);
+	const uint32 *src1 = (const uint32 *)(srcPtr + y * srcPitch);
+	const uint32 *src2 = (const uint32 *)(srcPtr + (y < height - 1 ? y + 1 : y) * srcPitch);
+	uint32 *dst0 = (uint32 *)(dstPtr + y * 2 * dstPitch);
+	uint32 *dst1 = (uint32 *)(dstPtr + (y * 2 + 1) * dstPitch);
+	if (y == 0 || y == height - 1)
+	  edge(dst0, dst1, src0, src1, src2, width);
+	else
+	  inner(dst0, dst1, src0, src1, src2, width);
   }
-  dst0 += dstPitch >> 1;
-  dst1 += dstPitch >> 1;
-  hq2x_32_def(dst0, dst1, src0, src1, src1, width);
 }
 
-void hq2xS_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void hq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int yFirst, int yLast)
 {
-  uint32 *dst0 = (uint32 *)dstPtr;
-  uint32 *dst1 = dst0 + (dstPitch >> 2);
-
-  uint32 *src0 = (uint32 *)srcPtr;
-  uint32 *src1 = src0 + (srcPitch >> 2);
-  uint32 *src2 = src1 + (srcPitch >> 2);
-  hq2xS_32_def(dst0, dst1, src0, src0, src1, width);
-
-  int count = height;
+  hq2x_32_lines(hq2x_32_def, hq2x_32_def, srcPtr, srcPitch, dstPtr, dstPitch, width, height, yFirst, yLast);
+}
 
-  count -= 2;
-  while(count) {
-	dst0 += dstPitch >> 1;
-	dst1 += dstPitch >> 1;
-	hq2xS_32_def(dst0, dst1, src0, src1, src2, width);
-	src0 = src1;
-	src1 = src2;
-	src2 += srcPitch >> 2;
-	--count;
-  }
-  dst0 += dstPitch >> 1;
-  dst1 += dstPitch >> 1;
-  hq2xS_32_def(dst0, dst1, src0, src1, src1, width);
+void hq2xS_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int yFirst, int yLast)
+{
+  hq2x_32_lines(hq2xS_32_def, hq2xS_32_def, srcPtr, srcPitch, dstPtr, dstPitch, width, height, yFirst, yLast);
 }
 
 #if !_16BPP_HACK
@@ -1434,66 +1518,14 @@ void lq2xS_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 }
 #endif /* !_16BPP_HACK */
 
-void lq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void lq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int yFirst, int yLast)
 {
-  uint32 *dst0 = (uint32 *)dstPtr;
-  uint32 *dst1 = dst0 + (dstPitch >> 2);
-
-  uint32 *src0 = (uint32 *)srcPtr;
-  uint32 *src1 = src0 + (srcPitch >> 2);
-  uint32 *src2 = src1 + (srcPitch >> 2);
-
-  int count;
-
-  lq2x_32_def(dst0, dst1, src0, src0, src1, width);
-  if( height == 1 ) return;
-
-  count = height;
-
-  count -= 2;
-  while(count>0) {
-	dst0 += dstPitch >> 1;
-	dst1 += dstPitch >> 1;
-	hq2x_32_def(dst0, dst1, src0, src1, src2, width);
-	src0 = src1;
-	src1 = src2;
-	src2 += srcPitch >> 2;
-	--count;
-  }
-  dst0 += dstPitch >> 1;
-  dst1 += dstPitch >> 1;
-  lq2x_32_def(dst0, dst1, src0, src1, src1, width);
+  hq2x_32_lines(lq2x_32_def, hq2x_32_def, srcPtr, srcPitch, dstPtr, dstPitch, width, height, yFirst, yLast);
 }
 
-void lq2xS_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void lq2xS_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int yFirst, int yLast)
 {
-  uint32 *dst0 = (uint32 *)dstPtr;
-  uint32 *dst1 = dst0 + (dstPitch >> 2);
-
-  uint32 *src0 = (uint32 *)srcPtr;
-  uint32 *src1 = src0 + (srcPitch >> 2);
-  uint32 *src2 = src1 + (srcPitch >> 2);
-
-  int count;
-
-  lq2xS_32_def(dst0, dst1, src0, src0, src1, width);
-  if( height == 1 ) return;
-
-  count = height;
-
-  count -= 2;
-  while(count>0) {
-	dst0 += dstPitch >> 1;
-	dst1 += dstPitch >> 1;
-	hq2x_32_def(dst0, dst1, src0, src1, src2, width);
-	src0 = src1;
-	src1 = src2;
-	src2 += srcPitch >> 2;
-	--count;
-  }
-  dst0 += dstPitch >> 1;
-  dst1 += dstPitch >> 1;
-  lq2xS_32_def(dst0, dst1, src0, src1, src1, width);
+  hq2x_32_lines(lq2xS_32_def, hq2x_32_def, srcPtr, srcPitch, dstPtr, dstPitch, width, height, yFirst, yLast);
 }
 
 /************************************************************************/
@@ -25,8 +25,17 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <vector>
 #include "TextureFilters.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HQ4X_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HQ4X_NEON
+#include <arm_neon.h>
+#endif
+
 #if !_16BPP_HACK
 static uint32 RGB444toYUV[4096];
 #define RGB444toYUV(val) RGB444toYUV[val & 0x0FFF]   /* val = ARGB4444 */
@@ -688,7 +697,75 @@ void hq4x_565(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
 }
 #endif /* !_16BPP_HACK */
 
-void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL)
+/* yuv gets Xres+2 entries with the edge pixels repeated, so yuv[i+1] is column i */
+static void hq4x_YUVRow_8888(const uint32 * src, uint32 * yuv, int Xres)
+{
+  for (int i = 0; i < Xres; i++)
+	yuv[i+1] = RGB888toYUV(src[i]);
+  yuv[0] = yuv[1];
+  yuv[Xres+1] = yuv[Xres];
+}
+
+/* bit k of pattern[i] is set when neighbour w[k+1] (w[k+2] past the center) differs from w[5] */
+static void hq4x_Patterns_8888(const uint32 * yuv0, const uint32 * yuv1, const uint32 * yuv2, int * pattern, int Xres)
+{
+  int i = 0;
+
+#if defined(HQ4X_SSE2)
+  /* a byte of |YUV1 - YUV2| above its threshold leaves a non zero byte after the saturated subtraction */
+  const __m128i thr = _mm_set1_epi32(trY | trU | trV);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= Xres; i += 4) {
+	const __m128i w5 = _mm_loadu_si128((const __m128i*)(yuv1 + i + 1));
+	const __m128i w[8] = {
+	  _mm_loadu_si128((const __m128i*)(yuv0 + i)),
+	  _mm_loadu_si128((const __m128i*)(yuv0 + i + 1)),
+	  _mm_loadu_si128((const __m128i*)(yuv0 + i + 2)),
+	  _mm_loadu_si128((const __m128i*)(yuv1 + i)),
+	  _mm_loadu_si128((const __m128i*)(yuv1 + i + 2)),
+	  _mm_loadu_si128((const __m128i*)(yuv2 + i)),
+	  _mm_loadu_si128((const __m128i*)(yuv2 + i + 1)),
+	  _mm_loadu_si128((const __m128i*)(yuv2 + i + 2))
+	};
+	__m128i p = zero;
+	for (int k = 0; k < 8; k++) {
+	  const __m128i d = _mm_or_si128(_mm_subs_epu8(w[k], w5), _mm_subs_epu8(w5, w[k]));
+	  const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(d, thr), zero);
+	  p = _mm_or_si128(p, _mm_andnot_si128(same, _mm_set1_epi32(1 << k)));
+	}
+	_mm_storeu_si128((__m128i*)(pattern + i), p);
+  }
+#elif defined(HQ4X_NEON)
+  const uint8x16_t thr = vreinterpretq_u8_u32(vdupq_n_u32(trY | trU | trV));
+  for (; i + 4 <= Xres; i += 4) {
+	const uint8x16_t w5 = vreinterpretq_u8_u32(vld1q_u32(yuv1 + i + 1));
+	const uint32 * w[8] = { yuv0 + i, yuv0 + i + 1, yuv0 + i + 2, yuv1 + i, yuv1 + i + 2, yuv2 + i, yuv2 + i + 1, yuv2 + i + 2 };
+	uint32x4_t p = vdupq_n_u32(0);
+	for (int k = 0; k < 8; k++) {
+	  const uint8x16_t d = vabdq_u8(vreinterpretq_u8_u32(vld1q_u32(w[k])), w5);
+	  const uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(d, thr));
+	  p = vorrq_u32(p, vandq_u32(vtstq_u32(over, over), vdupq_n_u32(1u << k)));
+	}
+	vst1q_s32(pattern + i, vreinterpretq_s32_u32(p));
+  }
+#endif
+
+  for (; i < Xres; i++) {
+	const int YUV1 = yuv1[i+1];
+	const int w[8] = { (int)yuv0[i], (int)yuv0[i+1], (int)yuv0[i+2], (int)yuv1[i], (int)yuv1[i+2], (int)yuv2[i], (int)yuv2[i+1], (int)yuv2[i+2] };
+	int p = 0;
+	for (int k = 0; k < 8; k++) {
+	  const int YUV2 = w[k];
+	  if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
+		   ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
+		   ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
+		p |= 1 << k;
+	}
+	pattern[i] = p;
+  }
+}
+
+void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL, int yFirst, int yLast)
 {
 #define hq4x_Interp1 hq4x_Interp1_8888
 #define hq4x_Interp2 hq4x_Interp2_8888
@@ -709,9 +786,6 @@ void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, in
   uint32  c[10];
 
   int pattern;
-  int flag;
-
-  int YUV1, YUV2;
 
   //   +----+----+----+
   //   |    |    |    |
@@ -724,10 +798,30 @@ void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, in
   //   | w7 | w8 | w9 |
   //   +----+----+----+
 
-  for (j = 0; j < Yres; j++) {
+  if (yFirst < 0) yFirst = 0;
+  if (yLast > Yres) yLast = Yres;
+  if (yFirst >= yLast)
+	return;
+
+  /* YUV of the previous, current and next line, converted once per source pixel */
+  std::vector<uint32> yuvBuf((Xres + 2) * 3);
+  std::vector<int> patterns(Xres);
+  uint32 * yuv[3] = { yuvBuf.data(), yuvBuf.data() + Xres + 2, yuvBuf.data() + (Xres + 2) * 2 };
+  const uint32 * src = (const uint32*)pIn;
+
+  hq4x_YUVRow_8888(src + (yFirst > 0 ? yFirst - 1 : 0) * SrcPPL, yuv[0], Xres);
+  hq4x_YUVRow_8888(src + yFirst * SrcPPL, yuv[1], Xres);
+
+  pIn += yFirst * SrcPPL * 4;
+  pOut += yFirst * (16 * SrcPPL + 3 * BpL);
+
+  for (j = yFirst; j < yLast; j++) {
 	if (j>0)      prevline = -SrcPPL*4; else prevline = 0;
 	if (j<Yres-1) nextline =  SrcPPL*4; else nextline = 0;
 
+	hq4x_YUVRow_8888(src + (j < Yres - 1 ? j + 1 : j) * SrcPPL, yuv[2], Xres);
+	hq4x_Patterns_8888(yuv[0], yuv[1], yuv[2], patterns.data(), Xres);
+
 	for (i=0; i<Xres; i++) {
 	  w[2] = *((uint32*)(pIn + prevline));
 	  w[5] = *((uint32*)pIn);
@@ -753,23 +847,7 @@ void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, in
 		w[9] = w[8];
 	  }
 
-	  pattern = 0;
-	  flag = 1;
-
-	  YUV1 = RGB888toYUV(w[5]);
-
-	  for (k=1; k<=9; k++) {
-		if (k==5) continue;
-
-		if ( w[k] != w[5] ) {
-		  YUV2 = RGB888toYUV(w[k]);
-		  if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-			   ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-			   ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-			pattern |= flag;
-		}
-		flag <<= 1;
-	  }
+	  pattern = patterns[i];
 
 	  for (k=1; k<=9; k++)
 		c[k] = w[k];
@@ -785,6 +863,11 @@ void hq4x_8888(unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, in
 	pOut+=BpL;
 	pOut+=BpL;
 	pOut+=BpL;
+
+	uint32 * tmp = yuv[0];
+	yuv[0] = yuv[1];
+	yuv[1] = yuv[2];
+	yuv[2] = tmp;
   }
 
 #undef BPP
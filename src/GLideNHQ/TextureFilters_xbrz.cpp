@@ -18,6 +18,15 @@
 #include <algorithm>
 #include <vector>
 #include <cmath>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XBRZ_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define XBRZ_NEON
+#include <arm_neon.h>
+#endif
 
 namespace
 {
@@ -258,6 +267,114 @@ private:
 	std::vector<float> buffer; //consumes 64 MB memory; using double is only 2% faster, but takes 128 MB
 };
 
+
+//distances of pix1[i] to pix2[i] for i in [0, count), four at a time; returns the number of distances done
+//same math as the DistYCbCrBuffer entries, including their reduced precision, so the results are identical
+//withAlpha: weight them by alpha like ColorDistanceABGR
+template <bool withAlpha>
+int distYCbCrSimd(const uint32_t* pix1, const uint32_t* pix2, int count, double* out)
+{
+	const double k_b = 0.0593;
+	const double k_r = 0.2627;
+	const double k_g = 1 - k_b - k_r;
+
+	const double scale_b = 0.5 / (1 - k_b);
+	const double scale_r = 0.5 / (1 - k_r);
+
+	int i = 0;
+#if defined(XBRZ_SSE2)
+	const __m128i mask = _mm_set1_epi32(0xff);
+	const __m128i c255 = _mm_set1_epi32(255);
+	const __m128i even = _mm_set1_epi32(~1);
+	const __m128d kr = _mm_set1_pd(k_r), kg = _mm_set1_pd(k_g), kb = _mm_set1_pd(k_b);
+	const __m128d sb = _mm_set1_pd(scale_b), sr = _mm_set1_pd(scale_r);
+	const __m128d d255 = _mm_set1_pd(255.0);
+	const __m128d signMask = _mm_set1_pd(-0.0);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pix1 + i));
+		const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pix2 + i));
+
+		//(diff + 255) / 2 * 2 - 255, as the table index drops the lowest bit
+		__m128i diff[3];
+		diff[0] = _mm_sub_epi32(_mm_and_si128(p1, mask), _mm_and_si128(p2, mask));
+		diff[1] = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 8), mask), _mm_and_si128(_mm_srli_epi32(p2, 8), mask));
+		diff[2] = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 16), mask), _mm_and_si128(_mm_srli_epi32(p2, 16), mask));
+		for (int c = 0; c < 3; ++c)
+			diff[c] = _mm_sub_epi32(_mm_and_si128(_mm_add_epi32(diff[c], c255), even), c255);
+
+		const __m128i alpha1 = _mm_srli_epi32(p1, 24);
+		const __m128i alpha2 = _mm_srli_epi32(p2, 24);
+
+		for (int half = 0; half < 2; ++half)
+		{
+			//the table takes byte 2 as its "r_diff" and byte 0 as its "b_diff"
+			const __m128d d_b = _mm_cvtepi32_pd(half == 0 ? diff[0] : _mm_shuffle_epi32(diff[0], _MM_SHUFFLE(3, 2, 3, 2)));
+			const __m128d d_g = _mm_cvtepi32_pd(half == 0 ? diff[1] : _mm_shuffle_epi32(diff[1], _MM_SHUFFLE(3, 2, 3, 2)));
+			const __m128d d_r = _mm_cvtepi32_pd(half == 0 ? diff[2] : _mm_shuffle_epi32(diff[2], _MM_SHUFFLE(3, 2, 3, 2)));
+
+			const __m128d y = _mm_add_pd(_mm_add_pd(_mm_mul_pd(kr, d_r), _mm_mul_pd(kg, d_g)), _mm_mul_pd(kb, d_b));
+			const __m128d c_b = _mm_mul_pd(sb, _mm_sub_pd(d_b, y));
+			const __m128d c_r = _mm_mul_pd(sr, _mm_sub_pd(d_r, y));
+			const __m128d sum = _mm_add_pd(_mm_add_pd(_mm_mul_pd(y, y), _mm_mul_pd(c_b, c_b)), _mm_mul_pd(c_r, c_r));
+			__m128d d = _mm_cvtps_pd(_mm_cvtpd_ps(_mm_sqrt_pd(sum))); //table entries are float
+
+			if (withAlpha)
+			{
+				const __m128d a1 = _mm_div_pd(_mm_cvtepi32_pd(half == 0 ? alpha1 : _mm_shuffle_epi32(alpha1, _MM_SHUFFLE(3, 2, 3, 2))), d255);
+				const __m128d a2 = _mm_div_pd(_mm_cvtepi32_pd(half == 0 ? alpha2 : _mm_shuffle_epi32(alpha2, _MM_SHUFFLE(3, 2, 3, 2))), d255);
+				d = _mm_add_pd(_mm_mul_pd(_mm_min_pd(a1, a2), d), _mm_mul_pd(d255, _mm_andnot_pd(signMask, _mm_sub_pd(a1, a2))));
+			}
+			_mm_storeu_pd(out + i + half * 2, d);
+		}
+	}
+#elif defined(XBRZ_NEON)
+	const uint32x4_t mask = vdupq_n_u32(0xff);
+	const int32x4_t c255 = vdupq_n_s32(255);
+	const int32x4_t even = vdupq_n_s32(~1);
+	const float64x2_t d255 = vdupq_n_f64(255.0);
+	for (; i + 4 <= count; i += 4)
+	{
+		const uint32x4_t p1 = vld1q_u32(pix1 + i);
+		const uint32x4_t p2 = vld1q_u32(pix2 + i);
+
+		//(diff + 255) / 2 * 2 - 255, as the table index drops the lowest bit
+		int32x4_t diff[3];
+		diff[0] = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(p1, mask)), vreinterpretq_s32_u32(vandq_u32(p2, mask)));
+		diff[1] = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p1, 8), mask)), vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p2, 8), mask)));
+		diff[2] = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p1, 16), mask)), vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(p2, 16), mask)));
+		for (int c = 0; c < 3; ++c)
+			diff[c] = vsubq_s32(vandq_s32(vaddq_s32(diff[c], c255), even), c255);
+
+		const uint32x4_t alpha1 = vshrq_n_u32(p1, 24);
+		const uint32x4_t alpha2 = vshrq_n_u32(p2, 24);
+
+		for (int half = 0; half < 2; ++half)
+		{
+			//the table takes byte 2 as its "r_diff" and byte 0 as its "b_diff"
+			const float64x2_t d_b = vcvtq_f64_s64(vmovl_s32(half == 0 ? vget_low_s32(diff[0]) : vget_high_s32(diff[0])));
+			const float64x2_t d_g = vcvtq_f64_s64(vmovl_s32(half == 0 ? vget_low_s32(diff[1]) : vget_high_s32(diff[1])));
+			const float64x2_t d_r = vcvtq_f64_s64(vmovl_s32(half == 0 ? vget_low_s32(diff[2]) : vget_high_s32(diff[2])));
+
+			const float64x2_t y = vaddq_f64(vaddq_f64(vmulq_n_f64(d_r, k_r), vmulq_n_f64(d_g, k_g)), vmulq_n_f64(d_b, k_b));
+			const float64x2_t c_b = vmulq_n_f64(vsubq_f64(d_b, y), scale_b);
+			const float64x2_t c_r = vmulq_n_f64(vsubq_f64(d_r, y), scale_r);
+			const float64x2_t sum = vaddq_f64(vaddq_f64(vmulq_f64(y, y), vmulq_f64(c_b, c_b)), vmulq_f64(c_r, c_r));
+			float64x2_t d = vcvt_f64_f32(vcvt_f32_f64(vsqrtq_f64(sum))); //table entries are float
+
+			if (withAlpha)
+			{
+				const float64x2_t a1 = vdivq_f64(vcvtq_f64_u64(vmovl_u32(half == 0 ? vget_low_u32(alpha1) : vget_high_u32(alpha1))), d255);
+				const float64x2_t a2 = vdivq_f64(vcvtq_f64_u64(vmovl_u32(half == 0 ? vget_low_u32(alpha2) : vget_high_u32(alpha2))), d255);
+				d = vaddq_f64(vmulq_f64(vminq_f64(a1, a2), d), vmulq_f64(d255, vabdq_f64(a1, a2)));
+			}
+			vst1q_f64(out + i + half * 2, d);
+		}
+	}
+#endif
+	return i;
+}
+
 enum BlendType
 {
 	BLEND_NONE = 0,
@@ -295,9 +412,63 @@ input kernel area naming convention:
 | M | N | O | P |
 -----------------
 */
+//distances along the two diagonals between the rows r and r + 1, with the columns clamped at the image border like the kernel's:
+//anti[x] from (x, r + 1) to (x + 1, r), main[x] from (x, r) to (x + 1, r + 1), for x in [-1, srcWidth]
+//computed a row at a time instead of ten times per pixel in preProcessCorners(); keeps the three latest rows
 template <class ColorDistance>
+class DiagonalDist
+{
+public:
+	DiagonalDist(const uint32_t* src, int srcWidth, int srcHeight, const xbrz::ScalerCfg& cfg) :
+		src_(src),
+		srcWidth_(srcWidth),
+		srcHeight_(srcHeight),
+		luminanceWeight_(cfg.luminanceWeight),
+		upper_(srcWidth + 3),
+		lower_(srcWidth + 3),
+		dist_(3 * 2 * (srcWidth + 2))
+	{
+		std::fill(row_, row_ + 3, INT_MIN);
+	}
+
+	const double* anti(int r) { return load(r); }
+	const double* main(int r) { return load(r) + srcWidth_ + 2; }
+
+private:
+	const double* load(int r) //r >= -1
+	{
+		const int slot = (r + 3) % 3;
+		double* dist = &dist_[slot * 2 * (srcWidth_ + 2)];
+		if (row_[slot] != r)
+		{
+			const uint32_t* s_0 = src_ + srcWidth_ * std::min(std::max(r, 0), srcHeight_ - 1);
+			const uint32_t* s_p1 = src_ + srcWidth_ * std::min(r + 1, srcHeight_ - 1);
+			for (int x = -1; x <= srcWidth_ + 1; ++x)
+			{
+				const int x_c = std::min(std::max(x, 0), srcWidth_ - 1);
+				upper_[x + 1] = s_0[x_c];
+				lower_[x + 1] = s_p1[x_c];
+			}
+			ColorDistance::distRow(&lower_[0], &upper_[1], srcWidth_ + 2, dist, luminanceWeight_);
+			ColorDistance::distRow(&upper_[0], &lower_[1], srcWidth_ + 2, dist + srcWidth_ + 2, luminanceWeight_);
+			row_[slot] = r;
+		}
+		return dist + 1;
+	}
+
+	const uint32_t* src_;
+	const int srcWidth_;
+	const int srcHeight_;
+	const double luminanceWeight_;
+	std::vector<uint32_t> upper_;
+	std::vector<uint32_t> lower_;
+	std::vector<double> dist_;
+	int row_[3];
+};
+
+//antiDist[k], mainDist[k]: DiagonalDist rows y - 1 + k for the input pixel at (x, y)
 FORCE_INLINE //detect blend direction
-BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg) //result: F, G, J, K corners of "GradientType"
+BlendResult preProcessCorners(const Kernel_4x4& ker, const double* const antiDist[3], const double* const mainDist[3], int x, const xbrz::ScalerCfg& cfg) //result: F, G, J, K corners of "GradientType"
 {
 	BlendResult result = {};
 
@@ -307,11 +478,11 @@ BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg)
 		ker.g == ker.k))
 		return result;
 
-	auto dist = [&](uint32_t pix1, uint32_t pix2) { return ColorDistance::dist(pix1, pix2, cfg.luminanceWeight); };
-
 	const int weight = 4;
-	double jg = dist(ker.i, ker.f) + dist(ker.f, ker.c) + dist(ker.n, ker.k) + dist(ker.k, ker.h) + weight * dist(ker.j, ker.g);
-	double fk = dist(ker.e, ker.j) + dist(ker.j, ker.o) + dist(ker.b, ker.g) + dist(ker.g, ker.l) + weight * dist(ker.f, ker.k);
+	//dist(i, f) + dist(f, c) + dist(n, k) + dist(k, h) + weight * dist(j, g)
+	double jg = antiDist[1][x - 1] + antiDist[0][x] + antiDist[2][x] + antiDist[1][x + 1] + weight * antiDist[1][x];
+	//dist(e, j) + dist(j, o) + dist(b, g) + dist(g, l) + weight * dist(f, k)
+	double fk = mainDist[1][x - 1] + mainDist[2][x] + mainDist[0][x] + mainDist[1][x + 1] + weight * mainDist[1][x];
 
 	if (jg < fk) //test sample: 70% of values max(jg, fk) / min(jg, fk) are between 1.1 and 3.7 with median being 1.8
 	{
@@ -512,6 +683,8 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 	std::fill(preProcBuffer, preProcBuffer + bufferSize, 0);
 	static_assert(BLEND_NONE == 0, "");
 
+	DiagonalDist<ColorDistance> diagonalDist(src, srcWidth, srcHeight, cfg);
+
 	//initialize preprocessing buffer for first row of current stripe: detect upper left and right corner blending
 	//this cannot be optimized for adjacent processing stripes; we must not allow for a memory race condition!
 	if (yFirst > 0)
@@ -523,6 +696,9 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 		const uint32_t* s_p1 = src + srcWidth * std::min(y + 1, srcHeight - 1);
 		const uint32_t* s_p2 = src + srcWidth * std::min(y + 2, srcHeight - 1);
 
+		const double* const antiDist[3] = { diagonalDist.anti(y - 1), diagonalDist.anti(y), diagonalDist.anti(y + 1) };
+		const double* const mainDist[3] = { diagonalDist.main(y - 1), diagonalDist.main(y), diagonalDist.main(y + 1) };
+
 		for (int x = 0; x < srcWidth; ++x)
 		{
 			const int x_m1 = std::max(x - 1, 0);
@@ -550,7 +726,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 			ker.o = s_p2[x_p1];
 			ker.p = s_p2[x_p2];
 
-			const BlendResult res = preProcessCorners<ColorDistance>(ker, cfg);
+			const BlendResult res = preProcessCorners(ker, antiDist, mainDist, x, cfg);
 			/*
 			preprocessing blend result:
 			---------
@@ -576,6 +752,9 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 		const uint32_t* s_p1 = src + srcWidth * std::min(y + 1, srcHeight - 1);
 		const uint32_t* s_p2 = src + srcWidth * std::min(y + 2, srcHeight - 1);
 
+		const double* const antiDist[3] = { diagonalDist.anti(y - 1), diagonalDist.anti(y), diagonalDist.anti(y + 1) };
+		const double* const mainDist[3] = { diagonalDist.main(y - 1), diagonalDist.main(y), diagonalDist.main(y + 1) };
+
 		unsigned char blend_xy1 = 0; //corner blending for current (x, y + 1) position
 
 		for (int x = 0; x < srcWidth; ++x, out += Scaler::scale)
@@ -613,7 +792,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 			//evaluate the four corners on bottom-right of current pixel
 			unsigned char blend_xy = 0; //for current (x, y) position
 			{
-				const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+				const BlendResult res = preProcessCorners(ker4, antiDist, mainDist, x, cfg);
 				/*
 				preprocessing blend result:
 				---------
@@ -1037,6 +1216,12 @@ struct ColorDistanceBGR
 		//    return 0;
 		//return distYCbCr(pix1, pix2, luminanceWeight);
 	}
+
+	static void distRow(const uint32_t* pix1, const uint32_t* pix2, int count, double* out, double luminanceWeight)
+	{
+		for (int i = distYCbCrSimd<false>(pix1, pix2, count, out); i < count; ++i)
+			out[i] = dist(pix1[i], pix2[i], luminanceWeight);
+	}
 };
 
 struct ColorDistanceABGR
@@ -1063,6 +1248,12 @@ struct ColorDistanceABGR
 
 		//alternative? return std::sqrt(a1 * a2 * square(DistYCbCrBuffer::dist(pix1, pix2)) + square(255 * (a1 - a2)));
 	}
+
+	static void distRow(const uint32_t* pix1, const uint32_t* pix2, int count, double* out, double luminanceWeight)
+	{
+		for (int i = distYCbCrSimd<true>(pix1, pix2, count, out); i < count; ++i)
+			out[i] = dist(pix1[i], pix2[i], luminanceWeight);
+	}
 };
 
 
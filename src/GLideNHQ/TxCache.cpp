@@ -27,6 +27,7 @@
 
 #include "TxCache.h"
 #include "TxDbg.h"
+#include "TxCompress.h"
 #include <osal_files.h>
 #include <zlib.h>
 #include <memory.h>
@@ -36,6 +37,7 @@ TxCache::~TxCache()
 {
 	/* free memory, clean up, etc */
 	clear();
+	delete _file;
 }
 
 TxCache::TxCache(int options, int cachesize, const wchar_t *path, const wchar_t *ident,
@@ -45,6 +47,7 @@ TxCache::TxCache(int options, int cachesize, const wchar_t *path, const wchar_t
 	_cacheSize = cachesize;
 	_callback = callback;
 	_totalSize = 0;
+	_file = nullptr;
 
 	/* save path name */
 	if (path)
@@ -79,18 +82,34 @@ TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 
 	uint8 *dest = info->data;
 	uint32 format = info->format;
+	uint8 *blocks = nullptr;
 
 	if (!dataSize) {
 		dataSize = TxUtil::sizeofTx(info->width, info->height, info->format);
 
 		if (!dataSize) return 0;
 
+		if ((_options & (COMPRESS_TEX|COMPRESS_HIRESTEX)) && format == GL_RGBA8) {
+			/* GPU block compression. the texture stays compressed in memory and in VRAM */
+			blocks = (uint8*)malloc(TxCompress::sizeofBlocks(info->width, info->height, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+			uint16 blockFormat = 0;
+			if (blocks && TxCompress::compress(info->data, info->width, info->height,
+					(_options & ETC2_COMPRESSION) != 0, blocks, &blockFormat)) {
+				DBG_INFO(80, wst("block compressed: gfmt:%x %.02fkb->%.02fkb\n"), blockFormat, (float)dataSize/1000,
+						 (float)TxUtil::sizeofTx(info->width, info->height, blockFormat)/1000);
+				dest = blocks;
+				format = blockFormat;
+				dataSize = TxUtil::sizeofTx(info->width, info->height, blockFormat);
+			}
+		}
+
 		if (_options & (GZ_TEXCACHE|GZ_HIRESTEXCACHE)) {
 			/* zlib compress it. compression level:1 (best speed) */
 			uLongf destLen = _gzdestLen;
-			dest = (dest == _gzdest0) ? _gzdest1 : _gzdest0;
-			if (compress2(dest, &destLen, info->data, dataSize, 1) != Z_OK) {
-				dest = info->data;
+			uint8 *src = dest;
+			dest = (info->data == _gzdest0) ? _gzdest1 : _gzdest0;
+			if (compress2(dest, &destLen, src, dataSize, 1) != Z_OK) {
+				dest = src;
 				DBG_INFO(80, wst("Error: zlib compression failed!\n"));
 			} else {
 				DBG_INFO(80, wst("zlib compressed: %.02fkb->%.02fkb\n"), (float)dataSize/1000, (float)destLen/1000);
@@ -171,18 +190,24 @@ TxCache::add(uint64 checksum, GHQTexInfo *info, int dataSize)
 			/* total cache size */
 			_totalSize += dataSize;
 
+			/* write through to the cache file */
+			if (_file && !_file->contains(checksum))
+				_file->write(checksum, &txCache->info, tmpdata, dataSize);
+
+			free(blocks);
 			return 1;
 		}
 		free(tmpdata);
 	}
 
+	free(blocks);
 	return 0;
 }
 
 boolean
 TxCache::get(uint64 checksum, GHQTexInfo *info)
 {
-	if (!checksum || _cache.empty()) return 0;
+	if (!checksum) return 0;
 
 	/* find a match in cache */
 	std::map<uint64, TXCACHE*>::iterator itMap = _cache.find(checksum);
@@ -213,6 +238,20 @@ TxCache::get(uint64 checksum, GHQTexInfo *info)
 		return 1;
 	}
 
+	/* not in memory. fetch it from the cache file. */
+	if (_file && _file->contains(checksum)) {
+		GHQTexInfo tmpInfo;
+		uint32 dataSize = 0;
+		uint8 *data = _file->read(checksum, &tmpInfo, &dataSize);
+		if (data) {
+			/* entries are stored as they are kept in memory */
+			const boolean added = add(checksum, &tmpInfo, dataSize);
+			free(data);
+			if (added)
+				return get(checksum, info);
+		}
+	}
+
 	return 0;
 }
 
@@ -370,6 +409,21 @@ TxCache::load(const wchar_t *path, const wchar_t *filename, int config)
 	return !_cache.empty();
 }
 
+boolean
+TxCache::openFile(const wchar_t *path, const wchar_t *filename, int config, int hashid)
+{
+	if (!_file)
+		_file = new TxCacheFile();
+
+	if (!_file->open(path, filename, config, hashid)) {
+		delete _file;
+		_file = nullptr;
+		return 0;
+	}
+
+	return 1;
+}
+
 boolean
 TxCache::del(uint64 checksum)
 {
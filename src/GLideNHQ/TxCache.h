@@ -26,6 +26,7 @@
 
 #include "TxInternal.h"
 #include "TxUtil.h"
+#include "TxCacheFile.h"
 #include <list>
 #include <map>
 
@@ -36,6 +37,7 @@ private:
   uint8 *_gzdest0;
   uint8 *_gzdest1;
   uint32 _gzdestLen;
+  TxCacheFile *_file;
 protected:
   int _options;
   tx_wstring _ident;
@@ -51,6 +53,8 @@ protected:
   std::map<uint64, TXCACHE*> _cache;
   boolean save(const wchar_t *path, const wchar_t *filename, const int config);
   boolean load(const wchar_t *path, const wchar_t *filename, const int config);
+  /* back the memory cache by a random access cache file. new entries are written through. */
+  boolean openFile(const wchar_t *path, const wchar_t *filename, const int config, const int hashid);
   boolean del(uint64 checksum); /* checksum hi:palette low:texture */
   boolean is_cached(uint64 checksum); /* checksum hi:palette low:texture */
   void clear();
@@ -0,0 +1,336 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __MSC__
+#pragma warning(disable: 4786)
+#endif
+
+#ifndef WIN32
+/* 64-bit off_t for fseeko/ftello/ftruncate on 32-bit targets */
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "TxCacheFile.h"
+#include "TxDbg.h"
+#include <osal_files.h>
+#include <zlib.h>
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#ifdef WIN32
+#include <io.h>
+#define txfseek _fseeki64
+#define txftell _ftelli64
+#else
+#include <unistd.h>
+#define txfseek fseeko
+#define txftell ftello
+#endif
+
+static int
+txftruncate(FILE *fp, int64 size)
+{
+	fflush(fp);
+#ifdef WIN32
+	return _chsize_s(_fileno(fp), size) == 0 ? 0 : -1;
+#else
+	return ftruncate(fileno(fp), (off_t)size);
+#endif
+}
+
+/* 2: texture checksums from the runtime selected hash backend
+ * 3: id of that hash backend in the header */
+#define TXCACHEFILE_VERSION 3
+
+static const char fileMagic[4] = { 'G', 'H', 'T', 'S' };
+static const char indexMagic[4] = { 'G', 'H', 'T', 'I' };
+static const char chunkEntry[4] = { 'E', 'N', 'T', 'R' };
+static const char chunkIndex[4] = { 'I', 'N', 'D', 'X' };
+
+/* magic, version, config, hash id */
+static const int64 headerSize = 16;
+static const int64 chunkHeaderSize = 8;
+/* checksum, width, height, format, texture_format, pixel_type, is_hires_tex, data crc32 */
+static const uint32 entryHeaderSize = 8 + 4 + 4 + 4 + 2 + 2 + 1 + 4;
+/* INDX chunk offset, magic */
+static const uint32 footerSize = 8 + 4;
+
+TxCacheFile::TxCacheFile() : _fp(nullptr), _fileEnd(0), _dirty(0)
+{
+}
+
+TxCacheFile::~TxCacheFile()
+{
+	close();
+}
+
+boolean
+TxCacheFile::open(const wchar_t *path, const wchar_t *filename, int config, int hashid)
+{
+	close();
+
+	if (!osal_path_existsW(path) && osal_mkdirp(path) != 0)
+		return 0;
+
+	tx_wstring filepath(path);
+	filepath += OSAL_DIR_SEPARATOR_STR;
+	filepath += filename;
+
+#ifdef WIN32
+	_fp = _wfopen(filepath.c_str(), wst("r+b"));
+#else
+	char cbuf[MAX_PATH];
+	wcstombs(cbuf, filepath.c_str(), MAX_PATH);
+	_fp = fopen(cbuf, "r+b");
+#endif
+	if (_fp) {
+		char magic[4];
+		uint32 version = 0;
+		int tmpconfig = 0;
+		int tmphashid = 0;
+		if (fread(magic, 4, 1, _fp) == 1 && memcmp(magic, fileMagic, 4) == 0 &&
+				fread(&version, 4, 1, _fp) == 1 && version == TXCACHEFILE_VERSION &&
+				fread(&tmpconfig, 4, 1, _fp) == 1 && tmpconfig == config &&
+				fread(&tmphashid, 4, 1, _fp) == 1 && tmphashid == hashid) {
+			txfseek(_fp, 0, SEEK_END);
+			_fileEnd = txftell(_fp);
+			if (!readIndex())
+				scanChunks(headerSize);
+
+			DBG_INFO(80, wst("cache file:%ls entries:%d\n"), filename, _index.size());
+			return 1;
+		}
+		/* stale file, or checksums from another hash backend. start over. */
+		DBG_INFO(80, wst("cache file:%ls does not match, discarded\n"), filename);
+		fclose(_fp);
+	}
+
+#ifdef WIN32
+	_fp = _wfopen(filepath.c_str(), wst("w+b"));
+#else
+	_fp = fopen(cbuf, "w+b");
+#endif
+	if (!_fp)
+		return 0;
+
+	const uint32 version = TXCACHEFILE_VERSION;
+	if (fwrite(fileMagic, 4, 1, _fp) != 1 ||
+			fwrite(&version, 4, 1, _fp) != 1 ||
+			fwrite(&config, 4, 1, _fp) != 1 ||
+			fwrite(&hashid, 4, 1, _fp) != 1) {
+		fclose(_fp);
+		_fp = nullptr;
+		return 0;
+	}
+	fflush(_fp);
+	_fileEnd = headerSize;
+
+	return 1;
+}
+
+void
+TxCacheFile::close()
+{
+	if (_fp) {
+		if (_dirty)
+			writeIndex();
+		fclose(_fp);
+		_fp = nullptr;
+	}
+	_index.clear();
+	_fileEnd = 0;
+	_dirty = 0;
+}
+
+boolean
+TxCacheFile::readIndex()
+{
+	if (_fileEnd < headerSize + chunkHeaderSize + 4 + (int64)footerSize)
+		return 0;
+
+	uint64 offset = 0;
+	char magic[4];
+	txfseek(_fp, _fileEnd - footerSize, SEEK_SET);
+	if (fread(&offset, 8, 1, _fp) != 1 || fread(magic, 4, 1, _fp) != 1 || memcmp(magic, indexMagic, 4) != 0)
+		return 0;
+	if (offset < (uint64)headerSize || offset >= (uint64)_fileEnd)
+		return 0;
+
+	char type[4];
+	uint32 size = 0, count = 0;
+	txfseek(_fp, (int64)offset, SEEK_SET);
+	if (fread(type, 4, 1, _fp) != 1 || memcmp(type, chunkIndex, 4) != 0 ||
+			fread(&size, 4, 1, _fp) != 1 || (int64)offset + chunkHeaderSize + (int64)size != _fileEnd ||
+			fread(&count, 4, 1, _fp) != 1)
+		return 0;
+
+	/* count is untrusted. check it against the chunk before sizing anything by it. */
+	if (size < 4 + footerSize || count > (size - 4 - footerSize) / 16 || size != 4 + count * 16 + footerSize)
+		return 0;
+
+	std::vector<uint64> entries(count * 2);
+	if (count != 0 && fread(entries.data(), 16, count, _fp) != count)
+		return 0;
+
+	_index.reserve(count);
+	for (uint32 i = 0; i < count; ++i)
+		_index[entries[i * 2]] = (int64)entries[i * 2 + 1];
+
+	/* new entries go after this index. it is superseded on close. */
+	return 1;
+}
+
+void
+TxCacheFile::scanChunks(int64 offset)
+{
+	_index.clear();
+
+	char type[4];
+	uint32 size;
+	uint64 checksum;
+	while (offset + chunkHeaderSize <= _fileEnd) {
+		txfseek(_fp, offset, SEEK_SET);
+		if (fread(type, 4, 1, _fp) != 1 || fread(&size, 4, 1, _fp) != 1)
+			break;
+		if (offset + chunkHeaderSize + (int64)size > _fileEnd)
+			break; /* torn write */
+		if (memcmp(type, chunkEntry, 4) == 0) {
+			if (size < entryHeaderSize || fread(&checksum, 8, 1, _fp) != 1)
+				break;
+			_index[checksum] = offset;
+		} else if (memcmp(type, chunkIndex, 4) != 0) {
+			break;
+		}
+		offset += chunkHeaderSize + size;
+	}
+
+	DBG_INFO(80, wst("cache file rebuilt index: entries:%d valid:%lld of %lld bytes\n"), _index.size(), (long long)offset, (long long)_fileEnd);
+
+	/* cut off anything past the last good chunk, so the index written on close ends the file */
+	if (offset != _fileEnd && txftruncate(_fp, offset) != 0)
+		DBG_INFO(80, wst("Error: failed to truncate cache file\n"));
+	_fileEnd = offset;
+	_dirty = !_index.empty();
+}
+
+void
+TxCacheFile::writeIndex()
+{
+	const uint32 count = (uint32)_index.size();
+	const uint32 size = 4 + count * 16 + footerSize;
+
+	std::vector<uint64> entries;
+	entries.reserve(count * 2);
+	for (const auto & entry : _index) {
+		entries.push_back(entry.first);
+		entries.push_back((uint64)entry.second);
+	}
+
+	const uint64 offset = (uint64)_fileEnd;
+	txfseek(_fp, _fileEnd, SEEK_SET);
+	fwrite(chunkIndex, 4, 1, _fp);
+	fwrite(&size, 4, 1, _fp);
+	fwrite(&count, 4, 1, _fp);
+	if (count != 0)
+		fwrite(entries.data(), 16, count, _fp);
+	fwrite(&offset, 8, 1, _fp);
+	fwrite(indexMagic, 4, 1, _fp);
+	fflush(_fp);
+
+	_fileEnd += chunkHeaderSize + size;
+	_dirty = 0;
+}
+
+uint8*
+TxCacheFile::read(uint64 checksum, GHQTexInfo *info, uint32 *dataSize)
+{
+	if (!_fp)
+		return nullptr;
+
+	std::unordered_map<uint64, int64>::iterator it = _index.find(checksum);
+	if (it == _index.end())
+		return nullptr;
+
+	char type[4];
+	uint32 size = 0, crc = 0;
+	uint64 tmpchecksum = 0;
+	txfseek(_fp, it->second, SEEK_SET);
+	if (fread(type, 4, 1, _fp) != 1 || memcmp(type, chunkEntry, 4) != 0 ||
+			fread(&size, 4, 1, _fp) != 1 || size < entryHeaderSize ||
+			fread(&tmpchecksum, 8, 1, _fp) != 1 || tmpchecksum != checksum ||
+			fread(&info->width, 4, 1, _fp) != 1 ||
+			fread(&info->height, 4, 1, _fp) != 1 ||
+			fread(&info->format, 4, 1, _fp) != 1 ||
+			fread(&info->texture_format, 2, 1, _fp) != 1 ||
+			fread(&info->pixel_type, 2, 1, _fp) != 1 ||
+			fread(&info->is_hires_tex, 1, 1, _fp) != 1 ||
+			fread(&crc, 4, 1, _fp) != 1) {
+		_index.erase(it);
+		return nullptr;
+	}
+
+	*dataSize = size - entryHeaderSize;
+	uint8 *data = (uint8*)malloc(*dataSize);
+	if (!data)
+		return nullptr;
+
+	if (fread(data, *dataSize, 1, _fp) != 1 || crc32(crc32(0L, Z_NULL, 0), data, *dataSize) != crc) {
+		DBG_INFO(80, wst("Error: corrupted cache file entry crc:%08X %08X\n"), (uint32)(checksum >> 32), (uint32)(checksum & 0xffffffff));
+		free(data);
+		_index.erase(it);
+		return nullptr;
+	}
+
+	info->data = data;
+	return data;
+}
+
+boolean
+TxCacheFile::write(uint64 checksum, const GHQTexInfo *info, const uint8 *data, uint32 dataSize)
+{
+	if (!_fp || !data || !dataSize)
+		return 0;
+
+	const uint32 size = entryHeaderSize + dataSize;
+	const uint32 crc = crc32(crc32(0L, Z_NULL, 0), data, dataSize);
+
+	txfseek(_fp, _fileEnd, SEEK_SET);
+	if (fwrite(chunkEntry, 4, 1, _fp) != 1 ||
+			fwrite(&size, 4, 1, _fp) != 1 ||
+			fwrite(&checksum, 8, 1, _fp) != 1 ||
+			fwrite(&info->width, 4, 1, _fp) != 1 ||
+			fwrite(&info->height, 4, 1, _fp) != 1 ||
+			fwrite(&info->format, 4, 1, _fp) != 1 ||
+			fwrite(&info->texture_format, 2, 1, _fp) != 1 ||
+			fwrite(&info->pixel_type, 2, 1, _fp) != 1 ||
+			fwrite(&info->is_hires_tex, 1, 1, _fp) != 1 ||
+			fwrite(&crc, 4, 1, _fp) != 1 ||
+			fwrite(data, dataSize, 1, _fp) != 1) {
+		DBG_INFO(80, wst("Error: failed to append to cache file\n"));
+		return 0;
+	}
+	fflush(_fp);
+
+	_index[checksum] = _fileEnd;
+	_fileEnd += chunkHeaderSize + size;
+	_dirty = 1;
+
+	return 1;
+}
@@ -0,0 +1,67 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXCACHEFILE_H__
+#define __TXCACHEFILE_H__
+
+#include "TxInternal.h"
+#include <stdio.h>
+#include <unordered_map>
+
+/* Random access texture cache file.
+ *
+ * header : "GHTS" | version | config
+ * chunk  : type | size | payload
+ *   ENTR : checksum | width | height | format | texture_format | pixel_type | is_hires_tex | data crc32 | data
+ *   INDX : count | count * (checksum | chunk offset) | INDX chunk offset | "GHTI"
+ *
+ * Entries are appended as soon as they are added, so the file is valid after a crash.
+ * The index is appended on close. If the file does not end with an index,
+ * it is rebuilt by walking the chunk headers and a torn tail is cut off.
+ * Offsets are 64-bit, so the file may grow past 2 GB.
+ */
+class TxCacheFile
+{
+private:
+  FILE *_fp;
+  int64 _fileEnd;
+  boolean _dirty;
+  std::unordered_map<uint64, int64> _index;
+
+  boolean readIndex();
+  void scanChunks(int64 offset);
+  void writeIndex();
+
+public:
+  TxCacheFile();
+  ~TxCacheFile();
+
+  /* open or create the file. contents are discarded if config or the checksum hash id does not match */
+  boolean open(const wchar_t *path, const wchar_t *filename, int config, int hashid);
+  void close();
+
+  boolean empty() const { return _index.empty(); }
+  boolean contains(uint64 checksum) const { return _index.find(checksum) != _index.end(); }
+
+  /* returns malloc'ed texture data, nullptr on failure */
+  uint8* read(uint64 checksum, GHQTexInfo *info, uint32 *dataSize);
+  boolean write(uint64 checksum, const GHQTexInfo *info, const uint8 *data, uint32 dataSize);
+};
+
+#endif /* __TXCACHEFILE_H__ */
@@ -0,0 +1,344 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <string.h>
+#include "TxCompress.h"
+
+static inline int clamp255(int v)
+{
+	return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static inline uint16 pack565(int r, int g, int b)
+{
+	return (uint16)(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+static inline void unpack565(uint16 c, int *rgb)
+{
+	const int r = (c >> 11) & 0x1f;
+	const int g = (c >> 5) & 0x3f;
+	const int b = c & 0x1f;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+void
+TxCompress::encodeDXT1Block(const uint8 *block, uint8 *dest)
+{
+	/* bounding box of colors, inset by 1/16 to reduce the effect of outliers */
+	int minc[3] = { 255, 255, 255 };
+	int maxc[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 3; ++c) {
+			const int v = block[i * 4 + c];
+			if (v < minc[c]) minc[c] = v;
+			if (v > maxc[c]) maxc[c] = v;
+		}
+	}
+	for (int c = 0; c < 3; ++c) {
+		const int inset = (maxc[c] - minc[c]) >> 4;
+		minc[c] += inset;
+		maxc[c] -= inset;
+	}
+
+	/* select the bbox diagonal which follows the colors distribution */
+	int cov[2] = { 0, 0 };
+	const int center[3] = { (minc[0] + maxc[0]) >> 1, (minc[1] + maxc[1]) >> 1, (minc[2] + maxc[2]) >> 1 };
+	for (int i = 0; i < 16; ++i) {
+		const int r = block[i * 4 + 0] - center[0];
+		cov[0] += r * (block[i * 4 + 1] - center[1]);
+		cov[1] += r * (block[i * 4 + 2] - center[2]);
+	}
+	if (cov[0] < 0) { int t = minc[1]; minc[1] = maxc[1]; maxc[1] = t; }
+	if (cov[1] < 0) { int t = minc[2]; minc[2] = maxc[2]; maxc[2] = t; }
+
+	uint16 c0 = pack565(maxc[0], maxc[1], maxc[2]);
+	uint16 c1 = pack565(minc[0], minc[1], minc[2]);
+	if (c0 < c1) { uint16 t = c0; c0 = c1; c1 = t; }
+
+	uint32 indices = 0;
+	if (c0 != c1) {
+		int palette[4][3];
+		unpack565(c0, palette[0]);
+		unpack565(c1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		for (int i = 15; i >= 0; --i) {
+			int best = 0, bestErr = 0x7fffffff;
+			for (int p = 0; p < 4; ++p) {
+				const int dr = block[i * 4 + 0] - palette[p][0];
+				const int dg = block[i * 4 + 1] - palette[p][1];
+				const int db = block[i * 4 + 2] - palette[p][2];
+				const int err = dr * dr + dg * dg + db * db;
+				if (err < bestErr) { bestErr = err; best = p; }
+			}
+			indices = (indices << 2) | best;
+		}
+	}
+
+	dest[0] = c0 & 0xff; dest[1] = c0 >> 8;
+	dest[2] = c1 & 0xff; dest[3] = c1 >> 8;
+	dest[4] = indices & 0xff; dest[5] = (indices >> 8) & 0xff;
+	dest[6] = (indices >> 16) & 0xff; dest[7] = indices >> 24;
+}
+
+void
+TxCompress::encodeDXT5AlphaBlock(const uint8 *block, uint8 *dest)
+{
+	int a0 = 0, a1 = 255;
+	for (int i = 0; i < 16; ++i) {
+		const int a = block[i * 4 + 3];
+		if (a > a0) a0 = a;
+		if (a < a1) a1 = a;
+	}
+
+	uint64 indices = 0;
+	if (a0 != a1) {
+		/* 8-alpha mode, a0 > a1 */
+		int palette[8];
+		palette[0] = a0;
+		palette[1] = a1;
+		for (int p = 1; p < 7; ++p)
+			palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+		for (int i = 15; i >= 0; --i) {
+			const int a = block[i * 4 + 3];
+			int best = 0, bestErr = 256;
+			for (int p = 0; p < 8; ++p) {
+				const int err = a > palette[p] ? a - palette[p] : palette[p] - a;
+				if (err < bestErr) { bestErr = err; best = p; }
+			}
+			indices = (indices << 3) | (uint64)best;
+		}
+	}
+
+	dest[0] = (uint8)a0;
+	dest[1] = (uint8)a1;
+	for (int i = 0; i < 6; ++i)
+		dest[2 + i] = (uint8)(indices >> (i * 8));
+}
+
+static const int etcModifiers[8][4] = {
+	{ 2, 8, -2, -8 },
+	{ 5, 17, -5, -17 },
+	{ 9, 29, -9, -29 },
+	{ 13, 42, -13, -42 },
+	{ 18, 60, -18, -60 },
+	{ 24, 80, -24, -80 },
+	{ 33, 106, -33, -106 },
+	{ 47, 183, -47, -183 }
+};
+
+/* find the best modifier table for 8 pixels of a sub-block.
+ * returns the error, stores table and per-pixel modifier indices. */
+static int etcFitSubblock(const uint8 *block, const int *pixels, const int *base, int *table, int *modIdx)
+{
+	int bestErr = 0x7fffffff;
+	for (int t = 0; t < 8; ++t) {
+		int err = 0;
+		int idx[8];
+		for (int i = 0; i < 8 && err < bestErr; ++i) {
+			const uint8 *px = block + pixels[i] * 4;
+			int bestPx = 0x7fffffff;
+			for (int m = 0; m < 4; ++m) {
+				const int mod = etcModifiers[t][m];
+				const int dr = px[0] - clamp255(base[0] + mod);
+				const int dg = px[1] - clamp255(base[1] + mod);
+				const int db = px[2] - clamp255(base[2] + mod);
+				const int e = dr * dr + dg * dg + db * db;
+				if (e < bestPx) { bestPx = e; idx[i] = m; }
+			}
+			err += bestPx;
+		}
+		if (err < bestErr) {
+			bestErr = err;
+			*table = t;
+			memcpy(modIdx, idx, sizeof(idx));
+		}
+	}
+	return bestErr;
+}
+
+void
+TxCompress::encodeETC2RGBBlock(const uint8 *block, uint8 *dest)
+{
+	/* pixel i of the block is (x, y) = (i % 4, i / 4); ETC indexes pixels column-major */
+	static const int subblocks[2][2][8] = {
+		/* flip 0: left | right */
+		{ { 0, 4, 8, 12, 1, 5, 9, 13 }, { 2, 6, 10, 14, 3, 7, 11, 15 } },
+		/* flip 1: top / bottom */
+		{ { 0, 1, 2, 3, 4, 5, 6, 7 }, { 8, 9, 10, 11, 12, 13, 14, 15 } }
+	};
+
+	uint32 bestHi = 0, bestLo = 0;
+	int bestErr = 0x7fffffff;
+
+	for (int flip = 0; flip < 2; ++flip) {
+		int avg[2][3];
+		for (int s = 0; s < 2; ++s) {
+			for (int c = 0; c < 3; ++c) {
+				int sum = 0;
+				for (int i = 0; i < 8; ++i)
+					sum += block[subblocks[flip][s][i] * 4 + c];
+				avg[s][c] = (sum + 4) >> 3;
+			}
+		}
+
+		/* differential mode if 5-bit colors are close enough, individual 4-bit mode otherwise */
+		int q[2][3], base[2][3];
+		boolean diff = 1;
+		for (int s = 0; s < 2; ++s)
+			for (int c = 0; c < 3; ++c)
+				q[s][c] = (avg[s][c] * 31 + 127) / 255;
+		for (int c = 0; c < 3; ++c) {
+			const int d = q[1][c] - q[0][c];
+			if (d < -4 || d > 3)
+				diff = 0;
+		}
+		if (!diff) {
+			for (int s = 0; s < 2; ++s)
+				for (int c = 0; c < 3; ++c) {
+					q[s][c] = (avg[s][c] * 15 + 127) / 255;
+					base[s][c] = (q[s][c] << 4) | q[s][c];
+				}
+		} else {
+			for (int s = 0; s < 2; ++s)
+				for (int c = 0; c < 3; ++c)
+					base[s][c] = (q[s][c] << 3) | (q[s][c] >> 2);
+		}
+
+		int table[2], modIdx[2][8];
+		int err = 0;
+		for (int s = 0; s < 2; ++s)
+			err += etcFitSubblock(block, subblocks[flip][s], base[s], &table[s], modIdx[s]);
+		if (err >= bestErr)
+			continue;
+		bestErr = err;
+
+		uint32 hi = 0;
+		if (diff) {
+			for (int c = 0; c < 3; ++c)
+				hi |= (uint32)((q[0][c] << 3) | ((q[1][c] - q[0][c]) & 7)) << (24 - c * 8);
+		} else {
+			for (int c = 0; c < 3; ++c)
+				hi |= (uint32)((q[0][c] << 4) | q[1][c]) << (24 - c * 8);
+		}
+		hi |= (uint32)table[0] << 5 | (uint32)table[1] << 2 | (uint32)diff << 1 | (uint32)flip;
+
+		/* modifier index m is stored as msb:lsb, 0:+a 1:+b 2:-a 3:-b */
+		uint32 lo = 0;
+		for (int s = 0; s < 2; ++s) {
+			for (int i = 0; i < 8; ++i) {
+				const int p = subblocks[flip][s][i];
+				const int bit = (p & 3) * 4 + (p >> 2);
+				const int m = modIdx[s][i];
+				lo |= (uint32)(m >> 1) << (16 + bit);
+				lo |= (uint32)(m & 1) << bit;
+			}
+		}
+		bestHi = hi;
+		bestLo = lo;
+	}
+
+	for (int i = 0; i < 4; ++i) {
+		dest[i] = (uint8)(bestHi >> (24 - i * 8));
+		dest[4 + i] = (uint8)(bestLo >> (24 - i * 8));
+	}
+}
+
+boolean
+TxCompress::isCompressed(uint16 format)
+{
+	switch (format) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RGB8_ETC2:
+		return 1;
+	}
+	return 0;
+}
+
+int
+TxCompress::sizeofBlocks(int width, int height, uint16 format)
+{
+	const int blocks = ((width + 3) >> 2) * ((height + 3) >> 2);
+	switch (format) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGB8_ETC2:
+		return blocks << 3;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		return blocks << 4;
+	}
+	return 0;
+}
+
+boolean
+TxCompress::compress(const uint8 *src, int width, int height, boolean etc2,
+					 uint8 *dest, uint16 *destformat)
+{
+	if (!src || !dest || width <= 0 || height <= 0)
+		return 0;
+
+	boolean opaque = 1;
+	const int numPixels = width * height;
+	for (int i = 0; i < numPixels && opaque; ++i)
+		opaque = src[i * 4 + 3] == 0xff;
+
+	if (etc2) {
+		if (!opaque)
+			return 0;
+		*destformat = GL_COMPRESSED_RGB8_ETC2;
+	} else
+		*destformat = opaque ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+	uint8 block[64];
+	for (int by = 0; by < height; by += 4) {
+		for (int bx = 0; bx < width; bx += 4) {
+			/* replicate edge pixels for partial blocks */
+			for (int y = 0; y < 4; ++y) {
+				const int sy = (by + y < height) ? by + y : height - 1;
+				for (int x = 0; x < 4; ++x) {
+					const int sx = (bx + x < width) ? bx + x : width - 1;
+					memcpy(block + (y * 4 + x) * 4, src + (sy * width + sx) * 4, 4);
+				}
+			}
+
+			switch (*destformat) {
+			case GL_COMPRESSED_RGB8_ETC2:
+				encodeETC2RGBBlock(block, dest);
+				dest += 8;
+			break;
+			case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+				encodeDXT1Block(block, dest);
+				dest += 8;
+			break;
+			case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+				encodeDXT5AlphaBlock(block, dest);
+				encodeDXT1Block(block, dest + 8);
+				dest += 16;
+			break;
+			}
+		}
+	}
+
+	return 1;
+}
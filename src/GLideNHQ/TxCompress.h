@@ -0,0 +1,50 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXCOMPRESS_H__
+#define __TXCOMPRESS_H__
+
+#include "TxInternal.h"
+#include "TxUtil.h"
+
+/* Encoder of GL_RGBA8 textures to GPU block compressed formats.
+ * S3TC: DXT1 for opaque textures, DXT5 otherwise.
+ * ETC2: RGB8 (ETC1 compatible) for opaque textures only.
+ */
+class TxCompress
+{
+private:
+  static void encodeDXT1Block(const uint8 *block, uint8 *dest);
+  static void encodeDXT5AlphaBlock(const uint8 *block, uint8 *dest);
+  static void encodeETC2RGBBlock(const uint8 *block, uint8 *dest);
+
+public:
+  /* returns 1 if format is one of the block compressed formats */
+  static boolean isCompressed(uint16 format);
+
+  /* size of compressed data in bytes */
+  static int sizeofBlocks(int width, int height, uint16 format);
+
+  /* dest must hold at least sizeofBlocks(width, height, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) bytes.
+   * returns 0 if texture can't be compressed with requested codec. */
+  static boolean compress(const uint8 *src, int width, int height, boolean etc2,
+                          uint8 *dest, uint16 *destformat);
+};
+
+#endif /* __TXCOMPRESS_H__ */
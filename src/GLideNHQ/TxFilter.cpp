@@ -26,12 +26,12 @@
 #endif
 
 #include <functional>
-#include <thread>
 #include <stdlib.h>
 
 #include <osal_files.h>
 #include "TxFilter.h"
 #include "TextureFilters.h"
+#include "TxThreadPool.h"
 #include "TxDbg.h"
 #include "bldno.h"
 
@@ -43,6 +43,9 @@ void TxFilter::clear()
 	/* clear texture cache */
 	delete _txTexCache;
 
+	/* stop worker threads */
+	TxThreadPool::getInstance()->shutdown();
+
 	/* free memory */
 	TxMemBuf::getInstance()->shutdown();
 
@@ -57,7 +60,7 @@ TxFilter::~TxFilter()
 }
 
 TxFilter::TxFilter(int maxwidth, int maxheight, int maxbpp, int options,
-	int cachesize, const wchar_t * path, const wchar_t * texPackPath, const wchar_t * ident,
+	int cachesize, int hirescachesize, int hashid, const wchar_t * path, const wchar_t * texPackPath, const wchar_t * ident,
 				   dispInfoFuncExt callback) :
 	_tex1(nullptr), _tex2(nullptr), _txQuantize(nullptr), _txTexCache(nullptr), _txHiResCache(nullptr), _txImage(nullptr)
 {
@@ -128,11 +131,11 @@ TxFilter::TxFilter(int maxwidth, int maxheight, int maxbpp, int options,
 #endif
 
 	/* initialize texture cache in bytes. 128Mb will do nicely in most cases */
-	_txTexCache = new TxTexCache(_options, _cacheSize, _path.c_str(), _ident.c_str(), callback);
+	_txTexCache = new TxTexCache(_options, _cacheSize, hashid, _path.c_str(), _ident.c_str(), callback);
 
 	/* hires texture */
 #if HIRES_TEXTURE
-	_txHiResCache = new TxHiResCache(_maxwidth, _maxheight, _maxbpp, _options, _path.c_str(), texPackPath, _ident.c_str(), callback);
+	_txHiResCache = new TxHiResCache(_maxwidth, _maxheight, _maxbpp, _options, hirescachesize, _path.c_str(), texPackPath, _ident.c_str(), callback);
 
 	if (_txHiResCache->empty())
 		_options &= ~HIRESTEXTURES_MASK;
@@ -298,34 +301,23 @@ TxFilter::filter(uint8 *src, int srcwidth, int srcheight, uint16 srcformat, uint
 					blkrow = (srcheight >> 2) / numcore;
 					numcore--;
 				}
-				if (blkrow > 0 && numcore > 1) {
-					std::thread *thrd[MAX_NUMCORE];
-					unsigned int i;
-					int blkheight = blkrow << 2;
-					unsigned int srcStride = (srcwidth * blkheight) << 2;
-					unsigned int destStride = srcStride * scale * scale;
-					for (i = 0; i < numcore - 1; i++) {
-						thrd[i] = new std::thread(std::bind(filter_8888,
-																(uint32*)_texture,
-																srcwidth,
-																blkheight,
-																(uint32*)_tmptex,
-																filter,
-																i));
-						_texture += srcStride;
-						_tmptex  += destStride;
-					}
-					thrd[i] = new std::thread(std::bind(filter_8888,
-															(uint32*)_texture,
-															srcwidth,
-															srcheight - blkheight * i,
-															(uint32*)_tmptex,
-															filter,
-															i));
-					for (i = 0; i < numcore; i++) {
-						thrd[i]->join();
-						delete thrd[i];
-					}
+				if (filter_8888_sliceable(filter)) {
+					filter_8888_sliced((uint32*)_texture, srcwidth, srcheight, (uint32*)_tmptex, filter);
+				} else if (blkrow > 0 && numcore > 1) {
+					const unsigned int blkheight = blkrow << 2;
+					const unsigned int srcStride = (srcwidth * blkheight) << 2;
+					const unsigned int destStride = srcStride * scale * scale;
+					const unsigned int width = srcwidth;
+					const unsigned int height = srcheight;
+					const unsigned int numblk = numcore;
+					TxThreadPool::getInstance()->parallelFor(numblk, [=](uint32 i) {
+						filter_8888((uint32*)(_texture + srcStride * i),
+									width,
+									i < numblk - 1 ? blkheight : height - blkheight * i,
+									(uint32*)(_tmptex + destStride * i),
+									filter,
+									i);
+					});
 				} else {
 					filter_8888((uint32*)_texture, srcwidth, srcheight, (uint32*)_tmptex, filter, 0);
 				}
@@ -444,7 +436,10 @@ TxFilter::filter(uint8 *src, int srcwidth, int srcheight, uint16 srcformat, uint
 	setTextureFormat(destformat, info);
 
 	/* cache the texture. */
-	if (_cacheSize) _txTexCache->add(g64crc, info);
+	if (_cacheSize && _txTexCache->add(g64crc, info) && (_options & COMPRESS_TEX)) {
+		/* hand out the block compressed copy so that the first upload is compressed too */
+		_txTexCache->get(g64crc, info);
+	}
 
 	DBG_INFO(80, wst("filtered texture: %d x %d gfmt:%x\n"), info->width, info->height, info->format);
 
@@ -638,3 +633,14 @@ TxFilter::reloadhirestex()
 
 	return 0;
 }
+
+boolean
+TxFilter::hirestexpending(uint64 r_crc64)
+{
+#if HIRES_TEXTURE
+	if ((_options & HIRESTEXTURES_MASK) && r_crc64)
+		return _txHiResCache->pending(r_crc64) || _txHiResCache->pending(r_crc64 & 0xffffffff);
+#endif
+
+	return 0;
+}
@@ -58,6 +58,8 @@ public:
 		   int maxbpp,
 		   int options,
 		   int cachesize,
+		   int hirescachesize,
+		   int hashid, /* hash behind the g64crc checksums */
 		   const wchar_t *path,
 		   const wchar_t * texPackPath,
 		   const wchar_t *ident,
@@ -75,6 +77,7 @@ public:
   uint64 checksum64(uint8 *src, int width, int height, int size, int rowStride, uint8 *palette);
   boolean dmptx(uint8 *src, int width, int height, int rowStridePixel, uint16 gfmt, uint16 n64fmt, uint64 r_crc64);
   boolean reloadhirestex();
+  boolean hirestexpending(uint64 r_crc64);
 };
 
 #endif /* __TXFILTER_H__ */
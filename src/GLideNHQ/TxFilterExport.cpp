@@ -34,13 +34,13 @@ extern "C"{
 #endif
 
 TAPI boolean TAPIENTRY
-txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize, int hirescachesize, int hashid,
 	const wchar_t * path, const wchar_t * texPackPath, const wchar_t * ident,
 	dispInfoFuncExt callback)
 {
   if (txFilter) return 0;
 
-  txFilter = new TxFilter(maxwidth, maxheight, maxbpp, options, cachesize,
+  txFilter = new TxFilter(maxwidth, maxheight, maxbpp, options, cachesize, hirescachesize, hashid,
 	  path, texPackPath, ident, callback);
 
   return (txFilter ? 1 : 0);
@@ -101,6 +101,15 @@ txfilter_reloadhirestex()
   return 0;
 }
 
+TAPI boolean TAPIENTRY
+txfilter_hirestexpending(uint64 r_crc64)
+{
+  if (txFilter)
+	return txFilter->hirestexpending(r_crc64);
+
+  return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
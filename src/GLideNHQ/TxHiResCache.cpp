@@ -52,9 +52,13 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include "TxThreadPool.h"
 
 TxHiResCache::~TxHiResCache()
 {
+  stopStream();
+
 #if DUMP_CACHE
   if ((_options & DUMP_HIRESTEXCACHE) && !_haveCache && !_abortLoad) {
 	/* dump cache to disk */
@@ -63,7 +67,7 @@ TxHiResCache::~TxHiResCache()
 	tx_wstring cachepath(_path);
 	cachepath += OSAL_DIR_SEPARATOR_STR;
 	cachepath += wst("cache");
-	int config = _options & (HIRESTEXTURES_MASK|TILE_HIRESTEX|FORCE16BPP_HIRESTEX|GZ_HIRESTEXCACHE|LET_TEXARTISTS_FLY);
+	int config = _options & (HIRESTEXTURES_MASK|TILE_HIRESTEX|FORCE16BPP_HIRESTEX|GZ_HIRESTEXCACHE|LET_TEXARTISTS_FLY|COMPRESS_HIRESTEX|ETC2_COMPRESSION);
 
 	TxCache::save(cachepath.c_str(), filename.c_str(), config);
   }
@@ -74,10 +78,11 @@ TxHiResCache::~TxHiResCache()
   delete _txReSample;
 }
 
-TxHiResCache::TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options,
+TxHiResCache::TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
 	const wchar_t *cachePath, const wchar_t *texPackPath, const wchar_t *ident,
 	dispInfoFuncExt callback
-	) : TxCache((options & ~GZ_TEXCACHE), 0, cachePath, ident, callback)
+	) : TxCache((options & ~(GZ_TEXCACHE | COMPRESS_TEX)), (options & STREAM_HIRESTEX) ? cachesize : 0, cachePath, ident, callback)
+	, _streamLoads(0), _streamCancel(0)
 {
   _txImage = new TxImage();
   _txQuantize  = new TxQuantize();
@@ -92,6 +97,10 @@ TxHiResCache::TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options,
   if (texPackPath)
 	  _texPackPath.assign(texPackPath);
 
+  /* a streamed cache never holds the whole pack */
+  if (_options & STREAM_HIRESTEX)
+	_options &= ~DUMP_HIRESTEXCACHE;
+
   if (_path.empty() || _ident.empty()) {
 	_options &= ~DUMP_HIRESTEXCACHE;
 	return;
@@ -106,7 +115,7 @@ TxHiResCache::TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options,
 	tx_wstring cachepath(_path);
 	cachepath += OSAL_DIR_SEPARATOR_STR;
 	cachepath += wst("cache");
-	int config = _options & (HIRESTEXTURES_MASK|TILE_HIRESTEX|FORCE16BPP_HIRESTEX|GZ_HIRESTEXCACHE|LET_TEXARTISTS_FLY);
+	int config = _options & (HIRESTEXTURES_MASK|TILE_HIRESTEX|FORCE16BPP_HIRESTEX|GZ_HIRESTEXCACHE|LET_TEXARTISTS_FLY|COMPRESS_HIRESTEX|ETC2_COMPRESSION);
 
 	_haveCache = TxCache::load(cachepath.c_str(), filename.c_str(), config);
   }
@@ -119,7 +128,109 @@ TxHiResCache::TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options,
 boolean
 TxHiResCache::empty()
 {
-  return _cache.empty();
+  return _cache.empty() && _index.empty();
+}
+
+boolean
+TxHiResCache::get(uint64 checksum, GHQTexInfo *info)
+{
+  if (!(_options & STREAM_HIRESTEX))
+	return TxCache::get(checksum, info);
+
+  flushStream();
+
+  if (TxCache::get(checksum, info))
+	return 1;
+
+  /* decode it in the background. the caller uses the native texture meanwhile. */
+  std::unordered_map<uint64, HiResFile>::const_iterator it = _index.find(checksum);
+  if (it != _index.end() && _pending.insert(checksum).second)
+	streamTexture(it->second);
+
+  return 0;
+}
+
+boolean
+TxHiResCache::pending(uint64 checksum)
+{
+  if (_pending.empty())
+	return 0;
+
+  flushStream();
+
+  return _pending.find(checksum) != _pending.end();
+}
+
+void
+TxHiResCache::streamTexture(const HiResFile &file)
+{
+  {
+	std::lock_guard<std::mutex> lock(_streamMutex);
+	++_streamLoads;
+  }
+
+  TxThreadPool::getInstance()->post([this, file]() {
+	StreamedTexture texture;
+	texture.chksum64 = file.chksum64;
+	{
+	  std::lock_guard<std::mutex> lock(_streamMutex);
+	  if (_streamCancel)
+		texture.chksum64 = 0;
+	}
+	if (texture.chksum64)
+	  loadHiResTexture(file, &texture.info);
+
+	std::lock_guard<std::mutex> lock(_streamMutex);
+	if (texture.chksum64 && !_streamCancel)
+	  _streamed.push_back(texture);
+	else
+	  free(texture.info.data);
+	if (--_streamLoads == 0)
+	  _streamCv.notify_all();
+  });
+}
+
+/* move the textures decoded by the loader threads into the cache.
+ * the cache size limit evicts the least recently used ones. */
+void
+TxHiResCache::flushStream()
+{
+  std::vector<StreamedTexture> streamed;
+  {
+	std::lock_guard<std::mutex> lock(_streamMutex);
+	if (_streamed.empty())
+	  return;
+	streamed.swap(_streamed);
+  }
+
+  for (StreamedTexture &texture : streamed) {
+	_pending.erase(texture.chksum64);
+	if (!texture.info.data) {
+	  /* broken file. do not try again. */
+	  _index.erase(texture.chksum64);
+	  continue;
+	}
+	if (TxCache::add(texture.chksum64, &texture.info)) {
+	  DBG_INFO(80, wst("streamed: chksum:%08X %08X total mem:%.2fmb\n"),
+			   (uint32)(texture.chksum64 & 0xffffffff), (uint32)(texture.chksum64 >> 32), (float)_totalSize/1000000);
+	}
+	free(texture.info.data);
+  }
+}
+
+/* drop queued loads and wait for the running ones */
+void
+TxHiResCache::stopStream()
+{
+  std::unique_lock<std::mutex> lock(_streamMutex);
+  _streamCancel = 1;
+  _streamCv.wait(lock, [this]{ return _streamLoads == 0; });
+  _streamCancel = 0;
+
+  for (StreamedTexture &texture : _streamed)
+	free(texture.info.data);
+  _streamed.clear();
+  _pending.clear();
 }
 
 boolean
@@ -127,7 +238,11 @@ TxHiResCache::load(boolean replace) /* 0 : reload, 1 : replace partial */
 {
   if (!_texPackPath.empty() && !_ident.empty()) {
 
-	if (!replace) TxCache::clear();
+	stopStream();
+	if (!replace) {
+	  TxCache::clear();
+	  _index.clear();
+	}
 
 	tx_wstring dir_path(_texPackPath);
 
@@ -161,6 +276,57 @@ TxHiResCache::load(boolean replace) /* 0 : reload, 1 : replace partial */
   return 0;
 }
 
+/* open a file of the texture pack. the full path is used, so loader threads do not depend on the current directory */
+static FILE *
+openTexFile(const tx_wstring &dir, const char *fname)
+{
+#ifdef WIN32
+  wchar_t wname[MAX_PATH];
+  mbstowcs(wname, fname, MAX_PATH);
+  tx_wstring path(dir);
+  path += OSAL_DIR_SEPARATOR_STR;
+  path += wname;
+  return _wfopen(path.c_str(), wst("rb"));
+#else
+  char cbuf[MAX_PATH];
+  wcstombs(cbuf, dir.c_str(), MAX_PATH);
+  std::string path(cbuf);
+  path += '/';
+  path += fname;
+  return fopen(path.c_str(), "rb");
+#endif
+}
+
+static boolean
+texFileExists(const tx_wstring &dir, const char *fname)
+{
+  FILE *fp = openTexFile(dir, fname);
+  if (!fp)
+	return 0;
+  fclose(fp);
+  return 1;
+}
+
+/* _all.png, _all.dds, _allciByRGBA.png, _allciByRGBA.dds, _ciByRGBA.png, _ciByRGBA.dds, _ci.bmp */
+static boolean
+isSingleFileTexture(const char *fname, const char *pfname)
+{
+  return (pfname == strstr(fname, "_all.png") ||
+	  pfname == strstr(fname, "_all.dds") ||
+#ifdef WIN32
+	  pfname == strstr(fname, "_allcibyrgba.png") ||
+	  pfname == strstr(fname, "_allcibyrgba.dds") ||
+	  pfname == strstr(fname, "_cibyrgba.png") ||
+	  pfname == strstr(fname, "_cibyrgba.dds") ||
+#else
+	  pfname == strstr(fname, "_allciByRGBA.png") ||
+	  pfname == strstr(fname, "_allciByRGBA.dds") ||
+	  pfname == strstr(fname, "_ciByRGBA.png") ||
+	  pfname == strstr(fname, "_ciByRGBA.dds") ||
+#endif
+	  pfname == strstr(fname, "_ci.bmp"));
+}
+
 boolean
 TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 {
@@ -173,29 +339,28 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	return 0;
   }
 
-  /* XXX: deal with UNICODE fiasco!
-   * stupidity flows forth beneath this...
-   *
-   * I opted to use chdir in order to use fopen() for windows 9x.
-   */
-#ifdef WIN32
-  wchar_t curpath[MAX_PATH];
-  GETCWD(MAX_PATH, curpath);
-  CHDIR(dir_path);
-#else
-  char curpath[MAX_PATH];
-  char cbuf[MAX_PATH];
-  wcstombs(cbuf, dir_path, MAX_PATH);
-  GETCWD(MAX_PATH, curpath);
-  CHDIR(cbuf);
-#endif
+  /* list the textures first, then decode them on all cores.
+   * each batch is added to the cache in the order the files were found. */
+  std::vector<HiResFile> files;
+  std::unordered_set<uint64> found;
+  findHiResTextures(dir_path, replace, files, found);
+
+  if (_options & STREAM_HIRESTEX) {
+	/* only remember where the textures are. they are decoded on first use. */
+	for (const HiResFile &file : files) {
+	  if (replace) TxCache::del(file.chksum64);
+	  _index[file.chksum64] = file;
+	}
+	if (_callback) (*_callback)(wst("[%d] hiresolution textures found\n"), _index.size());
+	INFO(80, wst("%d hiresolution textures found. streaming enabled.\n"), _index.size());
+	return 1;
+  }
 
-  void *dir = osal_search_dir_open(dir_path);
-  const wchar_t *foundfilename;
-  // the path of the texture
-  tx_wstring texturefilename;
+  TxThreadPool *pool = TxThreadPool::getInstance();
+  const size_t batchSize = pool->concurrency() * 4;
+  std::vector<GHQTexInfo> batch;
 
-  do {
+  for (size_t first = 0; first < files.size(); first += batchSize) {
 
 	if (KBHIT(0x1B)) {
 	  _abortLoad = 1;
@@ -204,6 +369,69 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	}
 	if (_abortLoad) break;
 
+	const size_t count = std::min(batchSize, files.size() - first);
+	batch.assign(count, GHQTexInfo());
+	pool->parallelFor((uint32)count, [&](uint32 i) {
+	  loadHiResTexture(files[first + i], &batch[i]);
+	});
+
+	for (size_t i = 0; i < count; ++i) {
+	  const HiResFile &file = files[first + i];
+	  GHQTexInfo &tmpInfo = batch[i];
+	  if (!tmpInfo.data)
+		continue;
+
+	  /* load it into hires texture cache. */
+
+	  /* remove redundant in cache */
+	  if (replace && TxCache::del(file.chksum64)) {
+		DBG_INFO(80, wst("removed duplicate old cache.\n"));
+	  }
+
+	  /* add to cache */
+	  if (TxCache::add(file.chksum64, &tmpInfo)) {
+		/* Callback to display hires texture info.
+		 * Gonetz <gonetz(at)ngs.ru> */
+		if (_callback) {
+		  wchar_t tmpbuf[MAX_PATH];
+		  mbstowcs(tmpbuf, file.name.c_str(), MAX_PATH);
+		  (*_callback)(wst("[%d] total mem:%.2fmb - %ls\n"), _cache.size(), (float)_totalSize/1000000, tmpbuf);
+		}
+		DBG_INFO(80, wst("texture loaded!\n"));
+	  }
+	  free(tmpInfo.data);
+	  tmpInfo.data = nullptr;
+	}
+  }
+
+  for (GHQTexInfo &tmpInfo : batch)
+	free(tmpInfo.data);
+
+  return 1;
+}
+
+void
+TxHiResCache::findHiResTextures(const wchar_t * dir_path, boolean replace, std::vector<HiResFile> &files, std::unordered_set<uint64> &found)
+{
+  void *dir = osal_search_dir_open(dir_path);
+  const wchar_t *foundfilename;
+  // the path of the texture
+  tx_wstring texturefilename;
+
+  char fname[MAX_PATH];
+  wcstombs(fname, _ident.c_str(), MAX_PATH);
+  /* XXX case sensitivity fiasco!
+   * files must use _a, _rgb, _all, _allciByRGBA, _ciByRGBA, _ci
+   * and file extensions must be in lower case letters! */
+#ifdef WIN32
+  {
+	unsigned int i;
+	for (i = 0; i < strlen(fname); i++) fname[i] = tolower(fname[i]);
+  }
+#endif
+  const std::string ident(fname);
+
+  do {
 	foundfilename = osal_search_dir_read_next(dir);
 	// The array is empty,  break the current operation
 	if (foundfilename == nullptr)
@@ -218,39 +446,17 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 
 	/* recursive read into sub-directory */
 	if (osal_is_directory(texturefilename.c_str())) {
-		loadHiResTextures(texturefilename.c_str(), replace);
+	  findHiResTextures(texturefilename.c_str(), replace, files, found);
 	  continue;
 	}
 
 	DBG_INFO(80, wst("-----\n"));
 	DBG_INFO(80, wst("file: %ls\n"), foundfilename);
 
-	int width = 0, height = 0;
-	uint16 format = 0;
-	uint8 *tex = nullptr;
-	int tmpwidth = 0, tmpheight = 0;
-	uint16 tmpformat = 0;
-	uint8 *tmptex= nullptr;
-	uint16 destformat = 0;
-
 	/* Rice hi-res textures: begin
 	 */
 	uint32 chksum = 0, fmt = 0, siz = 0, palchksum = 0;
-	char *pfname = nullptr, fname[MAX_PATH];
-	std::string ident;
-	FILE *fp = nullptr;
-
-	wcstombs(fname, _ident.c_str(), MAX_PATH);
-	/* XXX case sensitivity fiasco!
-	 * files must use _a, _rgb, _all, _allciByRGBA, _ciByRGBA, _ci
-	 * and file extensions must be in lower case letters! */
-#ifdef WIN32
-	{
-	  unsigned int i;
-	  for (i = 0; i < strlen(fname); i++) fname[i] = tolower(fname[i]);
-	}
-#endif
-	ident.assign(fname);
+	char *pfname = nullptr;
 
 	/* read in Rice's file naming convention */
 #define CRCFMTSIZ_LEN 13
@@ -269,11 +475,6 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 	if (!(pfname == strstr(fname, ".png") ||
 		  pfname == strstr(fname, ".bmp") ||
 		  pfname == strstr(fname, ".dds"))) {
-#if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
-#endif
 	  INFO(80, wst("Error: not png or bmp or dds!\n"));
 	  continue;
 	}
@@ -288,35 +489,26 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 		pfname = 0;
 	}
 	if (!pfname) {
-#if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n", dir_path));
-	  INFO(80, wst("file: %ls\n", foundfilename));
-#endif
 	  INFO(80, wst("Error: not Rice texture naming convention!\n"));
 	  continue;
 	}
 	if (!chksum) {
-#if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
-#endif
 	  INFO(80, wst("Error: crc32 = 0!\n"));
 	  continue;
 	}
+	if (!(pfname == strstr(fname, "_rgb.") || pfname == strstr(fname, "_a.") || isSingleFileTexture(fname, pfname))) {
+	  INFO(80, wst("Error: load failed!\n"));
+	  continue;
+	}
 
-	/* check if we already have it in hires texture cache */
+	uint64 chksum64 = (uint64)palchksum;
+	chksum64 <<= 32;
+	chksum64 |= (uint64)chksum;
+
+	/* check if we already have it in hires texture cache.
+	 * this also drops the second file of an _rgb.* and _a.* pair */
 	if (!replace) {
-	  uint64 chksum64 = (uint64)palchksum;
-	  chksum64 <<= 32;
-	  chksum64 |= (uint64)chksum;
-	  if (TxCache::is_cached(chksum64)) {
-#if !DEBUG
-		INFO(80, wst("-----\n"));
-		INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-		INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
-#endif
+	  if (TxCache::is_cached(chksum64) || !found.insert(chksum64).second) {
 		INFO(80, wst("Error: already cached! duplicate texture!\n"));
 		continue;
 	  }
@@ -324,445 +516,434 @@ TxHiResCache::loadHiResTextures(const wchar_t * dir_path, boolean replace)
 
 	DBG_INFO(80, wst("rom: %ls chksum:%08X %08X fmt:%x size:%x\n"), _ident.c_str(), chksum, palchksum, fmt, siz);
 
-	/* Deal with the wackiness some texture packs utilize Rice format.
-	 * Read in the following order: _a.* + _rgb.*, _all.png _ciByRGBA.png,
-	 * _allciByRGBA.png, and _ci.bmp. PNG are prefered over BMP.
-	 *
-	 * For some reason there are texture packs that include them all. Some
-	 * even have RGB textures named as _all.* and ARGB textures named as
-	 * _rgb.*... Someone pleeeez write a GOOD guideline for the texture
-	 * designers!!!
-	 *
-	 * We allow hires textures to have higher bpp than the N64 originals.
-	 */
-	/* N64 formats
-	 * Format: 0 - RGBA, 1 - YUV, 2 - CI, 3 - IA, 4 - I
-	 * Size:   0 - 4bit, 1 - 8bit, 2 - 16bit, 3 - 32 bit
-	 */
+	HiResFile file;
+	file.dir.assign(dir_path);
+	file.name.assign(fname);
+	file.suffix = pfname - fname;
+	file.chksum64 = chksum64;
+	file.fmt = fmt;
+	file.siz = siz;
+	files.push_back(file);
 
-	/*
-	 * read in _rgb.* and _a.*
-	 */
-	if (pfname == strstr(fname, "_rgb.") || pfname == strstr(fname, "_a.")) {
-	  strcpy(pfname, "_rgb.png");
-	  if (!osal_path_existsA(fname)) {
-		strcpy(pfname, "_rgb.bmp");
-		if (!osal_path_existsA(fname)) {
+  } while (foundfilename != nullptr);
+  osal_search_dir_close(dir);
+}
+
+/* Decode, analyze and quantize one texture of the pack.
+ * Runs on the loader threads, so it must not touch the cache. */
+boolean
+TxHiResCache::loadHiResTexture(const HiResFile &file, GHQTexInfo *info) const
+{
+  int width = 0, height = 0;
+  uint16 format = 0;
+  uint8 *tex = nullptr;
+  int tmpwidth = 0, tmpheight = 0;
+  uint16 tmpformat = 0;
+  uint8 *tmptex= nullptr;
+  uint16 destformat = 0;
+
+  const uint32 fmt = file.fmt;
+  const uint32 siz = file.siz;
+  char fname[MAX_PATH];
+  strcpy(fname, file.name.c_str());
+  char *pfname = fname + file.suffix;
+  FILE *fp = nullptr;
+
+  /* Deal with the wackiness some texture packs utilize Rice format.
+   * Read in the following order: _a.* + _rgb.*, _all.png _ciByRGBA.png,
+   * _allciByRGBA.png, and _ci.bmp. PNG are prefered over BMP.
+   *
+   * For some reason there are texture packs that include them all. Some
+   * even have RGB textures named as _all.* and ARGB textures named as
+   * _rgb.*... Someone pleeeez write a GOOD guideline for the texture
+   * designers!!!
+   *
+   * We allow hires textures to have higher bpp than the N64 originals.
+   */
+  /* N64 formats
+   * Format: 0 - RGBA, 1 - YUV, 2 - CI, 3 - IA, 4 - I
+   * Size:   0 - 4bit, 1 - 8bit, 2 - 16bit, 3 - 32 bit
+   */
+
+  /*
+   * read in _rgb.* and _a.*
+   */
+  if (pfname == strstr(fname, "_rgb.") || pfname == strstr(fname, "_a.")) {
+	strcpy(pfname, "_rgb.png");
+	if (!texFileExists(file.dir, fname)) {
+	  strcpy(pfname, "_rgb.bmp");
+	  if (!texFileExists(file.dir, fname)) {
 #if !DEBUG
-		  INFO(80, wst("-----\n"));
-		  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-		  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+		INFO(80, wst("-----\n"));
+		INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+		INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-		  INFO(80, wst("Error: missing _rgb.*! _a.* must be paired with _rgb.*!\n"));
-		  continue;
-		}
+		INFO(80, wst("Error: missing _rgb.*! _a.* must be paired with _rgb.*!\n"));
+		return 0;
 	  }
-	  /* _a.png */
-	  strcpy(pfname, "_a.png");
-	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		tmptex = _txImage->readPNG(fp, &tmpwidth, &tmpheight, &tmpformat);
+	}
+	/* _a.png */
+	strcpy(pfname, "_a.png");
+	if ((fp = openTexFile(file.dir, fname)) != nullptr) {
+	  tmptex = _txImage->readPNG(fp, &tmpwidth, &tmpheight, &tmpformat);
+	  fclose(fp);
+	}
+	if (!tmptex) {
+	  /* _a.bmp */
+	  strcpy(pfname, "_a.bmp");
+	  if ((fp = openTexFile(file.dir, fname)) != nullptr) {
+		tmptex = _txImage->readBMP(fp, &tmpwidth, &tmpheight, &tmpformat);
 		fclose(fp);
 	  }
-	  if (!tmptex) {
-		/* _a.bmp */
-		strcpy(pfname, "_a.bmp");
-		if ((fp = fopen(fname, "rb")) != nullptr) {
-		  tmptex = _txImage->readBMP(fp, &tmpwidth, &tmpheight, &tmpformat);
-		  fclose(fp);
-		}
-	  }
-	  /* _rgb.png */
-	  strcpy(pfname, "_rgb.png");
-	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		tex = _txImage->readPNG(fp, &width, &height, &format);
+	}
+	/* _rgb.png */
+	strcpy(pfname, "_rgb.png");
+	if ((fp = openTexFile(file.dir, fname)) != nullptr) {
+	  tex = _txImage->readPNG(fp, &width, &height, &format);
+	  fclose(fp);
+	}
+	if (!tex) {
+	  /* _rgb.bmp */
+	  strcpy(pfname, "_rgb.bmp");
+	  if ((fp = openTexFile(file.dir, fname)) != nullptr) {
+		tex = _txImage->readBMP(fp, &width, &height, &format);
 		fclose(fp);
 	  }
-	  if (!tex) {
-		/* _rgb.bmp */
-		strcpy(pfname, "_rgb.bmp");
-		if ((fp = fopen(fname, "rb")) != nullptr) {
-		  tex = _txImage->readBMP(fp, &width, &height, &format);
-		  fclose(fp);
-		}
-	  }
-	  if (tmptex) {
-		/* check if _rgb.* and _a.* have matching size and format. */
-		if (!tex || width != tmpwidth || height != tmpheight ||
-			format != GL_RGBA8 || tmpformat != GL_RGBA8) {
+	}
+	if (tmptex) {
+	  /* check if _rgb.* and _a.* have matching size and format. */
+	  if (!tex || width != tmpwidth || height != tmpheight ||
+		  format != GL_RGBA8 || tmpformat != GL_RGBA8) {
 #if !DEBUG
-		  INFO(80, wst("-----\n"));
-		  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-		  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+		INFO(80, wst("-----\n"));
+		INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+		INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-		  if (!tex) {
-			INFO(80, wst("Error: missing _rgb.*!\n"));
-		  } else if (width != tmpwidth || height != tmpheight) {
-			INFO(80, wst("Error: _rgb.* and _a.* have mismatched width or height!\n"));
-		  } else if (format != GL_RGBA8 || tmpformat != GL_RGBA8) {
-			INFO(80, wst("Error: _rgb.* or _a.* not in 32bit color!\n"));
-		  }
-		  if (tex) free(tex);
-		  if (tmptex) free(tmptex);
-		  tex = nullptr;
-		  tmptex = nullptr;
-		  continue;
+		if (!tex) {
+		  INFO(80, wst("Error: missing _rgb.*!\n"));
+		} else if (width != tmpwidth || height != tmpheight) {
+		  INFO(80, wst("Error: _rgb.* and _a.* have mismatched width or height!\n"));
+		} else if (format != GL_RGBA8 || tmpformat != GL_RGBA8) {
+		  INFO(80, wst("Error: _rgb.* or _a.* not in 32bit color!\n"));
 		}
+		if (tex) free(tex);
+		if (tmptex) free(tmptex);
+		tex = nullptr;
+		tmptex = nullptr;
+		return 0;
 	  }
-	  /* make adjustments */
-	  if (tex) {
-		if (tmptex) {
-		  /* merge (A)RGB and A comp */
-		  DBG_INFO(80, wst("merge (A)RGB and A comp\n"));
-		  int i;
-		  for (i = 0; i < height * width; i++) {
+	}
+	/* make adjustments */
+	if (tex) {
+	  if (tmptex) {
+		/* merge (A)RGB and A comp */
+		DBG_INFO(80, wst("merge (A)RGB and A comp\n"));
+		int i;
+		for (i = 0; i < height * width; i++) {
 #if 1
-			/* use R comp for alpha. this is what Rice uses. sigh... */
-			((uint32*)tex)[i] &= 0x00ffffff;
-			((uint32*)tex)[i] |= ((((uint32*)tmptex)[i] & 0xff) << 24);
+		  /* use R comp for alpha. this is what Rice uses. sigh... */
+		  ((uint32*)tex)[i] &= 0x00ffffff;
+		  ((uint32*)tex)[i] |= ((((uint32*)tmptex)[i] & 0xff) << 24);
 #endif
 #if 0
-			/* use libpng style grayscale conversion */
-			uint32 texel = ((uint32*)tmptex)[i];
-			uint32 acomp = (((texel >> 16) & 0xff) * 6969 +
-							((texel >>  8) & 0xff) * 23434 +
-							((texel      ) & 0xff) * 2365) / 32768;
-			((uint32*)tex)[i] = (acomp << 24) | (((uint32*)tex)[i] & 0x00ffffff);
+		  /* use libpng style grayscale conversion */
+		  uint32 texel = ((uint32*)tmptex)[i];
+		  uint32 acomp = (((texel >> 16) & 0xff) * 6969 +
+						  ((texel >>  8) & 0xff) * 23434 +
+						  ((texel      ) & 0xff) * 2365) / 32768;
+		  ((uint32*)tex)[i] = (acomp << 24) | (((uint32*)tex)[i] & 0x00ffffff);
 #endif
 #if 0
-			/* use the standard NTSC gray scale conversion */
-			uint32 texel = ((uint32*)tmptex)[i];
-			uint32 acomp = (((texel >> 16) & 0xff) * 299 +
-							((texel >>  8) & 0xff) * 587 +
-							((texel      ) & 0xff) * 114) / 1000;
-			((uint32*)tex)[i] = (acomp << 24) | (((uint32*)tex)[i] & 0x00ffffff);
+		  /* use the standard NTSC gray scale conversion */
+		  uint32 texel = ((uint32*)tmptex)[i];
+		  uint32 acomp = (((texel >> 16) & 0xff) * 299 +
+						  ((texel >>  8) & 0xff) * 587 +
+						  ((texel      ) & 0xff) * 114) / 1000;
+		  ((uint32*)tex)[i] = (acomp << 24) | (((uint32*)tex)[i] & 0x00ffffff);
 #endif
-		  }
-		  free(tmptex);
-		  tmptex = nullptr;
-		} else {
-		  /* clobber A comp. never a question of alpha. only RGB used. */
+		}
+		free(tmptex);
+		tmptex = nullptr;
+	  } else {
+		/* clobber A comp. never a question of alpha. only RGB used. */
 #if !DEBUG
-		  INFO(80, wst("-----\n"));
-		  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-		  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+		INFO(80, wst("-----\n"));
+		INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+		INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-		  INFO(80, wst("Warning: missing _a.*! only using _rgb.*. treat as opaque texture.\n"));
-		  int i;
-		  for (i = 0; i < height * width; i++) {
-			((uint32*)tex)[i] |= 0xff000000;
-		  }
+		INFO(80, wst("Warning: missing _a.*! only using _rgb.*. treat as opaque texture.\n"));
+		int i;
+		for (i = 0; i < height * width; i++) {
+		  ((uint32*)tex)[i] |= 0xff000000;
 		}
 	  }
-	} else
+	}
+  } else
 
-	/*
-	 * read in _all.png, _all.dds, _allciByRGBA.png, _allciByRGBA.dds
-	 * _ciByRGBA.png, _ciByRGBA.dds, _ci.bmp
-	 */
-	if (pfname == strstr(fname, "_all.png") ||
-		pfname == strstr(fname, "_all.dds") ||
-#ifdef WIN32
-		pfname == strstr(fname, "_allcibyrgba.png") ||
-		pfname == strstr(fname, "_allcibyrgba.dds") ||
-		pfname == strstr(fname, "_cibyrgba.png") ||
-		pfname == strstr(fname, "_cibyrgba.dds") ||
-#else
-		pfname == strstr(fname, "_allciByRGBA.png") ||
-		pfname == strstr(fname, "_allciByRGBA.dds") ||
-		pfname == strstr(fname, "_ciByRGBA.png") ||
-		pfname == strstr(fname, "_ciByRGBA.dds") ||
-#endif
-		pfname == strstr(fname, "_ci.bmp")) {
-	  if ((fp = fopen(fname, "rb")) != nullptr) {
-		if      (strstr(fname, ".png")) tex = _txImage->readPNG(fp, &width, &height, &format);
-		else                            tex = _txImage->readBMP(fp, &width, &height, &format);
-		fclose(fp);
-	  }
+  /*
+   * read in _all.png, _all.dds, _allciByRGBA.png, _allciByRGBA.dds
+   * _ciByRGBA.png, _ciByRGBA.dds, _ci.bmp
+   */
+  if (isSingleFileTexture(fname, pfname)) {
+	if ((fp = openTexFile(file.dir, fname)) != nullptr) {
+	  if      (strstr(fname, ".png")) tex = _txImage->readPNG(fp, &width, &height, &format);
+	  else                            tex = _txImage->readBMP(fp, &width, &height, &format);
+	  fclose(fp);
 	}
+  }
 
-	/* if we do not have a texture at this point we are screwed */
-	if (!tex) {
+  /* if we do not have a texture at this point we are screwed */
+  if (!tex) {
 #if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+	INFO(80, wst("-----\n"));
+	INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+	INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-	  INFO(80, wst("Error: load failed!\n"));
-	  continue;
-	}
-	DBG_INFO(80, wst("read in as %d x %d gfmt:%x\n"), tmpwidth, tmpheight, tmpformat);
+	INFO(80, wst("Error: load failed!\n"));
+	return 0;
+  }
+  DBG_INFO(80, wst("read in as %d x %d gfmt:%x\n"), tmpwidth, tmpheight, tmpformat);
 
-	/* check if size and format are OK */
-	if (!(format == GL_RGBA8 || format == GL_COLOR_INDEX8_EXT ) ||
-		(width * height) < 4) { /* TxQuantize requirement: width * height must be 4 or larger. */
-	  free(tex);
-	  tex = nullptr;
+  /* check if size and format are OK */
+  if (!(format == GL_RGBA8 || format == GL_COLOR_INDEX8_EXT ) ||
+	  (width * height) < 4) { /* TxQuantize requirement: width * height must be 4 or larger. */
+	free(tex);
+	tex = nullptr;
 #if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+	INFO(80, wst("-----\n"));
+	INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+	INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-	  INFO(80, wst("Error: not width * height > 4 or 8bit palette color or 32bpp or dxt1 or dxt3 or dxt5!\n"));
-	  continue;
-	}
+	INFO(80, wst("Error: not width * height > 4 or 8bit palette color or 32bpp or dxt1 or dxt3 or dxt5!\n"));
+	return 0;
+  }
 
-	/* analyze and determine best format to quantize */
-	if (format == GL_RGBA8) {
-	  int i;
-	  int alphabits = 0;
-	  int fullalpha = 0;
-	  boolean intensity = 1;
-
-	  if (!(_options & LET_TEXARTISTS_FLY)) {
-		/* HACK ALERT! */
-		/* Account for Rice's weirdness with fmt:0 siz:2 textures.
-		 * Although the conditions are relaxed with other formats,
-		 * the D3D RGBA5551 surface is used for this format in certain
-		 * cases. See Nintemod's SuperMario64 life gauge and power
-		 * meter. The same goes for fmt:2 textures. See Mollymutt's
-		 * PaperMario text. */
-		if ((fmt == 0 && siz == 2) || fmt == 2) {
-		  DBG_INFO(80, wst("Remove black, white, etc borders along the alpha edges.\n"));
-		  /* round A comp */
-		  for (i = 0; i < height * width; i++) {
-			uint32 texel = ((uint32*)tex)[i];
-			((uint32*)tex)[i] = ((texel & 0xff000000) == 0xff000000 ? 0xff000000 : 0) |
-								(texel & 0x00ffffff);
-		  }
-		  /* Substitute texel color with the average of the surrounding
-		   * opaque texels. This removes borders regardless of hardware
-		   * texture filtering (bilinear, etc). */
-		  int j;
-		  for (i = 0; i < height; i++) {
-			for (j = 0; j < width; j++) {
-			  uint32 texel = ((uint32*)tex)[i * width + j];
-			  if ((texel & 0xff000000) != 0xff000000) {
-				uint32 tmptexel[8];
-				uint32 k, numtexel, r, g, b;
-				numtexel = r = g = b = 0;
-				memset(&tmptexel, 0, sizeof(tmptexel));
-				if (i > 0) {
-				  tmptexel[0] = ((uint32*)tex)[(i - 1) * width + j];                        /* north */
-				  if (j > 0)         tmptexel[1] = ((uint32*)tex)[(i - 1) * width + j - 1]; /* north-west */
-				  if (j < width - 1) tmptexel[2] = ((uint32*)tex)[(i - 1) * width + j + 1]; /* north-east */
-				}
-				if (i < height - 1) {
-				  tmptexel[3] = ((uint32*)tex)[(i + 1) * width + j];                        /* south */
-				  if (j > 0)         tmptexel[4] = ((uint32*)tex)[(i + 1) * width + j - 1]; /* south-west */
-				  if (j < width - 1) tmptexel[5] = ((uint32*)tex)[(i + 1) * width + j + 1]; /* south-east */
-				}
-				if (j > 0)         tmptexel[6] = ((uint32*)tex)[i * width + j - 1]; /* west */
-				if (j < width - 1) tmptexel[7] = ((uint32*)tex)[i * width + j + 1]; /* east */
-				for (k = 0; k < 8; k++) {
-				  if ((tmptexel[k] & 0xff000000) == 0xff000000) {
-					b += ((tmptexel[k] & 0x00ff0000) >> 16);
-					g += ((tmptexel[k] & 0x0000ff00) >>  8);
-					r += ((tmptexel[k] & 0x000000ff)      );
-					numtexel++;
-				  }
-				}
-				if (numtexel) {
-				  ((uint32*)tex)[i * width + j] = ((b / numtexel) << 16) |
-												  ((g / numtexel) <<  8) |
-												  ((r / numtexel)      );
-				} else {
-				  ((uint32*)tex)[i * width + j] = texel & 0x00ffffff;
+  /* analyze and determine best format to quantize */
+  if (format == GL_RGBA8) {
+	int i;
+	int alphabits = 0;
+	int fullalpha = 0;
+	boolean intensity = 1;
+
+	if (!(_options & LET_TEXARTISTS_FLY)) {
+	  /* HACK ALERT! */
+	  /* Account for Rice's weirdness with fmt:0 siz:2 textures.
+	   * Although the conditions are relaxed with other formats,
+	   * the D3D RGBA5551 surface is used for this format in certain
+	   * cases. See Nintemod's SuperMario64 life gauge and power
+	   * meter. The same goes for fmt:2 textures. See Mollymutt's
+	   * PaperMario text. */
+	  if ((fmt == 0 && siz == 2) || fmt == 2) {
+		DBG_INFO(80, wst("Remove black, white, etc borders along the alpha edges.\n"));
+		/* round A comp */
+		for (i = 0; i < height * width; i++) {
+		  uint32 texel = ((uint32*)tex)[i];
+		  ((uint32*)tex)[i] = ((texel & 0xff000000) == 0xff000000 ? 0xff000000 : 0) |
+							  (texel & 0x00ffffff);
+		}
+		/* Substitute texel color with the average of the surrounding
+		 * opaque texels. This removes borders regardless of hardware
+		 * texture filtering (bilinear, etc). */
+		int j;
+		for (i = 0; i < height; i++) {
+		  for (j = 0; j < width; j++) {
+			uint32 texel = ((uint32*)tex)[i * width + j];
+			if ((texel & 0xff000000) != 0xff000000) {
+			  uint32 tmptexel[8];
+			  uint32 k, numtexel, r, g, b;
+			  numtexel = r = g = b = 0;
+			  memset(&tmptexel, 0, sizeof(tmptexel));
+			  if (i > 0) {
+				tmptexel[0] = ((uint32*)tex)[(i - 1) * width + j];                        /* north */
+				if (j > 0)         tmptexel[1] = ((uint32*)tex)[(i - 1) * width + j - 1]; /* north-west */
+				if (j < width - 1) tmptexel[2] = ((uint32*)tex)[(i - 1) * width + j + 1]; /* north-east */
+			  }
+			  if (i < height - 1) {
+				tmptexel[3] = ((uint32*)tex)[(i + 1) * width + j];                        /* south */
+				if (j > 0)         tmptexel[4] = ((uint32*)tex)[(i + 1) * width + j - 1]; /* south-west */
+				if (j < width - 1) tmptexel[5] = ((uint32*)tex)[(i + 1) * width + j + 1]; /* south-east */
+			  }
+			  if (j > 0)         tmptexel[6] = ((uint32*)tex)[i * width + j - 1]; /* west */
+			  if (j < width - 1) tmptexel[7] = ((uint32*)tex)[i * width + j + 1]; /* east */
+			  for (k = 0; k < 8; k++) {
+				if ((tmptexel[k] & 0xff000000) == 0xff000000) {
+				  b += ((tmptexel[k] & 0x00ff0000) >> 16);
+				  g += ((tmptexel[k] & 0x0000ff00) >>  8);
+				  r += ((tmptexel[k] & 0x000000ff)      );
+				  numtexel++;
 				}
 			  }
+			  if (numtexel) {
+				((uint32*)tex)[i * width + j] = ((b / numtexel) << 16) |
+												((g / numtexel) <<  8) |
+												((r / numtexel)      );
+			  } else {
+				((uint32*)tex)[i * width + j] = texel & 0x00ffffff;
+			  }
 			}
 		  }
 		}
 	  }
+	}
 
-	  /* simple analysis of texture */
-	  for (i = 0; i < height * width; i++) {
-		uint32 texel = ((uint32*)tex)[i];
-		if (alphabits != 8) {
+	/* simple analysis of texture */
+	for (i = 0; i < height * width; i++) {
+	  uint32 texel = ((uint32*)tex)[i];
+	  if (alphabits != 8) {
 #if AGGRESSIVE_QUANTIZATION
-		  if ((texel & 0xff000000) < 0x00000003) {
-			alphabits = 1;
-			fullalpha++;
-		  } else if ((texel & 0xff000000) < 0xfe000000) {
-			alphabits = 8;
-		  }
+		if ((texel & 0xff000000) < 0x00000003) {
+		  alphabits = 1;
+		  fullalpha++;
+		} else if ((texel & 0xff000000) < 0xfe000000) {
+		  alphabits = 8;
+		}
 #else
-		  if ((texel & 0xff000000) == 0x00000000) {
-			alphabits = 1;
-			fullalpha++;
-		  } else if ((texel & 0xff000000) != 0xff000000) {
-			alphabits = 8;
-		  }
-#endif
+		if ((texel & 0xff000000) == 0x00000000) {
+		  alphabits = 1;
+		  fullalpha++;
+		} else if ((texel & 0xff000000) != 0xff000000) {
+		  alphabits = 8;
 		}
-		if (intensity) {
-		  int rcomp = (texel >> 16) & 0xff;
-		  int gcomp = (texel >>  8) & 0xff;
-		  int bcomp = (texel      ) & 0xff;
+#endif
+	  }
+	  if (intensity) {
+		int rcomp = (texel >> 16) & 0xff;
+		int gcomp = (texel >>  8) & 0xff;
+		int bcomp = (texel      ) & 0xff;
 #if AGGRESSIVE_QUANTIZATION
-		  if (abs(rcomp - gcomp) > 8 || abs(rcomp - bcomp) > 8 || abs(gcomp - bcomp) > 8) intensity = 0;
+		if (abs(rcomp - gcomp) > 8 || abs(rcomp - bcomp) > 8 || abs(gcomp - bcomp) > 8) intensity = 0;
 #else
-		  if (rcomp != gcomp || rcomp != bcomp || gcomp != bcomp) intensity = 0;
+		if (rcomp != gcomp || rcomp != bcomp || gcomp != bcomp) intensity = 0;
 #endif
-		}
-		if (!intensity && alphabits == 8) break;
 	  }
-	  DBG_INFO(80, wst("required alpha bits:%d zero acomp texels:%d rgb as intensity:%d\n"), alphabits, fullalpha, intensity);
+	  if (!intensity && alphabits == 8) break;
+	}
+	DBG_INFO(80, wst("required alpha bits:%d zero acomp texels:%d rgb as intensity:%d\n"), alphabits, fullalpha, intensity);
 
-	  /* preparations based on above analysis */
+	/* preparations based on above analysis */
 #if !REDUCE_TEXTURE_FOOTPRINT
-	  if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX) {
+	if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX) {
 #endif
-		if      (alphabits == 0) destformat = GL_RGB;
-		else if (alphabits == 1) destformat = GL_RGB5_A1;
-		else                     destformat = GL_RGBA8;
+	  if      (alphabits == 0) destformat = GL_RGB;
+	  else if (alphabits == 1) destformat = GL_RGB5_A1;
+	  else                     destformat = GL_RGBA8;
 #if !REDUCE_TEXTURE_FOOTPRINT
-	  } else {
-		destformat = GL_RGBA8;
-	  }
+	} else {
+	  destformat = GL_RGBA8;
+	}
 #endif
-	  if (fmt == 4 && alphabits == 0) {
-		destformat = GL_RGBA8;
-		/* Rice I format; I = (R + G + B) / 3 */
-		for (i = 0; i < height * width; i++) {
-		  uint32 texel = ((uint32*)tex)[i];
-		  uint32 icomp = (((texel >> 16) & 0xff) +
-						  ((texel >>  8) & 0xff) +
-						  ((texel      ) & 0xff)) / 3;
-		  ((uint32*)tex)[i] = (icomp << 24) | (texel & 0x00ffffff);
-		}
+	if (fmt == 4 && alphabits == 0) {
+	  destformat = GL_RGBA8;
+	  /* Rice I format; I = (R + G + B) / 3 */
+	  for (i = 0; i < height * width; i++) {
+		uint32 texel = ((uint32*)tex)[i];
+		uint32 icomp = (((texel >> 16) & 0xff) +
+						((texel >>  8) & 0xff) +
+						((texel      ) & 0xff)) / 3;
+		((uint32*)tex)[i] = (icomp << 24) | (texel & 0x00ffffff);
 	  }
-
-	  DBG_INFO(80, wst("best gfmt:%x\n"), destformat);
 	}
-	/*
-	 * Rice hi-res textures: end */
 
+	DBG_INFO(80, wst("best gfmt:%x\n"), destformat);
+  }
+  /*
+   * Rice hi-res textures: end */
 
-	/* XXX: only RGBA8888 for now. comeback to this later... */
-	if (format == GL_RGBA8) {
 
-	  /* minification */
-	  if (width > _maxwidth || height > _maxheight) {
-		int ratio = 1;
-		if (width / _maxwidth > height / _maxheight) {
-		  ratio = (int)ceil((double)width / _maxwidth);
-		} else {
-		  ratio = (int)ceil((double)height / _maxheight);
-		}
-		if (!_txReSample->minify(&tex, &width, &height, ratio)) {
-		  free(tex);
-		  tex = nullptr;
-		  DBG_INFO(80, wst("Error: minification failed!\n"));
-		  continue;
-		}
+  /* XXX: only RGBA8888 for now. comeback to this later... */
+  if (format == GL_RGBA8) {
+
+	/* minification */
+	if (width > _maxwidth || height > _maxheight) {
+	  int ratio = 1;
+	  if (width / _maxwidth > height / _maxheight) {
+		ratio = (int)ceil((double)width / _maxwidth);
+	  } else {
+		ratio = (int)ceil((double)height / _maxheight);
+	  }
+	  if (!_txReSample->minify(&tex, &width, &height, ratio)) {
+		free(tex);
+		tex = nullptr;
+		DBG_INFO(80, wst("Error: minification failed!\n"));
+		return 0;
 	  }
+	}
 
 #if POW2_TEXTURES
 #if (POW2_TEXTURES == 2)
-		/* 3dfx Glide3x aspect ratio (8:1 - 1:8) */
-		if (!_txReSample->nextPow2(&tex, &width , &height, 32, 1)) {
+	  /* 3dfx Glide3x aspect ratio (8:1 - 1:8) */
+	  if (!_txReSample->nextPow2(&tex, &width , &height, 32, 1)) {
 #else
-		/* normal pow2 expansion */
-		if (!_txReSample->nextPow2(&tex, &width , &height, 32, 0)) {
+	  /* normal pow2 expansion */
+	  if (!_txReSample->nextPow2(&tex, &width , &height, 32, 0)) {
 #endif
-		  free(tex);
-		  tex = nullptr;
-		  DBG_INFO(80, wst("Error: aspect ratio adjustment failed!\n"));
-		  continue;
-		}
+		free(tex);
+		tex = nullptr;
+		DBG_INFO(80, wst("Error: aspect ratio adjustment failed!\n"));
+		return 0;
+	  }
 #endif
 
-	  /* quantize */
-	  {
-		tmptex = (uint8 *)malloc(TxUtil::sizeofTx(width, height, destformat));
-		if (tmptex) {
-		  switch (destformat) {
-		  case GL_RGBA8:
-		  case GL_RGBA4:
+	/* quantize */
+	{
+	  tmptex = (uint8 *)malloc(TxUtil::sizeofTx(width, height, destformat));
+	  if (tmptex) {
+		switch (destformat) {
+		case GL_RGBA8:
+		case GL_RGBA4:
 #if !REDUCE_TEXTURE_FOOTPRINT
-			if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
+		  if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
 #endif
-			  destformat = GL_RGBA4;
-			break;
-		  case GL_RGB5_A1:
+			destformat = GL_RGBA4;
+		  break;
+		case GL_RGB5_A1:
 #if !REDUCE_TEXTURE_FOOTPRINT
-			if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
+		  if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
 #endif
-			  destformat = GL_RGB5_A1;
-			break;
-		  case GL_RGB:
+			destformat = GL_RGB5_A1;
+		  break;
+		case GL_RGB:
 #if !REDUCE_TEXTURE_FOOTPRINT
-			if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
+		  if (_maxbpp < 32 || _options & FORCE16BPP_HIRESTEX)
 #endif
-			  destformat = GL_RGB;
-			break;
-		  }
-		  if (_txQuantize->quantize(tex, tmptex, width, height, GL_RGBA8, destformat, 0)) {
-			format = destformat;
-			free(tex);
-			tex = tmptex;
-		  } else
-			  free(tmptex);
-		  tmptex = nullptr;
+			destformat = GL_RGB;
+		  break;
 		}
+		if (_txQuantize->quantize(tex, tmptex, width, height, GL_RGBA8, destformat, 0)) {
+		  format = destformat;
+		  free(tex);
+		  tex = tmptex;
+		} else
+			free(tmptex);
+		tmptex = nullptr;
 	  }
-
 	}
 
+  }
 
-	/* last minute validations */
-	if (!tex || !chksum || !width || !height || !format || width > _maxwidth || height > _maxheight) {
+
+  /* last minute validations */
+  if (!tex || !width || !height || !format || width > _maxwidth || height > _maxheight) {
 #if !DEBUG
-	  INFO(80, wst("-----\n"));
-	  INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
-	  INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
+	INFO(80, wst("-----\n"));
+	INFO(80, wst("path: %ls\n"), dir_path.string().c_str());
+	INFO(80, wst("file: %ls\n"), it->path().leaf().c_str());
 #endif
-	  if (tex) {
-		free(tex);
-		tex = nullptr;
-		INFO(80, wst("Error: bad format or size! %d x %d gfmt:%x\n"), width, height, format);
-	  } else {
-		INFO(80, wst("Error: load failed!!\n"));
-	  }
-	  continue;
-	}
-
-	/* load it into hires texture cache. */
-	{
-	  uint64 chksum64 = (uint64)palchksum;
-	  chksum64 <<= 32;
-	  chksum64 |= (uint64)chksum;
-
-	  GHQTexInfo tmpInfo;
-	  tmpInfo.data = tex;
-	  tmpInfo.width = width;
-	  tmpInfo.height = height;
-	  tmpInfo.is_hires_tex = 1;
-	  setTextureFormat(format, &tmpInfo);
-
-	  /* remove redundant in cache */
-	  if (replace && TxCache::del(chksum64)) {
-		DBG_INFO(80, wst("removed duplicate old cache.\n"));
-	  }
-
-	  /* add to cache */
-	  if (TxCache::add(chksum64, &tmpInfo)) {
-		/* Callback to display hires texture info.
-		 * Gonetz <gonetz(at)ngs.ru> */
-		if (_callback) {
-		  wchar_t tmpbuf[MAX_PATH];
-		  mbstowcs(tmpbuf, fname, MAX_PATH);
-		  (*_callback)(wst("[%d] total mem:%.2fmb - %ls\n"), _cache.size(), (float)_totalSize/1000000, tmpbuf);
-		}
-		DBG_INFO(80, wst("texture loaded!\n"));
-	  }
+	if (tex) {
 	  free(tex);
+	  tex = nullptr;
+	  INFO(80, wst("Error: bad format or size! %d x %d gfmt:%x\n"), width, height, format);
+	} else {
+	  INFO(80, wst("Error: load failed!!\n"));
 	}
+	return 0;
+  }
 
-  } while (foundfilename != nullptr);
-  osal_search_dir_close(dir);
-
-  CHDIR(curpath);
+  info->data = tex;
+  info->width = width;
+  info->height = height;
+  info->is_hires_tex = 1;
+  setTextureFormat(format, info);
 
   return 1;
 }
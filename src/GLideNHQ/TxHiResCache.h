@@ -34,6 +34,12 @@
 #include "TxQuantize.h"
 #include "TxImage.h"
 #include "TxReSample.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class TxHiResCache : public TxCache
 {
@@ -47,14 +53,43 @@ private:
   TxQuantize *_txQuantize;
   TxReSample *_txReSample;
   tx_wstring _texPackPath;
+  struct HiResFile {
+    tx_wstring dir;
+    std::string name;  /* file name, lower case on windows */
+    size_t suffix;     /* offset of _rgb, _a, _all, ... in name */
+    uint64 chksum64;   /* checksum hi:palette low:texture */
+    uint32 fmt;
+    uint32 siz;
+  };
   boolean loadHiResTextures(const wchar_t * dir_path, boolean replace);
+  void findHiResTextures(const wchar_t * dir_path, boolean replace, std::vector<HiResFile> &files, std::unordered_set<uint64> &found);
+  boolean loadHiResTexture(const HiResFile &file, GHQTexInfo *info) const;
+  /* streaming. _index and _pending are used by the caller's thread only,
+   * the loader threads hand their results over through _streamed. */
+  struct StreamedTexture {
+    uint64 chksum64;
+    GHQTexInfo info;
+  };
+  std::unordered_map<uint64, HiResFile> _index;
+  std::unordered_set<uint64> _pending;
+  std::vector<StreamedTexture> _streamed;
+  std::mutex _streamMutex;
+  std::condition_variable _streamCv;
+  uint32 _streamLoads;
+  boolean _streamCancel;
+  void streamTexture(const HiResFile &file);
+  void flushStream();
+  void stopStream();
 public:
   ~TxHiResCache();
-  TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options,
+  TxHiResCache(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
 	  const wchar_t *cachePath, const wchar_t *texPackPath, const wchar_t *ident,
       dispInfoFuncExt callback);
   boolean empty();
   boolean load(boolean replace);
+  boolean get(uint64 checksum, /* checksum hi:palette low:texture */
+              GHQTexInfo *info);
+  boolean pending(uint64 checksum); /* streamed texture is not loaded yet */
 };
 
 #endif /* __TXHIRESCACHE_H__ */
@@ -69,4 +69,15 @@
 /* in-memory zlib texture compression */
 #define GL_TEXFMT_GZ 0x80000000
 
+/* GPU block compressed formats */
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2          0x9274
+#endif
+
 #endif /* __INTERNAL_H__ */
@@ -27,10 +27,16 @@
 
 /* NOTE: The codes are not optimized. They can be made faster. */
 
-#include <functional>
-#include <thread>
-
 #include "TxQuantize.h"
+#include "TxThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TXQUANTIZE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define TXQUANTIZE_NEON
+#include <arm_neon.h>
+#endif
 
 static const unsigned char One2Eight[2] =
 {
@@ -74,6 +80,184 @@ static const unsigned char Five2Eight[32] =
 	255  // 11111 = 11111111
 };
 
+/* SIMD helpers. Each one converts 8 pixels and matches its scalar loop bit for bit. */
+#if defined(TXQUANTIZE_SSE2)
+
+/* round(x * 255 / 31), same as Five2Eight */
+static inline __m128i Expand5(__m128i x)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(527)), _mm_set1_epi16(23)), 6);
+}
+
+/* interleave four 16-bit lanes of byte values into 8 packed 32-bit pixels */
+static inline void StoreBytes(__m128i b0, __m128i b1, __m128i b2, __m128i b3, uint32* dest)
+{
+	const __m128i lo = _mm_or_si128(b0, _mm_slli_epi16(b1, 8));
+	const __m128i hi = _mm_or_si128(b2, _mm_slli_epi16(b3, 8));
+	_mm_storeu_si128((__m128i*)dest, _mm_unpacklo_epi16(lo, hi));
+	_mm_storeu_si128((__m128i*)(dest + 4), _mm_unpackhi_epi16(lo, hi));
+}
+
+/* narrow 8 32-bit lanes to 16 bits without saturation */
+static inline void StoreWords(__m128i a, __m128i b, uint32* dest)
+{
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+	_mm_storeu_si128((__m128i*)dest, _mm_packs_epi32(a, b));
+}
+
+static inline void ARGB1555_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const __m128i v = _mm_loadu_si128((const __m128i*)src);
+	const __m128i mask5 = _mm_set1_epi16(0x1f);
+	const __m128i a = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi16(1))), _mm_set1_epi16(0xff));
+	StoreBytes(Expand5(_mm_srli_epi16(v, 11)),
+			   Expand5(_mm_and_si128(_mm_srli_epi16(v, 6), mask5)),
+			   Expand5(_mm_and_si128(_mm_srli_epi16(v, 1), mask5)),
+			   a, dest);
+}
+
+static inline void ARGB4444_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const __m128i v = _mm_loadu_si128((const __m128i*)src);
+	const __m128i mask4 = _mm_set1_epi16(0x0f);
+	const __m128i x17 = _mm_set1_epi16(17);
+	StoreBytes(_mm_mullo_epi16(_mm_srli_epi16(v, 12), x17),
+			   _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, 8), mask4), x17),
+			   _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, 4), mask4), x17),
+			   _mm_mullo_epi16(_mm_and_si128(v, mask4), x17),
+			   dest);
+}
+
+static inline void RGB565_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const __m128i v = _mm_loadu_si128((const __m128i*)src);
+	const __m128i b5 = _mm_and_si128(v, _mm_set1_epi16(0x1f));
+	const __m128i g6 = _mm_and_si128(_mm_srli_epi16(v, 5), _mm_set1_epi16(0x3f));
+	const __m128i r5 = _mm_srli_epi16(v, 11);
+	StoreBytes(_mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2)),
+			   _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4)),
+			   _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2)),
+			   _mm_set1_epi16(0xff), dest);
+}
+
+static inline __m128i ARGB8888_ARGB1555_x4(__m128i p)
+{
+	const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(p, _mm_set1_epi32(0xff000000)), _mm_setzero_si128());
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xf800)),
+									 _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07c0))),
+						_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x003e)),
+									 _mm_andnot_si128(transparent, _mm_set1_epi32(1))));
+}
+
+static inline __m128i ARGB8888_ARGB4444_x4(__m128i p)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_srli_epi32(p, 28),
+									 _mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x00f0))),
+						_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 4), _mm_set1_epi32(0x0f00)),
+									 _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xf000))));
+}
+
+static inline __m128i ARGB8888_RGB565_x4(__m128i p)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001f)),
+									 _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07e0))),
+						_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xf800)));
+}
+
+#define QUANTIZE_16_x8(func, src, dest) \
+	StoreWords(func(_mm_loadu_si128((const __m128i*)(src))), func(_mm_loadu_si128((const __m128i*)((src) + 4))), dest)
+
+#elif defined(TXQUANTIZE_NEON)
+
+/* round(x * 255 / 31), same as Five2Eight */
+static inline uint16x8_t Expand5(uint16x8_t x)
+{
+	return vshrq_n_u16(vaddq_u16(vmulq_u16(x, vdupq_n_u16(527)), vdupq_n_u16(23)), 6);
+}
+
+/* interleave four 16-bit lanes of byte values into 8 packed 32-bit pixels */
+static inline void StoreBytes(uint16x8_t b0, uint16x8_t b1, uint16x8_t b2, uint16x8_t b3, uint32* dest)
+{
+	const uint16x8x2_t v = vzipq_u16(vorrq_u16(b0, vshlq_n_u16(b1, 8)), vorrq_u16(b2, vshlq_n_u16(b3, 8)));
+	vst1q_u32(dest, vreinterpretq_u32_u16(v.val[0]));
+	vst1q_u32(dest + 4, vreinterpretq_u32_u16(v.val[1]));
+}
+
+/* narrow 8 32-bit lanes to 16 bits without saturation */
+static inline void StoreWords(uint32x4_t a, uint32x4_t b, uint32* dest)
+{
+	vst1q_u16((uint16*)dest, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+}
+
+static inline void ARGB1555_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const uint16x8_t v = vld1q_u16((const uint16*)src);
+	const uint16x8_t mask5 = vdupq_n_u16(0x1f);
+	StoreBytes(Expand5(vshrq_n_u16(v, 11)),
+			   Expand5(vandq_u16(vshrq_n_u16(v, 6), mask5)),
+			   Expand5(vandq_u16(vshrq_n_u16(v, 1), mask5)),
+			   vmulq_u16(vandq_u16(v, vdupq_n_u16(1)), vdupq_n_u16(0xff)),
+			   dest);
+}
+
+static inline void ARGB4444_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const uint16x8_t v = vld1q_u16((const uint16*)src);
+	const uint16x8_t mask4 = vdupq_n_u16(0x0f);
+	const uint16x8_t x17 = vdupq_n_u16(17);
+	StoreBytes(vmulq_u16(vshrq_n_u16(v, 12), x17),
+			   vmulq_u16(vandq_u16(vshrq_n_u16(v, 8), mask4), x17),
+			   vmulq_u16(vandq_u16(vshrq_n_u16(v, 4), mask4), x17),
+			   vmulq_u16(vandq_u16(v, mask4), x17),
+			   dest);
+}
+
+static inline void RGB565_ARGB8888_x8(const uint32* src, uint32* dest)
+{
+	const uint16x8_t v = vld1q_u16((const uint16*)src);
+	const uint16x8_t b5 = vandq_u16(v, vdupq_n_u16(0x1f));
+	const uint16x8_t g6 = vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(0x3f));
+	const uint16x8_t r5 = vshrq_n_u16(v, 11);
+	StoreBytes(vorrq_u16(vshlq_n_u16(b5, 3), vshrq_n_u16(b5, 2)),
+			   vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4)),
+			   vorrq_u16(vshlq_n_u16(r5, 3), vshrq_n_u16(r5, 2)),
+			   vdupq_n_u16(0xff), dest);
+}
+
+static inline uint32x4_t ARGB8888_ARGB1555_x4(uint32x4_t p)
+{
+	const uint32x4_t opaque = vtstq_u32(p, vdupq_n_u32(0xff000000));
+	return vorrq_u32(vorrq_u32(vandq_u32(vshlq_n_u32(p, 8), vdupq_n_u32(0xf800)),
+							   vandq_u32(vshrq_n_u32(p, 5), vdupq_n_u32(0x07c0))),
+					 vorrq_u32(vandq_u32(vshrq_n_u32(p, 18), vdupq_n_u32(0x003e)),
+							   vandq_u32(opaque, vdupq_n_u32(1))));
+}
+
+static inline uint32x4_t ARGB8888_ARGB4444_x4(uint32x4_t p)
+{
+	return vorrq_u32(vorrq_u32(vshrq_n_u32(p, 28),
+							   vandq_u32(vshrq_n_u32(p, 16), vdupq_n_u32(0x00f0))),
+					 vorrq_u32(vandq_u32(vshrq_n_u32(p, 4), vdupq_n_u32(0x0f00)),
+							   vandq_u32(vshlq_n_u32(p, 8), vdupq_n_u32(0xf000))));
+}
+
+static inline uint32x4_t ARGB8888_RGB565_x4(uint32x4_t p)
+{
+	return vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(p, 3), vdupq_n_u32(0x001f)),
+							   vandq_u32(vshrq_n_u32(p, 5), vdupq_n_u32(0x07e0))),
+					 vandq_u32(vshrq_n_u32(p, 8), vdupq_n_u32(0xf800)));
+}
+
+#define QUANTIZE_16_x8(func, src, dest) \
+	StoreWords(func(vld1q_u32(src)), func(vld1q_u32((src) + 4)), dest)
+
+#endif
+
+#if defined(TXQUANTIZE_SSE2) || defined(TXQUANTIZE_NEON)
+#define TXQUANTIZE_SIMD
+#endif
+
 TxQuantize::TxQuantize()
 {
 	/* get number of CPU cores. */
@@ -88,7 +272,14 @@ TxQuantize::~TxQuantize()
 void
 TxQuantize::ARGB1555_ARGB8888(uint32* src, uint32* dest, int width, int height)
 {
-	const int siz = (width * height) >> 1;
+	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		ARGB1555_ARGB8888_x8(src, dest);
+		src += 4;
+		dest += 8;
+	}
+#endif
 	uint8 r, g, b, a;
 	uint32 color;
 	for (int i = 0; i < siz; ++i) {
@@ -113,7 +304,14 @@ TxQuantize::ARGB1555_ARGB8888(uint32* src, uint32* dest, int width, int height)
 void
 TxQuantize::ARGB4444_ARGB8888(uint32* src, uint32* dest, int width, int height)
 {
-	const int siz = (width * height) >> 1;
+	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		ARGB4444_ARGB8888_x8(src, dest);
+		src += 4;
+		dest += 8;
+	}
+#endif
 	for (int i = 0; i < siz; ++i) {
 		*dest = ((*src & 0x0000f000) >> 8 ) |
 				((*src & 0x00000f00) << 4 ) |
@@ -135,6 +333,13 @@ void
 TxQuantize::RGB565_ARGB8888(uint32* src, uint32* dest, int width, int height)
 {
 	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		RGB565_ARGB8888_x8(src, dest);
+		src += 4;
+		dest += 8;
+	}
+#endif
 	int i;
 	for (i = 0; i < siz; i++) {
 		*dest = (0xff000000 |
@@ -228,7 +433,14 @@ TxQuantize::AI88_ARGB8888(uint32* src, uint32* dest, int width, int height)
 void
 TxQuantize::ARGB8888_ARGB1555(uint32* src, uint32* dest, int width, int height)
 {
-	const int siz = (width * height) >> 1;
+	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		QUANTIZE_16_x8(ARGB8888_ARGB1555_x4, src, dest);
+		src += 8;
+		dest += 4;
+	}
+#endif
 	uint32 color;
 	uint32 r, g, b;
 	for (int i = 0; i < siz; i++) {
@@ -253,7 +465,14 @@ TxQuantize::ARGB8888_ARGB1555(uint32* src, uint32* dest, int width, int height)
 void
 TxQuantize::ARGB8888_ARGB4444(uint32* src, uint32* dest, int width, int height)
 {
-	const int siz = (width * height) >> 1;
+	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		QUANTIZE_16_x8(ARGB8888_ARGB4444_x4, src, dest);
+		src += 8;
+		dest += 4;
+	}
+#endif
 	for (int i = 0; i < siz; ++i) {
 		*dest = (((*src & 0xf0000000) >> 28) |
 				 ((*src & 0x00f00000) >> 16) |
@@ -273,6 +492,13 @@ void
 TxQuantize::ARGB8888_RGB565(uint32* src, uint32* dest, int width, int height)
 {
 	int siz = (width * height) >> 1;
+#ifdef TXQUANTIZE_SIMD
+	for (; siz >= 4; siz -= 4) {
+		QUANTIZE_16_x8(ARGB8888_RGB565_x4, src, dest);
+		src += 8;
+		dest += 4;
+	}
+#endif
 	int i;
 	for (i = 0; i < siz; i++) {
 		*dest = (((*src & 0x000000f8) >> 3) |
@@ -884,31 +1110,16 @@ TxQuantize::quantize(uint8* src, uint8* dest, int width, int height, uint16 srcf
 			numcore--;
 		}
 		if (blkrow > 0 && numcore > 1) {
-			std::thread *thrd[MAX_NUMCORE];
-			unsigned int i;
-			int blkheight = blkrow << 2;
-			unsigned int srcStride = (width * blkheight) << (2 - bpp_shift);
-			unsigned int destStride = srcStride << bpp_shift;
-			for (i = 0; i < numcore - 1; i++) {
-				thrd[i] = new std::thread(std::bind(quantizer,
-														this,
-														(uint32*)src,
-														(uint32*)dest,
-														width,
-														blkheight));
-				src  += srcStride;
-				dest += destStride;
-			}
-			thrd[i] = new std::thread(std::bind(quantizer,
-													this,
-													(uint32*)src,
-													(uint32*)dest,
-													width,
-													height - blkheight * i));
-			for (i = 0; i < numcore; i++) {
-				thrd[i]->join();
-				delete thrd[i];
-			}
+			const unsigned int blkheight = blkrow << 2;
+			const unsigned int srcStride = (width * blkheight) << (2 - bpp_shift);
+			const unsigned int destStride = srcStride << bpp_shift;
+			const unsigned int numblk = numcore;
+			TxThreadPool::getInstance()->parallelFor(numblk, [=](uint32 i) {
+				(*this.*quantizer)((uint32*)(src + srcStride * i),
+									(uint32*)(dest + destStride * i),
+									width,
+									i < numblk - 1 ? blkheight : height - blkheight * i);
+			});
 		} else {
 			(*this.*quantizer)((uint32*)src, (uint32*)dest, width, height);
 		}
@@ -938,31 +1149,16 @@ TxQuantize::quantize(uint8* src, uint8* dest, int width, int height, uint16 srcf
 			numcore--;
 		}
 		if (blkrow > 0 && numcore > 1) {
-			std::thread *thrd[MAX_NUMCORE];
-			unsigned int i;
-			int blkheight = blkrow << 2;
-			unsigned int srcStride = (width * blkheight) << 2;
-			unsigned int destStride = srcStride >> bpp_shift;
-			for (i = 0; i < numcore - 1; i++) {
-				thrd[i] = new std::thread(std::bind(quantizer,
-														this,
-														(uint32*)src,
-														(uint32*)dest,
-														width,
-														blkheight));
-				src  += srcStride;
-				dest += destStride;
-			}
-			thrd[i] = new std::thread(std::bind(quantizer,
-													this,
-													(uint32*)src,
-													(uint32*)dest,
-													width,
-													height - blkheight * i));
-			for (i = 0; i < numcore; i++) {
-				thrd[i]->join();
-				delete thrd[i];
-			}
+			const unsigned int blkheight = blkrow << 2;
+			const unsigned int srcStride = (width * blkheight) << 2;
+			const unsigned int destStride = srcStride >> bpp_shift;
+			const unsigned int numblk = numcore;
+			TxThreadPool::getInstance()->parallelFor(numblk, [=](uint32 i) {
+				(*this.*quantizer)((uint32*)(src + srcStride * i),
+									(uint32*)(dest + destStride * i),
+									width,
+									i < numblk - 1 ? blkheight : height - blkheight * i);
+			});
 		} else {
 			(*this.*quantizer)((uint32*)src, (uint32*)dest, width, height);
 		}
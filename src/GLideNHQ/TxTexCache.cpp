@@ -35,24 +35,12 @@
 
 TxTexCache::~TxTexCache()
 {
-#if DUMP_CACHE
-	if (_options & DUMP_TEXCACHE) {
-		/* dump cache to disk */
-		tx_wstring filename = _ident + wst("_MEMORYCACHE.") + TEXCACHE_EXT;
-		removeColon(filename);
-		tx_wstring cachepath(_path);
-		cachepath += OSAL_DIR_SEPARATOR_STR;
-		cachepath += wst("cache");
-		int config = _options & (FILTER_MASK | ENHANCEMENT_MASK | FORCE16BPP_TEX | GZ_TEXCACHE);
-
-		TxCache::save(cachepath.c_str(), filename.c_str(), config);
-	}
-#endif
+	/* textures are written to the cache file as they are added. TxCache closes it. */
 }
 
-TxTexCache::TxTexCache(int options, int cachesize, const wchar_t *path, const wchar_t *ident,
+TxTexCache::TxTexCache(int options, int cachesize, int hashid, const wchar_t *path, const wchar_t *ident,
 					   dispInfoFuncExt callback
-					   ) : TxCache((options & ~GZ_HIRESTEXCACHE), cachesize, path, ident, callback)
+					   ) : TxCache((options & ~(GZ_HIRESTEXCACHE | COMPRESS_HIRESTEX)), cachesize, path, ident, callback)
 {
 	/* assert local options */
 	if (_path.empty() || _ident.empty() || !_cacheSize)
@@ -61,14 +49,16 @@ TxTexCache::TxTexCache(int options, int cachesize, const wchar_t *path, const wc
 #if DUMP_CACHE
 	if (_options & DUMP_TEXCACHE) {
 		/* find it on disk */
-		tx_wstring filename = _ident + wst("_MEMORYCACHE.") + TEXCACHE_EXT;
+		tx_wstring filename = _ident + wst("_MEMORYCACHE.") + TEXSTORAGE_EXT;
 		removeColon(filename);
 		tx_wstring cachepath(_path);
 		cachepath += OSAL_DIR_SEPARATOR_STR;
 		cachepath += wst("cache");
-		int config = _options & (FILTER_MASK | ENHANCEMENT_MASK | FORCE16BPP_TEX | GZ_TEXCACHE);
+		int config = _options & (FILTER_MASK | ENHANCEMENT_MASK | FORCE16BPP_TEX | GZ_TEXCACHE | COMPRESS_TEX | ETC2_COMPRESSION);
 
-		TxCache::load(cachepath.c_str(), filename.c_str(), config);
+		/* entries are read on demand. older single stream caches are keyed
+		 * by a previous texture hash and are not imported. */
+		TxCache::openFile(cachepath.c_str(), filename.c_str(), config, hashid);
 	}
 #endif
 }
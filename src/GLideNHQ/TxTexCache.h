@@ -30,7 +30,7 @@ class TxTexCache : public TxCache
 {
 public:
   ~TxTexCache();
-  TxTexCache(int options, int cachesize, const wchar_t *path, const wchar_t *ident,
+  TxTexCache(int options, int cachesize, int hashid, const wchar_t *path, const wchar_t *ident,
              dispInfoFuncExt callback);
   boolean add(uint64 checksum, /* checksum hi:palette low:texture */
               GHQTexInfo *info);
@@ -0,0 +1,156 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "TxThreadPool.h"
+#include "TxUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+struct ParallelJob
+{
+  std::atomic<uint32> next;
+  std::atomic<uint32> done;
+  uint32 count;
+  const std::function<void(uint32)> *task;
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  ParallelJob(uint32 _count, const std::function<void(uint32)> *_task)
+    : next(0), done(0), count(_count), task(_task) {}
+
+  void run()
+  {
+    uint32 i;
+    while ((i = next++) < count) {
+      (*task)(i);
+      if (++done == count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+      }
+    }
+  }
+};
+}
+
+TxThreadPool::TxThreadPool() : _stop(0)
+{
+}
+
+TxThreadPool::~TxThreadPool()
+{
+  shutdown();
+}
+
+void
+TxThreadPool::start()
+{
+  /* called with _mutex held */
+  if (!_workers.empty())
+    return;
+
+  _stop = 0;
+  const int numcore = TxUtil::getNumberofProcessors();
+  for (int i = 1; i < numcore; ++i)
+    _workers.emplace_back(&TxThreadPool::worker, this);
+}
+
+void
+TxThreadPool::shutdown()
+{
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = 1;
+    workers.swap(_workers);
+    _tasks.clear();
+  }
+  _cv.notify_all();
+  for (auto & thread : workers)
+    thread.join();
+}
+
+void
+TxThreadPool::worker()
+{
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cv.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+      if (_stop)
+        return;
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+    task();
+  }
+}
+
+uint32
+TxThreadPool::concurrency()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  start();
+  return (uint32)_workers.size() + 1;
+}
+
+void
+TxThreadPool::parallelFor(uint32 count, const std::function<void(uint32)> &task)
+{
+  if (count == 0)
+    return;
+
+  uint32 helpers = 0;
+  auto job = std::make_shared<ParallelJob>(count, &task);
+  if (count > 1) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    start();
+    helpers = std::min((uint32)_workers.size(), count - 1);
+    for (uint32 i = 0; i < helpers; ++i)
+      _tasks.emplace_back([job]{ job->run(); });
+  }
+  if (helpers == 1)
+    _cv.notify_one();
+  else if (helpers > 1)
+    _cv.notify_all();
+
+  job->run();
+
+  std::unique_lock<std::mutex> lock(job->mutex);
+  job->cv.wait(lock, [&job]{ return job->done == job->count; });
+}
+
+void
+TxThreadPool::post(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    start();
+    if (!_workers.empty()) {
+      _tasks.emplace_back(std::move(task));
+      task = nullptr;
+    }
+  }
+  if (task)
+    task();
+  else
+    _cv.notify_one();
+}
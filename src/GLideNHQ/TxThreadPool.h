@@ -0,0 +1,65 @@
+/*
+ * Texture Filtering
+ * Version:  1.0
+ *
+ * this is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * this is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Make; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __TXTHREADPOOL_H__
+#define __TXTHREADPOOL_H__
+
+#include "TxInternal.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Worker threads shared by the texture filters and loaders.
+ * Workers are started on first use and stopped by shutdown().
+ */
+class TxThreadPool
+{
+private:
+  std::vector<std::thread> _workers;
+  std::deque< std::function<void()> > _tasks;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  boolean _stop;
+  TxThreadPool();
+  void start();
+  void worker();
+public:
+  static TxThreadPool* getInstance() {
+    static TxThreadPool txThreadPool;
+    return &txThreadPool;
+  }
+  ~TxThreadPool();
+  void shutdown();
+
+  /* number of threads a parallelFor may run on, including the caller */
+  uint32 concurrency();
+
+  /* calls task(i) for i in [0, count) and returns when all calls are done.
+   * the calling thread takes part, so it is safe to call from a task. */
+  void parallelFor(uint32 count, const std::function<void(uint32)> &task);
+
+  /* runs task on a worker thread and returns at once.
+   * without workers the task runs on the calling thread. */
+  void post(std::function<void()> task);
+};
+
+#endif /* __TXTHREADPOOL_H__ */
@@ -22,6 +22,7 @@
  */
 
 #include "TxUtil.h"
+#include "TxCompress.h"
 #include "TxDbg.h"
 #include <zlib.h>
 #include <assert.h>
@@ -72,6 +73,11 @@ TxUtil::sizeofTx(int width, int height, uint16 format)
 	case GL_RGBA8:
 		dataSize = (width * height) << 2;
 	break;
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RGB8_ETC2:
+		dataSize = TxCompress::sizeofBlocks(width, height, format);
+	break;
 	default:
 		/* unsupported format */
 		DBG_INFO(80, wst("Error: cannot get size. unsupported gfmt:%x\n"), format);
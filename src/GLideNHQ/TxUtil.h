@@ -31,6 +31,7 @@
 
 /* extension for cache files */
 #define TEXCACHE_EXT wst("htc")
+#define TEXSTORAGE_EXT wst("hts")
 
 #include <vector>
 
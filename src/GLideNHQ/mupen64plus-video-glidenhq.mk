@@ -23,6 +23,8 @@ LOCAL_SRC_FILES :=                          \
     $(SRCDIR)/TextureFilters_hq4x.cpp       \
     $(SRCDIR)/TextureFilters_xbrz.cpp       \
     $(SRCDIR)/TxCache.cpp                   \
+    $(SRCDIR)/TxCacheFile.cpp               \
+    $(SRCDIR)/TxCompress.cpp                \
     $(SRCDIR)/TxDbg.cpp                     \
     $(SRCDIR)/TxFilter.cpp                  \
     $(SRCDIR)/TxFilterExport.cpp            \
@@ -31,6 +33,7 @@ LOCAL_SRC_FILES :=                          \
     $(SRCDIR)/TxQuantize.cpp                \
     $(SRCDIR)/TxReSample.cpp                \
     $(SRCDIR)/TxTexCache.cpp                \
+    $(SRCDIR)/TxThreadPool.cpp              \
     $(SRCDIR)/TxUtil.cpp                    \
     $(SRCDIR)/txWidestringWrapper.cpp       \
 
@@ -36,6 +36,8 @@ void _loadSettings(QSettings & settings)
 	config.texture.maxAnisotropy = settings.value("maxAnisotropy", config.texture.maxAnisotropy).toInt();
 	config.texture.bilinearMode = settings.value("bilinearMode", config.texture.bilinearMode).toInt();
 	config.texture.maxBytes = settings.value("maxBytes", config.texture.maxBytes).toInt();
+	config.texture.cachePolicy = settings.value("cachePolicy", config.texture.cachePolicy).toInt();
+	config.texture.enableTextureArray = settings.value("enableTextureArray", config.texture.enableTextureArray).toInt();
 	config.texture.screenShotFormat = settings.value("screenShotFormat", config.texture.screenShotFormat).toInt();
 	settings.endGroup();
 
@@ -43,6 +45,9 @@ void _loadSettings(QSettings & settings)
 	config.generalEmulation.enableNoise = settings.value("enableNoise", config.generalEmulation.enableNoise).toInt();
 	config.generalEmulation.enableLOD = settings.value("enableLOD", config.generalEmulation.enableLOD).toInt();
 	config.generalEmulation.enableHWLighting = settings.value("enableHWLighting", config.generalEmulation.enableHWLighting).toInt();
+	config.generalEmulation.enableShaderLighting = settings.value("enableShaderLighting", config.generalEmulation.enableShaderLighting).toInt();
+	config.generalEmulation.enableVertexCache = settings.value("enableVertexCache", config.generalEmulation.enableVertexCache).toInt();
+	config.generalEmulation.enableDrawBatching = settings.value("enableDrawBatching", config.generalEmulation.enableDrawBatching).toInt();
 	config.generalEmulation.enableShadersStorage = settings.value("enableShadersStorage", config.generalEmulation.enableShadersStorage).toInt();
 	config.generalEmulation.enableCustomSettings = settings.value("enableCustomSettings", config.generalEmulation.enableCustomSettings).toInt();
 	config.generalEmulation.correctTexrectCoords = settings.value("correctTexrectCoords", config.generalEmulation.correctTexrectCoords).toInt();
@@ -75,8 +80,11 @@ void _loadSettings(QSettings & settings)
 	config.textureFilter.txHiresFullAlphaChannel = settings.value("txHiresFullAlphaChannel", config.textureFilter.txHiresFullAlphaChannel).toInt();
 	config.textureFilter.txHresAltCRC = settings.value("txHresAltCRC", config.textureFilter.txHresAltCRC).toInt();
 	config.textureFilter.txDump = settings.value("txDump", config.textureFilter.txDump).toInt();
+	config.textureFilter.txHiresStream = settings.value("txHiresStream", config.textureFilter.txHiresStream).toInt();
+	config.textureFilter.txHiresCacheSize = settings.value("txHiresCacheSize", config.textureFilter.txHiresCacheSize).toInt();
 	config.textureFilter.txForce16bpp = settings.value("txForce16bpp", config.textureFilter.txForce16bpp).toInt();
 	config.textureFilter.txCacheCompression = settings.value("txCacheCompression", config.textureFilter.txCacheCompression).toInt();
+	config.textureFilter.txBlockCompression = settings.value("txBlockCompression", config.textureFilter.txBlockCompression).toInt();
 	config.textureFilter.txSaveCache = settings.value("txSaveCache", config.textureFilter.txSaveCache).toInt();
 	QString txPath = QString::fromWCharArray(config.textureFilter.txPath);
 	config.textureFilter.txPath[settings.value("txPath", txPath).toString().toWCharArray(config.textureFilter.txPath)] = L'\0';
@@ -114,11 +122,14 @@ void _loadSettings(QSettings & settings)
 	config.onScreenDisplay.fps = settings.value("showFPS", config.onScreenDisplay.fps).toInt();
 	config.onScreenDisplay.vis = settings.value("showVIS", config.onScreenDisplay.vis).toInt();
 	config.onScreenDisplay.percent = settings.value("showPercent", config.onScreenDisplay.percent).toInt();
+	config.onScreenDisplay.gpuTime = settings.value("showGPUTime", config.onScreenDisplay.gpuTime).toInt();
+	config.onScreenDisplay.statistics = settings.value("showStatistics", config.onScreenDisplay.statistics).toInt();
 	config.onScreenDisplay.pos = settings.value("osdPos", config.onScreenDisplay.pos).toInt();
 	settings.endGroup();
 
 	settings.beginGroup("debug");
 	config.debug.dumpMode = settings.value("dumpMode", config.debug.dumpMode).toInt();
+	config.debug.frameCapture = settings.value("frameCapture", config.debug.frameCapture).toInt();
 	settings.endGroup();
 }
 
@@ -167,6 +178,8 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("maxAnisotropy", config.texture.maxAnisotropy);
 	settings.setValue("bilinearMode", config.texture.bilinearMode);
 	settings.setValue("maxBytes", config.texture.maxBytes);
+	settings.setValue("cachePolicy", config.texture.cachePolicy);
+	settings.setValue("enableTextureArray", config.texture.enableTextureArray);
 	settings.setValue("screenShotFormat", config.texture.screenShotFormat);
 	settings.endGroup();
 
@@ -174,6 +187,9 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("enableNoise", config.generalEmulation.enableNoise);
 	settings.setValue("enableLOD", config.generalEmulation.enableLOD);
 	settings.setValue("enableHWLighting", config.generalEmulation.enableHWLighting);
+	settings.setValue("enableShaderLighting", config.generalEmulation.enableShaderLighting);
+	settings.setValue("enableVertexCache", config.generalEmulation.enableVertexCache);
+	settings.setValue("enableDrawBatching", config.generalEmulation.enableDrawBatching);
 	settings.setValue("enableShadersStorage", config.generalEmulation.enableShadersStorage);
 	settings.setValue("enableCustomSettings", config.generalEmulation.enableCustomSettings);
 	settings.setValue("correctTexrectCoords", config.generalEmulation.correctTexrectCoords);
@@ -205,8 +221,11 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("txHiresFullAlphaChannel", config.textureFilter.txHiresFullAlphaChannel);
 	settings.setValue("txHresAltCRC", config.textureFilter.txHresAltCRC);
 	settings.setValue("txDump", config.textureFilter.txDump);
+	settings.setValue("txHiresStream", config.textureFilter.txHiresStream);
+	settings.setValue("txHiresCacheSize", config.textureFilter.txHiresCacheSize);
 	settings.setValue("txForce16bpp", config.textureFilter.txForce16bpp);
 	settings.setValue("txCacheCompression", config.textureFilter.txCacheCompression);
+	settings.setValue("txBlockCompression", config.textureFilter.txBlockCompression);
 	settings.setValue("txSaveCache", config.textureFilter.txSaveCache);
 	settings.setValue("txPath", QString::fromWCharArray(config.textureFilter.txPath));
 	settings.endGroup();
@@ -234,11 +253,14 @@ void writeSettings(const QString & _strIniFolder)
 	settings.setValue("showFPS", config.onScreenDisplay.fps);
 	settings.setValue("showVIS", config.onScreenDisplay.vis);
 	settings.setValue("showPercent", config.onScreenDisplay.percent);
+	settings.setValue("showGPUTime", config.onScreenDisplay.gpuTime);
+	settings.setValue("showStatistics", config.onScreenDisplay.statistics);
 	settings.setValue("osdPos", config.onScreenDisplay.pos);
 	settings.endGroup();
 
 	settings.beginGroup("debug");
 	settings.setValue("dumpMode", config.debug.dumpMode);
+	settings.setValue("frameCapture", config.debug.frameCapture);
 	settings.endGroup();
 }
 
@@ -75,7 +75,9 @@ namespace graphics {
 
 		u32 heightOffset = 0;
 		u32 stride = 0;
+		gfxContext.beginGPUTimer(GPUTimerStage::ReadBack);
 		const u8* pixelData = _readPixels(params, heightOffset, stride);
+		gfxContext.endGPUTimer(GPUTimerStage::ReadBack);
 
 		if (pixelData == nullptr)
 			return nullptr;
@@ -9,11 +9,13 @@ namespace graphics {
 		_vecOptions.push_back(config.video.multisampling > 0 ? 1 : 0);
 		_vecOptions.push_back(config.texture.bilinearMode);
 		_vecOptions.push_back(config.generalEmulation.enableHWLighting);
+		_vecOptions.push_back(config.generalEmulation.enableShaderLighting);
 		_vecOptions.push_back(config.generalEmulation.enableNoise);
 		_vecOptions.push_back(config.generalEmulation.enableLOD);
 		_vecOptions.push_back(config.frameBufferEmulation.N64DepthCompare);
 		_vecOptions.push_back(config.generalEmulation.enableLegacyBlending);
 		_vecOptions.push_back(config.generalEmulation.enableFragmentDepthWrite);
+		_vecOptions.push_back(config.texture.enableTextureArray);
 	}
 
 }
@@ -105,6 +105,16 @@ void Context::update2DTexture(const UpdateTextureDataParams & _params)
 	m_impl->update2DTexture(_params);
 }
 
+void Context::initTextureArray(const InitTextureParams & _params)
+{
+	m_impl->initTextureArray(_params);
+}
+
+void Context::updateTextureArray(const UpdateTextureDataParams & _params)
+{
+	m_impl->updateTextureArray(_params);
+}
+
 void Context::setTextureParameters(const TexParameters & _parameters)
 {
 	m_impl->setTextureParameters(_parameters);
@@ -204,14 +214,24 @@ CombinerProgram * Context::createCombinerProgram(Combiner & _color, Combiner & _
 	return m_impl->createCombinerProgram(_color, _alpha, _key);
 }
 
-bool Context::saveShadersStorage(const Combiners & _combiners)
+bool Context::openShadersStorage()
+{
+	return m_impl->openShadersStorage();
+}
+
+void Context::closeShadersStorage()
 {
-	return m_impl->saveShadersStorage(_combiners);
+	m_impl->closeShadersStorage();
 }
 
-bool Context::loadShadersStorage(Combiners & _combiners)
+CombinerProgram * Context::loadShaderProgram(const CombinerKey & _key)
 {
-	return m_impl->loadShadersStorage(_combiners);
+	return m_impl->loadShaderProgram(_key);
+}
+
+bool Context::storeShaderProgram(CombinerProgram * _program)
+{
+	return m_impl->storeShaderProgram(_program);
 }
 
 ShaderProgram * Context::createDepthFogShader()
@@ -239,14 +259,14 @@ ShaderProgram * Context::createTexrectCopyShader()
 	return m_impl->createTexrectCopyShader();
 }
 
-ShaderProgram * Context::createGammaCorrectionShader()
+ShaderProgram * Context::createPostProcessingShader(u32 _stages)
 {
-	return m_impl->createGammaCorrectionShader();
+	return m_impl->createPostProcessingShader(_stages);
 }
 
-ShaderProgram * Context::createOrientationCorrectionShader()
+DualFilterShaderProgram * Context::createDualFilterShader(DualFilterPass _pass)
 {
-	return m_impl->createOrientationCorrectionShader();
+	return m_impl->createDualFilterShader(_pass);
 }
 
 TextDrawerShaderProgram * Context::createTextDrawerShader()
@@ -274,6 +294,11 @@ void Context::drawLine(f32 _width, SPVertex * _vertices)
 	m_impl->drawLine(_width, _vertices);
 }
 
+void Context::flushDraws()
+{
+	m_impl->flushDraws();
+}
+
 f32 Context::getMaxLineWidth()
 {
 	return m_impl->getMaxLineWidth();
@@ -293,3 +318,33 @@ bool Context::isFramebufferError() const
 {
 	return m_impl->isFramebufferError();
 }
+
+void Context::beginGPUTimer(GPUTimerStage _stage)
+{
+	m_impl->beginGPUTimer(_stage);
+}
+
+void Context::endGPUTimer(GPUTimerStage _stage)
+{
+	m_impl->endGPUTimer(_stage);
+}
+
+void Context::resolveGPUTimers()
+{
+	m_impl->resolveGPUTimers();
+}
+
+bool Context::getGPUTimings(GPUTimings & _timings) const
+{
+	return m_impl->getGPUTimings(_timings);
+}
+
+void Context::frameEnd()
+{
+	m_impl->frameEnd();
+}
+
+bool Context::getDrawBufferStats(DrawBufferStats & _stats) const
+{
+	return m_impl->getDrawBufferStats(_stats);
+}
@@ -23,7 +23,35 @@ namespace graphics {
 		WeakBlitFramebuffer,
 		DepthFramebufferTextures,
 		ShaderProgramBinary,
-		ImageTextures
+		ImageTextures,
+		GPUTimers,
+		VertexShaderLighting,
+		TextureCompressionS3TC,
+		TextureCompressionETC2,
+		PersistentPixelBuffers,
+		TextureArrays
+	};
+
+	enum class GPUTimerStage {
+		Draw,
+		Blit,
+		PostProcessing,
+		ReadBack,
+		Count
+	};
+
+	struct GPUTimings {
+		f32 stageTime[u32(GPUTimerStage::Count)];
+		f32 frameTime;
+	};
+
+	struct DrawBufferStats {
+		u32 size;
+		u32 frameBytes;
+		u32 peakFrameBytes;
+		u32 stalls;
+		u32 draws;
+		u32 submits;
 	};
 
 	class ContextImpl;
@@ -76,6 +104,7 @@ namespace graphics {
 			u32 height = 0;
 			u32 mipMapLevel = 0;
 			u32 mipMapLevels = 1;
+			u32 layers = 0;
 			ColorFormatParam format;
 			InternalColorFormatParam internalFormat;
 			DatatypeParam dataType;
@@ -93,6 +122,7 @@ namespace graphics {
 			u32 width = 0;
 			u32 height = 0;
 			u32 mipMapLevel = 0;
+			u32 layer = 0;
 			ColorFormatParam format;
 			InternalColorFormatParam internalFormat;
 			DatatypeParam dataType;
@@ -101,6 +131,10 @@ namespace graphics {
 
 		void update2DTexture(const UpdateTextureDataParams & _params);
 
+		void initTextureArray(const InitTextureParams & _params);
+
+		void updateTextureArray(const UpdateTextureDataParams & _params);
+
 		struct TexParameters {
 			ObjectHandle handle;
 			TextureUnitParam textureUnitIndex{0};
@@ -202,9 +236,13 @@ namespace graphics {
 
 		CombinerProgram * createCombinerProgram(Combiner & _color, Combiner & _alpha, const CombinerKey & _key);
 
-		bool saveShadersStorage(const Combiners & _combiners);
+		bool openShadersStorage();
+
+		void closeShadersStorage();
 
-		bool loadShadersStorage(Combiners & _combiners);
+		CombinerProgram * loadShaderProgram(const CombinerKey & _key);
+
+		bool storeShaderProgram(CombinerProgram * _program);
 
 		ShaderProgram * createDepthFogShader();
 
@@ -216,9 +254,9 @@ namespace graphics {
 
 		ShaderProgram * createTexrectCopyShader();
 
-		ShaderProgram * createGammaCorrectionShader();
+		ShaderProgram * createPostProcessingShader(u32 _stages);
 
-		ShaderProgram * createOrientationCorrectionShader();
+		DualFilterShaderProgram * createDualFilterShader(DualFilterPass _pass);
 
 		TextDrawerShaderProgram * createTextDrawerShader();
 
@@ -233,8 +271,10 @@ namespace graphics {
 			u32 verticesCount = 0;
 			u32 elementsCount = 0;
 			bool flatColors = false;
+			bool shaderLighting = false;
 			SPVertex * vertices = nullptr;
 			void * elements = nullptr;
+			const TexArrayAttribs * texArray = nullptr;
 			const CombinerProgram * combiner = nullptr;
 		};
 
@@ -253,6 +293,8 @@ namespace graphics {
 
 		void drawLine(f32 _width, SPVertex * _vertices);
 
+		void flushDraws();
+
 		f32 getMaxLineWidth();
 
 		/*---------------Misc-------------*/
@@ -263,6 +305,20 @@ namespace graphics {
 
 		bool isFramebufferError() const;
 
+		/*---------------Profiling-------------*/
+
+		void beginGPUTimer(GPUTimerStage _stage);
+
+		void endGPUTimer(GPUTimerStage _stage);
+
+		void resolveGPUTimers();
+
+		bool getGPUTimings(GPUTimings & _timings) const;
+
+		void frameEnd();
+
+		bool getDrawBufferStats(DrawBufferStats & _stats) const;
+
 		static bool imageTextures;
 		static bool multisampling;
 
@@ -27,6 +27,8 @@ namespace graphics {
 		virtual void deleteTexture(ObjectHandle _name) = 0;
 		virtual void init2DTexture(const Context::InitTextureParams & _params) = 0;
 		virtual void update2DTexture(const Context::UpdateTextureDataParams & _params) = 0;
+		virtual void initTextureArray(const Context::InitTextureParams & _params) = 0;
+		virtual void updateTextureArray(const Context::UpdateTextureDataParams & _params) = 0;
 		virtual void setTextureParameters(const Context::TexParameters & _parameters) = 0;
 		virtual void bindTexture(const Context::BindTextureParameters & _params) = 0;
 		virtual void setTextureUnpackAlignment(s32 _param) = 0;
@@ -46,24 +48,33 @@ namespace graphics {
 		virtual PixelReadBuffer * createPixelReadBuffer(size_t _sizeInBytes) = 0;
 		virtual ColorBufferReader * createColorBufferReader(CachedTexture * _pTexture) = 0;
 		virtual CombinerProgram * createCombinerProgram(Combiner & _color, Combiner & _alpha, const CombinerKey & _key) = 0;
-		virtual bool saveShadersStorage(const Combiners & _combiners) = 0;
-		virtual bool loadShadersStorage(Combiners & _combiners) = 0;
+		virtual bool openShadersStorage() = 0;
+		virtual void closeShadersStorage() = 0;
+		virtual CombinerProgram * loadShaderProgram(const CombinerKey & _key) = 0;
+		virtual bool storeShaderProgram(CombinerProgram * _program) = 0;
 		virtual ShaderProgram * createDepthFogShader() = 0;
 		virtual ShaderProgram * createMonochromeShader() = 0;
 		virtual TexrectDrawerShaderProgram * createTexrectDrawerDrawShader() = 0;
 		virtual ShaderProgram * createTexrectDrawerClearShader() = 0;
 		virtual ShaderProgram * createTexrectCopyShader() = 0;
-		virtual ShaderProgram * createGammaCorrectionShader() = 0;
-		virtual ShaderProgram * createOrientationCorrectionShader() = 0;
+		virtual ShaderProgram * createPostProcessingShader(u32 _stages) = 0;
+		virtual DualFilterShaderProgram * createDualFilterShader(DualFilterPass _pass) = 0;
 		virtual TextDrawerShaderProgram * createTextDrawerShader() = 0;
 		virtual void resetShaderProgram() = 0;
 		virtual void drawTriangles(const Context::DrawTriangleParameters & _params) = 0;
 		virtual void drawRects(const Context::DrawRectParameters & _params) = 0;
 		virtual void drawLine(f32 _width, SPVertex * _vertices) = 0;
+		virtual void flushDraws() = 0;
 		virtual f32 getMaxLineWidth() = 0;
 		virtual bool isSupported(SpecialFeatures _feature) const = 0;
 		virtual bool isError() const = 0;
 		virtual bool isFramebufferError() const = 0;
+		virtual void beginGPUTimer(GPUTimerStage _stage) = 0;
+		virtual void endGPUTimer(GPUTimerStage _stage) = 0;
+		virtual void resolveGPUTimers() = 0;
+		virtual bool getGPUTimings(GPUTimings & _timings) const = 0;
+		virtual void frameEnd() = 0;
+		virtual bool getDrawBufferStats(DrawBufferStats & _stats) const = 0;
 	};
 
 }
@@ -174,6 +174,9 @@ PFNGLPROGRAMBINARYPROC g_glProgramBinary;
 PFNGLPROGRAMPARAMETERIPROC g_glProgramParameteri;
 
 PFNGLTEXSTORAGE2DPROC g_glTexStorage2D;
+PFNGLTEXIMAGE3DPROC g_glTexImage3D;
+PFNGLTEXSUBIMAGE3DPROC g_glTexSubImage3D;
+PFNGLTEXSTORAGE3DPROC g_glTexStorage3D;
 PFNGLTEXTURESTORAGE2DPROC g_glTextureStorage2D;
 PFNGLTEXTURESUBIMAGE2DPROC g_glTextureSubImage2D;
 PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC g_glTextureStorage2DMultisample;
@@ -184,8 +187,19 @@ PFNGLCREATEBUFFERSPROC g_glCreateBuffers;
 PFNGLCREATEFRAMEBUFFERSPROC g_glCreateFramebuffers;
 PFNGLNAMEDFRAMEBUFFERTEXTUREPROC g_glNamedFramebufferTexture;
 PFNGLDRAWELEMENTSBASEVERTEXPROC g_glDrawElementsBaseVertex;
+PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC g_glMultiDrawElementsBaseVertex;
+PFNGLMULTIDRAWARRAYSPROC g_glMultiDrawArrays;
 PFNGLFLUSHMAPPEDBUFFERRANGEPROC g_glFlushMappedBufferRange;
 
+PFNGLGENQUERIESPROC g_glGenQueries;
+PFNGLDELETEQUERIESPROC g_glDeleteQueries;
+PFNGLQUERYCOUNTERPROC g_glQueryCounter;
+PFNGLGETQUERYOBJECTIVPROC g_glGetQueryObjectiv;
+PFNGLGETQUERYOBJECTUI64VPROC g_glGetQueryObjectui64v;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC g_glCompressedTexImage2D;
+PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC g_glCompressedTexSubImage2D;
+PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC g_glCompressedTextureSubImage2D;
+
 void initGLFunctions()
 {
 #ifdef VC
@@ -309,6 +323,9 @@ void initGLFunctions()
 	GL_GET_PROC_ADR(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri);
 
 	GL_GET_PROC_ADR(PFNGLTEXSTORAGE2DPROC, glTexStorage2D);
+	GL_GET_PROC_ADR(PFNGLTEXIMAGE3DPROC, glTexImage3D);
+	GL_GET_PROC_ADR(PFNGLTEXSUBIMAGE3DPROC, glTexSubImage3D);
+	GL_GET_PROC_ADR(PFNGLTEXSTORAGE3DPROC, glTexStorage3D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESTORAGE2DPROC, glTextureStorage2D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESUBIMAGE2DPROC, glTextureSubImage2D);
 	GL_GET_PROC_ADR(PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC, glTextureStorage2DMultisample);
@@ -320,5 +337,16 @@ void initGLFunctions()
 	GL_GET_PROC_ADR(PFNGLCREATEFRAMEBUFFERSPROC, glCreateFramebuffers);
 	GL_GET_PROC_ADR(PFNGLNAMEDFRAMEBUFFERTEXTUREPROC, glNamedFramebufferTexture);
 	GL_GET_PROC_ADR(PFNGLDRAWELEMENTSBASEVERTEXPROC, glDrawElementsBaseVertex);
+	GL_GET_PROC_ADR(PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC, glMultiDrawElementsBaseVertex);
+	GL_GET_PROC_ADR(PFNGLMULTIDRAWARRAYSPROC, glMultiDrawArrays);
 	GL_GET_PROC_ADR(PFNGLFLUSHMAPPEDBUFFERRANGEPROC, glFlushMappedBufferRange);
+
+	GL_GET_PROC_ADR(PFNGLGENQUERIESPROC, glGenQueries);
+	GL_GET_PROC_ADR(PFNGLDELETEQUERIESPROC, glDeleteQueries);
+	GL_GET_PROC_ADR(PFNGLQUERYCOUNTERPROC, glQueryCounter);
+	GL_GET_PROC_ADR(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv);
+	GL_GET_PROC_ADR(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v);
+	GL_GET_PROC_ADR(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D);
+	GL_GET_PROC_ADR(PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC, glCompressedTexSubImage2D);
+	GL_GET_PROC_ADR(PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC, glCompressedTextureSubImage2D);
 }
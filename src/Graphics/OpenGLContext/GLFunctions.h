@@ -176,7 +176,7 @@ extern PFNGLBLENDCOLORPROC g_glBlendColor;
 #define glInvalidateFramebuffer(...) CHECKED_GL_FUNCTION(g_glInvalidateFramebuffer, __VA_ARGS__)
 #define glBufferStorage(...) CHECKED_GL_FUNCTION(g_glBufferStorage, __VA_ARGS__)
 #define glFenceSync(...) CHECKED_GL_FUNCTION_WITH_RETURN(g_glFenceSync, GLsync, __VA_ARGS__)
-#define glClientWaitSync(...) CHECKED_GL_FUNCTION(g_glClientWaitSync, __VA_ARGS__)
+#define glClientWaitSync(...) CHECKED_GL_FUNCTION_WITH_RETURN(g_glClientWaitSync, GLenum, __VA_ARGS__)
 #define glDeleteSync(...) CHECKED_GL_FUNCTION(g_glDeleteSync, __VA_ARGS__)
 
 #define glGetUniformBlockIndex(...) CHECKED_GL_FUNCTION(g_glGetUniformBlockIndex, __VA_ARGS__)
@@ -192,6 +192,9 @@ extern PFNGLBLENDCOLORPROC g_glBlendColor;
 #define glProgramParameteri(...) CHECKED_GL_FUNCTION(g_glProgramParameteri, __VA_ARGS__)
 
 #define glTexStorage2D(...) CHECKED_GL_FUNCTION(g_glTexStorage2D, __VA_ARGS__)
+#define glTexImage3D(...) CHECKED_GL_FUNCTION(g_glTexImage3D, __VA_ARGS__)
+#define glTexSubImage3D(...) CHECKED_GL_FUNCTION(g_glTexSubImage3D, __VA_ARGS__)
+#define glTexStorage3D(...) CHECKED_GL_FUNCTION(g_glTexStorage3D, __VA_ARGS__)
 #define glTextureStorage2D(...) CHECKED_GL_FUNCTION(g_glTextureStorage2D, __VA_ARGS__)
 #define glTextureSubImage2D(...) CHECKED_GL_FUNCTION(g_glTextureSubImage2D, __VA_ARGS__)
 #define glTextureStorage2DMultisample(...) CHECKED_GL_FUNCTION(g_glTextureStorage2DMultisample, __VA_ARGS__)
@@ -202,8 +205,19 @@ extern PFNGLBLENDCOLORPROC g_glBlendColor;
 #define glCreateFramebuffers(...) CHECKED_GL_FUNCTION(g_glCreateFramebuffers, __VA_ARGS__)
 #define glNamedFramebufferTexture(...) CHECKED_GL_FUNCTION(g_glNamedFramebufferTexture, __VA_ARGS__)
 #define glDrawElementsBaseVertex(...) CHECKED_GL_FUNCTION(g_glDrawElementsBaseVertex, __VA_ARGS__)
+#define glMultiDrawElementsBaseVertex(...) CHECKED_GL_FUNCTION(g_glMultiDrawElementsBaseVertex, __VA_ARGS__)
+#define glMultiDrawArrays(...) CHECKED_GL_FUNCTION(g_glMultiDrawArrays, __VA_ARGS__)
 #define glFlushMappedBufferRange(...) CHECKED_GL_FUNCTION(g_glFlushMappedBufferRange, __VA_ARGS__)
 
+#define glGenQueries(...) CHECKED_GL_FUNCTION(g_glGenQueries, __VA_ARGS__)
+#define glDeleteQueries(...) CHECKED_GL_FUNCTION(g_glDeleteQueries, __VA_ARGS__)
+#define glQueryCounter(...) CHECKED_GL_FUNCTION(g_glQueryCounter, __VA_ARGS__)
+#define glGetQueryObjectiv(...) CHECKED_GL_FUNCTION(g_glGetQueryObjectiv, __VA_ARGS__)
+#define glGetQueryObjectui64v(...) CHECKED_GL_FUNCTION(g_glGetQueryObjectui64v, __VA_ARGS__)
+#define glCompressedTexImage2D(...) CHECKED_GL_FUNCTION(g_glCompressedTexImage2D, __VA_ARGS__)
+#define glCompressedTexSubImage2D(...) CHECKED_GL_FUNCTION(g_glCompressedTexSubImage2D, __VA_ARGS__)
+#define glCompressedTextureSubImage2D(...) CHECKED_GL_FUNCTION(g_glCompressedTextureSubImage2D, __VA_ARGS__)
+
 extern PFNGLCREATESHADERPROC g_glCreateShader;
 extern PFNGLCOMPILESHADERPROC g_glCompileShader;
 extern PFNGLSHADERSOURCEPROC g_glShaderSource;
@@ -286,6 +300,9 @@ extern PFNGLPROGRAMBINARYPROC g_glProgramBinary;
 extern PFNGLPROGRAMPARAMETERIPROC g_glProgramParameteri;
 
 extern PFNGLTEXSTORAGE2DPROC g_glTexStorage2D;
+extern PFNGLTEXIMAGE3DPROC g_glTexImage3D;
+extern PFNGLTEXSUBIMAGE3DPROC g_glTexSubImage3D;
+extern PFNGLTEXSTORAGE3DPROC g_glTexStorage3D;
 extern PFNGLTEXTURESTORAGE2DPROC g_glTextureStorage2D;
 extern PFNGLTEXTURESUBIMAGE2DPROC g_glTextureSubImage2D;
 extern PFNGLTEXTURESTORAGE2DMULTISAMPLEEXTPROC g_glTextureStorage2DMultisample;
@@ -296,8 +313,19 @@ extern PFNGLCREATEBUFFERSPROC g_glCreateBuffers;
 extern PFNGLCREATEFRAMEBUFFERSPROC g_glCreateFramebuffers;
 extern PFNGLNAMEDFRAMEBUFFERTEXTUREPROC g_glNamedFramebufferTexture;
 extern PFNGLDRAWELEMENTSBASEVERTEXPROC g_glDrawElementsBaseVertex;
+extern PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC g_glMultiDrawElementsBaseVertex;
+extern PFNGLMULTIDRAWARRAYSPROC g_glMultiDrawArrays;
 extern PFNGLFLUSHMAPPEDBUFFERRANGEPROC g_glFlushMappedBufferRange;
 
+extern PFNGLGENQUERIESPROC g_glGenQueries;
+extern PFNGLDELETEQUERIESPROC g_glDeleteQueries;
+extern PFNGLQUERYCOUNTERPROC g_glQueryCounter;
+extern PFNGLGETQUERYOBJECTIVPROC g_glGetQueryObjectiv;
+extern PFNGLGETQUERYOBJECTUI64VPROC g_glGetQueryObjectui64v;
+extern PFNGLCOMPRESSEDTEXIMAGE2DPROC g_glCompressedTexImage2D;
+extern PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC g_glCompressedTexSubImage2D;
+extern PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC g_glCompressedTextureSubImage2D;
+
 void initGLFunctions();
 
 template<typename F> void checked(F fn, const char* _functionName)
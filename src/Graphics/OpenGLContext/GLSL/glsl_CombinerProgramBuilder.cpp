@@ -214,6 +214,64 @@ public:
 	}
 };
 
+static
+bool _useShaderLighting(const opengl::GLInfo & _glinfo)
+{
+	return !_glinfo.isGLES2 &&
+		config.generalEmulation.enableShaderLighting != 0 &&
+		config.generalEmulation.enableHWLighting == 0;
+}
+
+static
+bool _useTextureArray(const opengl::GLInfo & _glinfo)
+{
+	return !_glinfo.isGLES2 && config.texture.enableTextureArray != 0;
+}
+
+// Texture array layer, size and sampler mode of both tiles, see TexArrayAttribs.
+// Passed per vertex, so draws with different array textures share one batch.
+static const char * _vertexShaderTexArray =
+	"IN mediump vec4 aTexArray0;						\n"
+	"IN mediump vec4 aTexArray1;						\n"
+	"flat OUT mediump vec4 vTexArray0;					\n"
+	"flat OUT mediump vec4 vTexArray1;					\n"
+	;
+
+// Lighting and texture generation of vertices with aLightState > 0, see SPLightState
+static
+std::string _vertexShaderLighting()
+{
+	std::stringstream ss;
+	ss << "IN mediump float aLightState;								\n"
+		"uniform highp vec4 uLightStates[" << LIGHTSTATES_SIZE * LIGHTSTATE_VEC4 << "];	\n"
+		"																\n"
+		"lowp vec3 calcLight(in int base, in mediump vec3 normal)		\n"
+		"{																\n"
+		"  int numLights = int(uLightStates[base + 18].x);				\n"
+		"  mediump vec3 color = uLightStates[base + 7 + numLights].rgb;	\n"
+		"  for (int i = 0; i < 7; ++i) {								\n"
+		"    if (i >= numLights) break;									\n"
+		"    color += max(dot(normal, uLightStates[base + i].xyz), 0.0) * uLightStates[base + 7 + i].rgb;\n"
+		"  }															\n"
+		"  return min(color, vec3(1.0));								\n"
+		"}																\n"
+		"																\n"
+		"highp vec2 calcTexGen(in int base, in mediump vec3 normal)		\n"
+		"{																\n"
+		"  highp vec4 params = uLightStates[base + 18];					\n"
+		"  highp vec3 dir = vec3(dot(uLightStates[base + 15].xyz, normal),	\n"
+		"                        dot(uLightStates[base + 16].xyz, normal),	\n"
+		"                        dot(uLightStates[base + 17].xyz, normal));	\n"
+		"  if (params.z == 0.0 && dot(dir, dir) > 0.0)					\n"
+		"    dir = normalize(dir);										\n"
+		"  if (params.y == 2.0)											\n"
+		"    return acos(clamp(-dir.xy, -1.0, 1.0)) * 325.94931;			\n"
+		"  return (dir.xy + 1.0) * 512.0;								\n"
+		"}																\n"
+		;
+	return ss.str();
+}
+
 class VertexShaderTexturedTriangle : public ShaderPart
 {
 public:
@@ -243,7 +301,14 @@ public:
 			"OUT mediump vec2 vTexCoord1;						\n"
 			"OUT mediump vec2 vLodTexCoord;						\n"
 			"OUT lowp float vNumLights;							\n"
-
+			;
+		const bool bTextureArray = _useTextureArray(_glinfo);
+		if (bTextureArray)
+			m_part += _vertexShaderTexArray;
+		const bool bShaderLighting = _useShaderLighting(_glinfo);
+		if (bShaderLighting)
+			m_part += _vertexShaderLighting();
+		m_part +=
 			"mediump vec2 calcTexCoord(in vec2 texCoord, in int idx)		\n"
 			"{																\n"
 			"    vec2 texCoordOut = texCoord*uCacheShiftScale[idx];			\n"
@@ -256,12 +321,32 @@ public:
 			"  gl_Position = aPosition;										\n"
 			"  vShadeColor = aColor;										\n"
 			"  vec2 texCoord = aTexCoord;									\n"
+			;
+		if (bShaderLighting) {
+			m_part +=
+				"  if (aLightState > 0.0) {										\n"
+				"    int base = (int(aLightState) - 1) * 19;					\n"
+				"    vShadeColor.rgb = calcLight(base, aColor.rgb);				\n"
+				"    if (uLightStates[base + 18].y != 0.0)						\n"
+				"      texCoord = calcTexGen(base, aColor.rgb);					\n"
+				"  }															\n"
+				;
+		}
+		m_part +=
 			"  texCoord *= uTexScale;										\n"
 			"  if (uTexturePersp == 0 && aModify[2] == 0.0) texCoord *= 0.5;\n"
 			"  vTexCoord0 = calcTexCoord(texCoord, 0);						\n"
 			"  vTexCoord1 = calcTexCoord(texCoord, 1);						\n"
 			"  vLodTexCoord = texCoord;										\n"
 			"  vNumLights = aNumLights;										\n"
+			;
+		if (bTextureArray) {
+			m_part +=
+				"  vTexArray0 = aTexArray0;										\n"
+				"  vTexArray1 = aTexArray1;										\n"
+				;
+		}
+		m_part +=
 			"  if (aModify != vec4(0.0)) {									\n"
 			"    if ((aModify[0]) != 0.0) {									\n"
 			"      gl_Position.xy = gl_Position.xy * uScreenCoordsScale + vec2(-1.0, 1.0);	\n"
@@ -274,7 +359,7 @@ public:
 			"  }															\n"
 			"  gl_Position.y = -gl_Position.y;								\n"
 			"  if (uFogUsage == 1) {										\n"
-			"    lowp vec4 shadeColor = aColor;								\n"
+			"    lowp vec4 shadeColor = vShadeColor;						\n"
 			"    if (aPosition.z < -aPosition.w && aModify[1] == 0.0)		\n"
 			"      shadeColor.a = -uFogScale.s + uFogScale.t;							\n"
 			"    else														\n"
@@ -311,11 +396,24 @@ public:
 			"									\n"
 			"OUT lowp vec4 vShadeColor;			\n"
 			"OUT lowp float vNumLights;			\n"
+			;
+		const bool bShaderLighting = _useShaderLighting(_glinfo);
+		if (bShaderLighting)
+			m_part += _vertexShaderLighting();
+		m_part +=
 			"																\n"
 			"void main()													\n"
 			"{																\n"
 			"  gl_Position = aPosition;										\n"
 			"  vShadeColor = aColor;										\n"
+			;
+		if (bShaderLighting) {
+			m_part +=
+				"  if (aLightState > 0.0)										\n"
+				"    vShadeColor.rgb = calcLight((int(aLightState) - 1) * 19, aColor.rgb);\n"
+				;
+		}
+		m_part +=
 			"  vNumLights = aNumLights;										\n"
 			"  if (aModify != vec4(0.0)) {									\n"
 			"    if ((aModify[0]) != 0.0) {									\n"
@@ -362,6 +460,11 @@ public:
 			"OUT mediump vec2 vTexCoord0;						\n"
 			"OUT mediump vec2 vTexCoord1;						\n"
 			"uniform lowp vec4 uRectColor;						\n"
+			;
+		const bool bTextureArray = _useTextureArray(_glinfo);
+		if (bTextureArray)
+			m_part += _vertexShaderTexArray;
+		m_part +=
 			"void main()										\n"
 			"{													\n"
 			"  gl_Position = aRectPosition;						\n"
@@ -370,6 +473,12 @@ public:
 			"  vTexCoord0 = aTexCoord0;							\n"
 			"  vTexCoord1 = aTexCoord1;							\n"
 		;
+		if (bTextureArray) {
+			m_part +=
+				"  vTexArray0 = aTexArray0;							\n"
+				"  vTexArray1 = aTexArray1;							\n"
+				;
+		}
 		if (!_glinfo.isGLESX) {
 			m_part +=
 				"  gl_ClipDistance[0] = gl_Position.w - gl_Position.z;			\n"
@@ -918,6 +1027,20 @@ public:
 	}
 };
 
+class ShaderFragmentHeaderReadTexArray : public ShaderPart
+{
+public:
+	ShaderFragmentHeaderReadTexArray(const opengl::GLInfo & _glinfo)
+	{
+		if (!_glinfo.isGLES2 && config.texture.enableTextureArray != 0) {
+			m_part =
+				"flat IN mediump vec4 vTexArray0;\n"
+				"flat IN mediump vec4 vTexArray1;\n"
+				"lowp vec4 readTexArray(in highp vec2 texCoord, in mediump vec4 texArray);\n";
+		}
+	}
+};
+
 class ShaderFragmentHeaderDither : public ShaderPart
 {
 public:
@@ -1100,15 +1223,22 @@ public:
 				"  lowp vec4 readtex0 = readTex(uTex0, vTexCoord0, uFbMonochrome[0], uFbFixedAlpha[0]); \n"
 				;
 		} else {
+			m_part =
+				"  lowp vec4 readtex0; \n"
+				;
+			if (config.texture.enableTextureArray != 0) {
+				m_part +=
+					"  if (vTexArray0.x >= 0.0) readtex0 = readTexArray(vTexCoord0, vTexArray0); \n"
+					"  else \n"
+					;
+			}
 			if (config.video.multisampling > 0) {
-				m_part =
-					"  lowp vec4 readtex0; \n"
+				m_part +=
 					"  if (uMSTexEnabled[0] == 0) READ_TEX(readtex0, uTex0, vTexCoord0, uFbMonochrome[0], uFbFixedAlpha[0]) \n"
 					"  else readtex0 = readTexMS(uMSTex0, vTexCoord0, uFbMonochrome[0], uFbFixedAlpha[0]); \n"
 					;
 			} else {
-				m_part =
-					"  lowp vec4 readtex0; \n"
+				m_part +=
 					"  READ_TEX(readtex0, uTex0, vTexCoord0, uFbMonochrome[0], uFbFixedAlpha[0]); \n"
 					;
 			}
@@ -1127,15 +1257,22 @@ public:
 				"  lowp vec4 readtex1 = readTex(uTex1, vTexCoord1, uFbMonochrome[1], uFbFixedAlpha[1]); \n"
 				;
 		} else {
+			m_part =
+				"  lowp vec4 readtex1; \n"
+				;
+			if (config.texture.enableTextureArray != 0) {
+				m_part +=
+					"  if (vTexArray1.x >= 0.0) readtex1 = readTexArray(vTexCoord1, vTexArray1); \n"
+					"  else \n"
+					;
+			}
 			if (config.video.multisampling > 0) {
-				m_part =
-					"  lowp vec4 readtex1; \n"
+				m_part +=
 					"  if (uMSTexEnabled[1] == 0)  READ_TEX(readtex1, uTex1, vTexCoord1, uFbMonochrome[1], uFbFixedAlpha[1]) \n"
 					"  else readtex1 = readTexMS(uMSTex1, vTexCoord1, uFbMonochrome[1], uFbFixedAlpha[1]); \n"
 					;
 			} else {
-				m_part =
-					"  lowp vec4 readtex1; \n"
+				m_part +=
 					"  READ_TEX(readtex1, uTex1, vTexCoord1, uFbMonochrome[1], uFbFixedAlpha[1]); \n"
 					;
 			}
@@ -1579,6 +1716,61 @@ public:
 					"}																			\n"
 				;
 			}
+			if (config.texture.enableTextureArray != 0) {
+				// Small textures share one texture array. Texels are fetched without
+				// sampler state, so wrap modes and filtering of the tile are applied here.
+				// texArray: layer, width, height, mode = wrapS | wrapT << 2 | filter << 4.
+				// wrap: 0 repeat, 1 mirrored repeat, 2 clamp to edge. filter: 0 nearest, 1 linear.
+				m_part +=
+					"uniform lowp sampler2DArray uTexArray;										\n"
+					"highp float wrapTexel(in highp float x, in highp float size, in lowp int wrap)	\n"
+					"{																			\n"
+					"  if (wrap == 2) return clamp(x, 0.0, size - 1.0);							\n"
+					"  if (wrap == 1) {															\n"
+					"    highp float x2 = x - 2.0*size*floor(x/(2.0*size));						\n"
+					"    return x2 < size ? x2 : 2.0*size - 1.0 - x2;							\n"
+					"  }																		\n"
+					"  return x - size*floor(x/size);											\n"
+					"}																			\n"
+					"lowp vec4 fetchTexArray(in highp vec2 texel, in mediump vec2 texSize, in lowp ivec2 wrap, in mediump int layer)	\n"
+					"{																			\n"
+					"  mediump ivec2 coord = ivec2(wrapTexel(texel.x, texSize.x, wrap.x), wrapTexel(texel.y, texSize.y, wrap.y));	\n"
+					"  return texelFetch(uTexArray, ivec3(coord, layer), 0);					\n"
+					"}																			\n"
+					"lowp vec4 readTexArray(in highp vec2 texCoord, in mediump vec4 texArray)	\n"
+					"{																			\n"
+					"  mediump int layer = int(texArray.x);										\n"
+					"  mediump vec2 texSize = texArray.yz;										\n"
+					"  lowp int mode = int(texArray.w);											\n"
+					"  lowp ivec2 wrap = ivec2(mode & 3, (mode >> 2) & 3);						\n"
+					"  lowp int filterMode = mode >> 4;											\n"
+					"  highp vec2 texel = texCoord * texSize;									\n"
+				;
+				if (config.texture.bilinearMode == BILINEAR_3POINT) {
+					m_part +=
+						"  if (uTextureFilterMode != 0) {											\n"
+						"    highp vec2 offset = fract(texel - vec2(0.5));							\n"
+						"    offset -= step(1.0, offset.x + offset.y);								\n"
+						"    lowp vec4 c0 = fetchTexArray(floor(texel - offset), texSize, wrap, layer);	\n"
+						"    lowp vec4 c1 = fetchTexArray(floor(texel - vec2(offset.x - sign(offset.x), offset.y)), texSize, wrap, layer);	\n"
+						"    lowp vec4 c2 = fetchTexArray(floor(texel - vec2(offset.x, offset.y - sign(offset.y))), texSize, wrap, layer);	\n"
+						"    return c0 + abs(offset.x)*(c1-c0) + abs(offset.y)*(c2-c0);				\n"
+						"  }																		\n"
+					;
+				}
+				m_part +=
+					"  if (filterMode == 0)														\n"
+					"    return fetchTexArray(floor(texel), texSize, wrap, layer);				\n"
+					"  highp vec2 base = floor(texel - vec2(0.5));								\n"
+					"  highp vec2 frac = texel - vec2(0.5) - base;								\n"
+					"  lowp vec4 c00 = fetchTexArray(base, texSize, wrap, layer);				\n"
+					"  lowp vec4 c10 = fetchTexArray(base + vec2(1.0, 0.0), texSize, wrap, layer);	\n"
+					"  lowp vec4 c01 = fetchTexArray(base + vec2(0.0, 1.0), texSize, wrap, layer);	\n"
+					"  lowp vec4 c11 = fetchTexArray(base + vec2(1.0, 1.0), texSize, wrap, layer);	\n"
+					"  return mix(mix(c00, c10, frac.x), mix(c01, c11, frac.x), frac.y);		\n"
+					"}																			\n"
+				;
+			}
 		}
 	}
 };
@@ -1845,8 +2037,10 @@ graphics::CombinerProgram * CombinerProgramBuilder::buildCombinerProgram(Combine
 		m_fragmentHeaderReadMSTex->write(ssShader);
 		if (bUseLod)
 			m_fragmentHeaderMipMap->write(ssShader);
-		else
+		else {
 			m_fragmentHeaderReadTex->write(ssShader);
+			m_fragmentHeaderReadTexArray->write(ssShader);
+		}
 	} else {
 		m_fragmentGlobalVariablesNotex->write(ssShader);
 
@@ -2004,6 +2198,7 @@ CombinerProgramBuilder::CombinerProgramBuilder(const opengl::GLInfo & _glinfo, o
 , m_fragmentHeaderCalcLight(new ShaderFragmentHeaderCalcLight(_glinfo))
 , m_fragmentHeaderMipMap(new ShaderFragmentHeaderMipMap(_glinfo))
 , m_fragmentHeaderReadMSTex(new ShaderFragmentHeaderReadMSTex(_glinfo))
+, m_fragmentHeaderReadTexArray(new ShaderFragmentHeaderReadTexArray(_glinfo))
 , m_fragmentHeaderDither(new ShaderFragmentHeaderDither(_glinfo))
 , m_fragmentHeaderDepthCompare(new ShaderFragmentHeaderDepthCompare(_glinfo))
 , m_fragmentHeaderReadTex(new ShaderFragmentHeaderReadTex(_glinfo))
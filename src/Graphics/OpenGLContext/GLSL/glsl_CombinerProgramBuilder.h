@@ -60,6 +60,7 @@ namespace glsl {
 		ShaderPartPtr m_fragmentHeaderCalcLight;
 		ShaderPartPtr m_fragmentHeaderMipMap;
 		ShaderPartPtr m_fragmentHeaderReadMSTex;
+		ShaderPartPtr m_fragmentHeaderReadTexArray;
 		ShaderPartPtr m_fragmentHeaderDither;
 		ShaderPartPtr m_fragmentHeaderDepthCompare;
 		ShaderPartPtr m_fragmentHeaderReadTex;
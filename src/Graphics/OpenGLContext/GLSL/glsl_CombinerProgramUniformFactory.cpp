@@ -1,6 +1,7 @@
 #include <Config.h>
 #include "glsl_CombinerProgramUniformFactory.h"
 #include <Graphics/Parameters.h>
+#include <Graphics/OpenGLContext/opengl_GraphicsDrawer.h>
 
 #include <Textures.h>
 #include <NoiseTexture.h>
@@ -22,6 +23,7 @@ struct iUniform	{
 	void set(int _val, bool _force) {
 		if (loc >= 0 && (_force || val != _val)) {
 			val = _val;
+			opengl::GraphicsDrawer::flushPending();
 			glUniform1i(loc, _val);
 		}
 	}
@@ -33,6 +35,7 @@ struct fUniform {
 	void set(float _val, bool _force) {
 		if (loc >= 0 && (_force || val != _val)) {
 			val = _val;
+			opengl::GraphicsDrawer::flushPending();
 			glUniform1f(loc, _val);
 		}
 	}
@@ -45,6 +48,7 @@ struct fv2Uniform {
 		if (loc >= 0 && (_force || val1 != _val1 || val2 != _val2)) {
 			val1 = _val1;
 			val2 = _val2;
+			opengl::GraphicsDrawer::flushPending();
 			glUniform2f(loc, _val1, _val2);
 		}
 	}
@@ -57,6 +61,7 @@ struct fv3Uniform {
 		const size_t szData = sizeof(float)* 3;
 		if (loc >= 0 && (_force || memcmp(val, _pVal, szData) != 0)) {
 			memcpy(val, _pVal, szData);
+			opengl::GraphicsDrawer::flushPending();
 			glUniform3fv(loc, 1, _pVal);
 		}
 	}
@@ -69,6 +74,7 @@ struct fv4Uniform {
 		const size_t szData = sizeof(float)* 4;
 		if (loc >= 0 && (_force || memcmp(val, _pVal, szData) != 0)) {
 			memcpy(val, _pVal, szData);
+			opengl::GraphicsDrawer::flushPending();
 			glUniform4fv(loc, 1, _pVal);
 		}
 	}
@@ -81,6 +87,7 @@ struct iv2Uniform {
 		if (loc >= 0 && (_force || val1 != _val1 || val2 != _val2)) {
 			val1 = _val1;
 			val2 = _val2;
+			opengl::GraphicsDrawer::flushPending();
 			glUniform2i(loc, _val1, _val2);
 		}
 	}
@@ -97,6 +104,7 @@ struct i4Uniform {
 			val1 = _val1;
 			val2 = _val2;
 			val3 = _val3;
+			opengl::GraphicsDrawer::flushPending();
 			glUniform4i(loc, val0, val1, val2, val3);
 		}
 	}
@@ -752,6 +760,23 @@ private:
 	iv2Uniform uCacheFrameBuffer;
 };
 
+// Layer, size and sampling of array textures are vertex attributes, see TexArrayAttribs
+class UTextureArray : public UniformGroup
+{
+public:
+	UTextureArray(GLuint _program)
+	{
+		LocateUniform(uTexArray);
+	}
+
+	void update(bool _force) override
+	{
+		uTexArray.set(int(graphics::textureIndices::ArrayTex), _force);
+	}
+
+private:
+	iUniform uTexArray;
+};
 
 class ULights : public UniformGroup
 {
@@ -780,6 +805,33 @@ private:
 	fv3Uniform uLightColor[8];
 };
 
+class ULightStates : public UniformGroup
+{
+public:
+	ULightStates(GLuint _program)
+	{
+		LocateUniform(uLightStates);
+	}
+
+	void update(bool _force) override
+	{
+		if (uLightStates.loc < 0 || gSP.lightStates.num == 0)
+			return;
+		if (_force || m_version != gSP.lightStates.version) {
+			m_version = gSP.lightStates.version;
+			opengl::GraphicsDrawer::flushPending();
+			glUniform4fv(uLightStates.loc, gSP.lightStates.num * LIGHTSTATE_VEC4, &gSP.lightStates.states[0].dir[0][0]);
+		}
+	}
+
+private:
+	struct {
+		GLint loc = -1;
+	} uLightStates;
+	u32 m_version = 0xFFFFFFFF;
+};
+
+
 
 /*---------------CombinerProgramUniformFactory-------------*/
 
@@ -817,6 +869,9 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 
 		if (!_key.isRectKey())
 			_uniforms.emplace_back(new UTextureParams(_program, _inputs.usesTile(0), _inputs.usesTile(1)));
+
+		if (!m_glInfo.isGLES2 && config.texture.enableTextureArray != 0 && !_inputs.usesLOD())
+			_uniforms.emplace_back(new UTextureArray(_program));
 	}
 
 	_uniforms.emplace_back(new UFog(_program));
@@ -857,6 +912,11 @@ void CombinerProgramUniformFactory::buildUniforms(GLuint _program,
 
 	if (_inputs.usesHwLighting())
 		_uniforms.emplace_back(new ULights(_program));
+
+	if (!_key.isRectKey() && !m_glInfo.isGLES2 &&
+		config.generalEmulation.enableShaderLighting != 0 &&
+		config.generalEmulation.enableHWLighting == 0)
+		_uniforms.emplace_back(new ULightStates(_program));
 }
 
 CombinerProgramUniformFactory::CombinerProgramUniformFactory(const opengl::GLInfo & _glInfo)
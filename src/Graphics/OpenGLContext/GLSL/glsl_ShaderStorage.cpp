@@ -61,73 +61,14 @@ uint32 - len of renderer string
 char * - renderer string
 uint32 - len of GL version string
 char * - GL version string
-uint32 - number of shaders
-shaders in binary form
-*/
-static const u32 ShaderStorageFormatVersion = 0x10U;
-bool ShaderStorage::saveShadersStorage(const graphics::Combiners & _combiners) const
-{
-	wchar_t fileName[PLUGIN_PATH_SIZE];
-	getStorageFileName(m_glinfo, fileName);
-
-#if defined(OS_WINDOWS) && !defined(MINGW)
-	std::ofstream fout(fileName, std::ofstream::binary | std::ofstream::trunc);
-#else
-	char fileName_c[PATH_MAX];
-	wcstombs(fileName_c, fileName, PATH_MAX);
-	std::ofstream fout(fileName_c, std::ofstream::binary | std::ofstream::trunc);
-#endif
-	if (!fout)
-		return false;
-
-	fout.write((char*)&ShaderStorageFormatVersion, sizeof(ShaderStorageFormatVersion));
-
-	const u32 configOptionsBitSet = _getConfigOptionsBitSet();
-	fout.write((char*)&configOptionsBitSet, sizeof(configOptionsBitSet));
-
-	const char * strRenderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
-	u32 len = strlen(strRenderer);
-	fout.write((char*)&len, sizeof(len));
-	fout.write(strRenderer, len);
-
-	const char * strGLVersion = reinterpret_cast<const char *>(glGetString(GL_VERSION));
-	len = strlen(strGLVersion);
-	fout.write((char*)&len, sizeof(len));
-	fout.write(strGLVersion, len);
-
-	len = _combiners.size();
-
-#if 0
-	fout.write((char*)&len, sizeof(len));
-	for (auto cur = _combiners.begin(); cur != _combiners.end(); ++cur)
-		fout << *(cur->second);
-#else
-	u32 totalWritten = 0;
-	std::vector<char> allShaderData;
-
-	for (auto cur = _combiners.begin(); cur != _combiners.end(); ++cur)
-	{
-		std::vector<char> data;
-		if (cur->second->getBinaryForm(data))
-		{
-			allShaderData.insert(allShaderData.end(), data.begin(), data.end());
-			++totalWritten;
-		}
-		else
-		{
-			LOG(LOG_ERROR, "Error while writing shader with key key=0x%016lX",
-				static_cast<long unsigned int>(cur->second->getKey().getMux()));
-		}
-	}
-
-	fout.write((char*)&totalWritten, sizeof(totalWritten));
-	fout.write(allShaderData.data(), allShaderData.size());
-#endif
+records:
+uint32 - size of shader binary form
+shader in binary form
 
-	fout.flush();
-	fout.close();
-	return true;
-}
+Records are appended as soon as a shader is compiled, so a torn tail is the only
+possible damage. It is dropped when the storage is indexed on open.
+*/
+static const u32 ShaderStorageFormatVersion = 0x14U;
 
 static
 CombinerProgramImpl * _readCominerProgramFromStream(std::istream & _is,
@@ -145,14 +86,21 @@ CombinerProgramImpl * _readCominerProgramFromStream(std::istream & _is,
 	GLint  binaryLength;
 	_is.read((char*)&binaryFormat, sizeof(binaryFormat));
 	_is.read((char*)&binaryLength, sizeof(binaryLength));
+	if (!_is || binaryLength <= 0)
+		return nullptr;
 	std::vector<char> binary(binaryLength);
 	_is.read(binary.data(), binaryLength);
+	if (!_is)
+		return nullptr;
 
 	GLuint program = glCreateProgram();
 	const bool isRect = cmbKey.isRectKey();
 	glsl::Utils::locateAttributes(program, isRect, cmbInputs.usesTexture());
 	glProgramBinary(program, binaryFormat, binary.data(), binaryLength);
-	assert(glsl::Utils::checkProgramLinkStatus(program));
+	if (!glsl::Utils::checkProgramLinkStatus(program)) {
+		glDeleteProgram(program);
+		return nullptr;
+	}
 
 	UniformGroups uniforms;
 	_uniformFactory.buildUniforms(program, cmbInputs, cmbKey, uniforms);
@@ -160,69 +108,181 @@ CombinerProgramImpl * _readCominerProgramFromStream(std::istream & _is,
 	return new CombinerProgramImpl(cmbKey, program, _useProgram, cmbInputs, std::move(uniforms));
 }
 
-bool ShaderStorage::loadShadersStorage(graphics::Combiners & _combiners)
+bool ShaderStorage::_checkHeader()
 {
+	u32 version = 0;
+	m_file.read((char*)&version, sizeof(version));
+	if (!m_file || version != ShaderStorageFormatVersion)
+		return false;
+
+	u32 optionsSet = 0;
+	m_file.read((char*)&optionsSet, sizeof(optionsSet));
+	if (!m_file || optionsSet != _getConfigOptionsBitSet())
+		return false;
+
+	const char * strRenderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+	u32 len = 0;
+	m_file.read((char*)&len, sizeof(len));
+	if (!m_file || len != strlen(strRenderer))
+		return false;
+	std::vector<char> strBuf(len);
+	m_file.read(strBuf.data(), len);
+	if (!m_file || strncmp(strRenderer, strBuf.data(), len) != 0)
+		return false;
+
+	const char * strGLVersion = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+	m_file.read((char*)&len, sizeof(len));
+	if (!m_file || len != strlen(strGLVersion))
+		return false;
+	strBuf.resize(len);
+	m_file.read(strBuf.data(), len);
+	if (!m_file || strncmp(strGLVersion, strBuf.data(), len) != 0)
+		return false;
+
+	return true;
+}
+
+bool ShaderStorage::_writeHeader()
+{
+	m_file.write((char*)&ShaderStorageFormatVersion, sizeof(ShaderStorageFormatVersion));
+
+	const u32 configOptionsBitSet = _getConfigOptionsBitSet();
+	m_file.write((char*)&configOptionsBitSet, sizeof(configOptionsBitSet));
+
+	const char * strRenderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+	u32 len = strlen(strRenderer);
+	m_file.write((char*)&len, sizeof(len));
+	m_file.write(strRenderer, len);
+
+	const char * strGLVersion = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+	len = strlen(strGLVersion);
+	m_file.write((char*)&len, sizeof(len));
+	m_file.write(strGLVersion, len);
+
+	m_file.flush();
+	return !m_file.fail();
+}
+
+bool ShaderStorage::open()
+{
+	close();
+
 	wchar_t fileName[PLUGIN_PATH_SIZE];
 	getStorageFileName(m_glinfo, fileName);
-	const u32 configOptionsBitSet = _getConfigOptionsBitSet();
 
 #if defined(OS_WINDOWS) && !defined(MINGW)
-	std::ifstream fin(fileName, std::ofstream::binary);
+	const wchar_t * pFileName = fileName;
 #else
 	char fileName_c[PATH_MAX];
 	wcstombs(fileName_c, fileName, PATH_MAX);
-	std::ifstream fin(fileName_c, std::ofstream::binary);
+	const char * pFileName = fileName_c;
 #endif
-	if (!fin)
-		return false;
 
-	try {
-		u32 version;
-		fin.read((char*)&version, sizeof(version));
-		if (version != ShaderStorageFormatVersion)
-			return false;
-
-		u32 optionsSet;
-		fin.read((char*)&optionsSet, sizeof(optionsSet));
-		if (optionsSet != configOptionsBitSet)
-			return false;
-
-		const char * strRenderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
-		u32 len;
-		fin.read((char*)&len, sizeof(len));
-		std::vector<char> strBuf(len);
-		fin.read(strBuf.data(), len);
-		if (strncmp(strRenderer, strBuf.data(), len) != 0)
-			return false;
-
-		const char * strGLVersion = reinterpret_cast<const char *>(glGetString(GL_VERSION));
-		fin.read((char*)&len, sizeof(len));
-		strBuf.resize(len);
-		fin.read(strBuf.data(), len);
-		if (strncmp(strGLVersion, strBuf.data(), len) != 0)
-			return false;
-
-		CombinerProgramUniformFactory uniformFactory(m_glinfo);
-
-		fin.read((char*)&len, sizeof(len));
-		for (u32 i = 0; i < len; ++i) {
-			CombinerProgramImpl * pCombiner = _readCominerProgramFromStream(fin, uniformFactory, m_useProgram);
-			pCombiner->update(true);
-			_combiners[pCombiner->getKey()] = pCombiner;
+	m_file.open(pFileName, std::fstream::in | std::fstream::out | std::fstream::binary);
+	if (m_file && _checkHeader()) {
+		// Index records by key. Shader binaries are read on first use only.
+		const std::streamoff headerEnd = m_file.tellg();
+		m_file.seekg(0, std::fstream::end);
+		const std::streamoff fileSize = m_file.tellg();
+		std::streamoff offset = headerEnd;
+		u32 size;
+		u64 mux;
+		while (offset + std::streamoff(sizeof(size)) <= fileSize) {
+			m_file.seekg(offset);
+			m_file.read((char*)&size, sizeof(size));
+			const std::streamoff record = offset + sizeof(size);
+			if (!m_file || size < sizeof(mux) || record + std::streamoff(size) > fileSize)
+				break;
+			m_file.read((char*)&mux, sizeof(mux));
+			if (!m_file)
+				break;
+			m_index[mux] = record;
+			offset = record + size;
 		}
+		m_file.clear();
+		m_fileEnd = offset;
+		LOG(LOG_VERBOSE, "Shader storage indexed: %u shaders", static_cast<u32>(m_index.size()));
+		return true;
 	}
-	catch (...) {
-		LOG(LOG_ERROR, "Stream error while loading shader cache! Buffer is probably not big enough");
+
+	// Missing or stale storage. Start over.
+	m_file.close();
+	m_file.clear();
+	m_index.clear();
+	m_file.open(pFileName, std::fstream::in | std::fstream::out | std::fstream::binary | std::fstream::trunc);
+	if (!m_file || !_writeHeader()) {
+		m_file.close();
+		return false;
 	}
+	m_fileEnd = m_file.tellp();
+	return true;
+}
 
-//	m_shadersLoaded = m_combiners.size();
-	fin.close();
-	return !opengl::Utils::isGLError();
+void ShaderStorage::close()
+{
+	if (m_file.is_open())
+		m_file.close();
+	m_file.clear();
+	m_index.clear();
+	m_fileEnd = 0;
 }
 
+graphics::CombinerProgram * ShaderStorage::loadShaderProgram(const CombinerKey & _key)
+{
+	auto iter = m_index.find(_key.getMux());
+	if (iter == m_index.end())
+		return nullptr;
+
+	m_file.seekg(iter->second);
+	CombinerProgramImpl * pCombiner = _readCominerProgramFromStream(m_file, *m_uniformFactory, m_useProgram);
+	m_file.clear();
+	if (pCombiner == nullptr || opengl::Utils::isGLError()) {
+		// Driver rejected the binary. Let the caller compile and store it again.
+		LOG(LOG_WARNING, "Failed to load stored shader with key=0x%016lX",
+			static_cast<long unsigned int>(_key.getMux()));
+		delete pCombiner;
+		m_index.erase(iter);
+		return nullptr;
+	}
+	return pCombiner;
+}
+
+bool ShaderStorage::storeShaderProgram(graphics::CombinerProgram * _program)
+{
+	if (!m_file.is_open())
+		return false;
+
+	std::vector<char> data;
+	if (!_program->getBinaryForm(data)) {
+		LOG(LOG_ERROR, "Error while writing shader with key key=0x%016lX",
+			static_cast<long unsigned int>(_program->getKey().getMux()));
+		return false;
+	}
+
+	const u32 size = data.size();
+	m_file.seekp(m_fileEnd);
+	m_file.write((char*)&size, sizeof(size));
+	m_file.write(data.data(), size);
+	m_file.flush();
+	if (m_file.fail()) {
+		m_file.clear();
+		return false;
+	}
+
+	m_index[_program->getKey().getMux()] = m_fileEnd + sizeof(size);
+	m_fileEnd += sizeof(size) + size;
+	return true;
+}
 
 ShaderStorage::ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram)
 : m_glinfo(_glinfo)
 , m_useProgram(_useProgram)
+, m_uniformFactory(new CombinerProgramUniformFactory(_glinfo))
+, m_fileEnd(0)
+{
+}
+
+ShaderStorage::~ShaderStorage()
 {
+	close();
 }
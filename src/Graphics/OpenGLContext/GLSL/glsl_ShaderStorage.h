@@ -1,4 +1,7 @@
 #pragma once
+#include <fstream>
+#include <memory>
+#include <unordered_map>
 #include <Graphics/OpenGLContext/opengl_GLInfo.h>
 
 namespace opengl {
@@ -7,18 +10,32 @@ namespace opengl {
 
 namespace glsl {
 
+	class CombinerProgramUniformFactory;
+
 	class ShaderStorage
 	{
 	public:
 		ShaderStorage(const opengl::GLInfo & _glinfo, opengl::CachedUseProgram * _useProgram);
+		~ShaderStorage();
+
+		bool open();
 
-		bool saveShadersStorage(const graphics::Combiners & _combiners) const;
+		void close();
 
-		bool loadShadersStorage(graphics::Combiners & _combiners);
+		graphics::CombinerProgram * loadShaderProgram(const CombinerKey & _key);
+
+		bool storeShaderProgram(graphics::CombinerProgram * _program);
 
 	private:
+		bool _checkHeader();
+		bool _writeHeader();
+
 		const opengl::GLInfo & m_glinfo;
 		opengl::CachedUseProgram * m_useProgram;
+		std::unique_ptr<CombinerProgramUniformFactory> m_uniformFactory;
+		std::fstream m_file;
+		std::streamoff m_fileEnd;
+		std::unordered_map<u64, std::streamoff> m_index;
 	};
 
 }
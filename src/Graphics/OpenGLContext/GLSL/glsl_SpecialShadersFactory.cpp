@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <algorithm>
 #include <Graphics/ShaderProgram.h>
 #include <Graphics/Parameters.h>
 #include <PaletteTexture.h>
@@ -379,37 +380,128 @@ namespace glsl {
 
 	/*---------------PostProcessorShaderPart-------------*/
 
-	class GammaCorrection : public ShaderPart
+	class PostProcessing : public ShaderPart
 	{
 	public:
-		GammaCorrection(const opengl::GLInfo & _glinfo)
+		PostProcessing(const opengl::GLInfo & _glinfo, u32 _stages)
 		{
 			m_part =
 				"IN mediump vec2 vTexCoord0;													\n"
 				"uniform sampler2D uTex0;													\n"
-				"uniform lowp float uGammaCorrectionLevel;									\n"
+				;
+			if ((_stages & graphics::ppBloom) != 0) {
+				m_part +=
+					"uniform sampler2D uTex1;													\n"
+					"uniform lowp float uBloomStrength;											\n"
+					;
+			}
+			if ((_stages & graphics::ppGammaCorrection) != 0) {
+				m_part +=
+					"uniform lowp float uGammaCorrectionLevel;									\n"
+					;
+			}
+			m_part +=
 				"OUT lowp vec4 fragColor;													\n"
 				"void main()																\n"
 				"{																			\n"
-				"    fragColor = texture2D(uTex0, vTexCoord0);								\n"
-				"    fragColor.rgb = pow(fragColor.rgb, vec3(1.0 / uGammaCorrectionLevel));	\n"
 				;
+			if ((_stages & graphics::ppOrientationCorrection) != 0) {
+				m_part +=
+					"    mediump vec2 texCoord = vec2(1.0 - vTexCoord0.x, 1.0 - vTexCoord0.y);	\n"
+					;
+			} else {
+				m_part +=
+					"    mediump vec2 texCoord = vTexCoord0;										\n"
+					;
+			}
+			m_part +=
+				"    fragColor = texture2D(uTex0, texCoord);									\n"
+				;
+			if ((_stages & graphics::ppBloom) != 0) {
+				m_part +=
+					"    lowp vec3 glow = texture2D(uTex1, texCoord).rgb * uBloomStrength;		\n"
+					;
+				switch (config.bloomFilter.blendMode) {
+				case 0: // Strong
+					m_part +=
+						"    fragColor.rgb = min(fragColor.rgb + glow, vec3(1.0));				\n"
+						;
+					break;
+				case 1: // Mild
+					m_part +=
+						"    glow = clamp(glow, 0.0, 1.0);										\n"
+						"    fragColor.rgb = fragColor.rgb + glow - fragColor.rgb * glow;		\n"
+						;
+					break;
+				case 2: // Light
+					m_part +=
+						"    mediump vec3 src = clamp(glow, 0.0, 1.0) * 0.5 + 0.5;				\n"
+						"    mediump vec3 dst = fragColor.rgb;									\n"
+						"    mediump vec3 dark = dst - (1.0 - 2.0 * src) * dst * (1.0 - dst);	\n"
+						"    mediump vec3 lowDst = dst + (2.0 * src - 1.0) * (4.0 * dst * (4.0 * dst + 1.0) * (dst - 1.0) + 7.0 * dst);\n"
+						"    mediump vec3 highDst = dst + (2.0 * src - 1.0) * (sqrt(dst) - dst);	\n"
+						"    fragColor.rgb = mix(dark, mix(highDst, lowDst, step(dst, vec3(0.25))), step(vec3(0.5), src));\n"
+						;
+					break;
+				default: // Glow only
+					m_part +=
+						"    fragColor.rgb = min(glow, vec3(1.0));								\n"
+						;
+				}
+			}
+			if ((_stages & graphics::ppGammaCorrection) != 0) {
+				m_part +=
+					"    fragColor.rgb = pow(fragColor.rgb, vec3(1.0 / uGammaCorrectionLevel));	\n"
+					;
+			}
 		}
 	};
 
-	class OrientationCorrection : public ShaderPart
+	class DualFilter : public ShaderPart
 	{
 	public:
-		OrientationCorrection(const opengl::GLInfo & _glinfo)
+		DualFilter(const opengl::GLInfo & _glinfo, graphics::DualFilterPass _pass)
 		{
 			m_part =
 				"IN mediump vec2 vTexCoord0;													\n"
 				"uniform sampler2D uTex0;													\n"
+				"uniform mediump vec2 uTexelSize;											\n"
 				"OUT lowp vec4 fragColor;													\n"
 				"void main()																\n"
 				"{																			\n"
-				"    fragColor = texture2D(uTex0, vec2(1.0 - vTexCoord0.x, 1.0 - vTexCoord0.y));       \n"
-			;
+				;
+			if (_pass == graphics::DualFilterPass::Upsample) {
+				m_part +=
+					"    mediump vec2 h = uTexelSize * 0.5;										\n"
+					"    mediump vec4 sum = texture2D(uTex0, vTexCoord0 + vec2(-uTexelSize.x, 0.0));\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + vec2(-h.x, h.y)) * 2.0;				\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + vec2(0.0, uTexelSize.y));			\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + h) * 2.0;							\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + vec2(uTexelSize.x, 0.0));			\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + vec2(h.x, -h.y)) * 2.0;				\n"
+					"    sum += texture2D(uTex0, vTexCoord0 + vec2(0.0, -uTexelSize.y));			\n"
+					"    sum += texture2D(uTex0, vTexCoord0 - h) * 2.0;							\n"
+					"    fragColor = sum / 12.0;													\n"
+					;
+				return;
+			}
+
+			m_part +=
+				"    mediump vec4 sum = texture2D(uTex0, vTexCoord0) * 4.0;					\n"
+				"    sum += texture2D(uTex0, vTexCoord0 - uTexelSize);						\n"
+				"    sum += texture2D(uTex0, vTexCoord0 + uTexelSize);						\n"
+				"    sum += texture2D(uTex0, vTexCoord0 + vec2(uTexelSize.x, -uTexelSize.y));	\n"
+				"    sum += texture2D(uTex0, vTexCoord0 - vec2(uTexelSize.x, -uTexelSize.y));	\n"
+				"    fragColor = sum * 0.125;													\n"
+				;
+			if (_pass == graphics::DualFilterPass::ExtractBright) {
+				const int threshold = std::min(std::max(config.bloomFilter.thresholdLevel, 2u), 6u);
+				std::stringstream ss;
+				ss << "    mediump float lum = dot(fragColor.rgb, vec3(0.30, 0.59, 0.11));		\n"
+					<< "    fragColor.rgb *= pow(lum, " << threshold << ".0);					\n"
+					<< "    fragColor.a = 1.0;														\n";
+				m_part += ss.str();
+			}
 		}
 	};
 
@@ -471,6 +563,7 @@ namespace glsl {
 		}
 
 		void activate() override {
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			gDP.changed |= CHANGED_COMBINE;
 		}
@@ -588,6 +681,7 @@ namespace glsl {
 
 		void activate() override
 		{
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			gDP.changed |= CHANGED_COMBINE;
 		}
@@ -596,6 +690,7 @@ namespace glsl {
 		{
 			if (m_textureSizeLoc < 0)
 				return;
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			glUniform2f(m_textureSizeLoc, (GLfloat)_width, (GLfloat)_height);
 			gDP.changed |= CHANGED_COMBINE;
@@ -603,6 +698,7 @@ namespace glsl {
 
 		void setTextureBounds(float _texBounds[4])  override
 		{
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			glUniform4fv(m_textureBoundsLoc, 1, _texBounds);
 			gDP.changed |= CHANGED_COMBINE;
@@ -610,6 +706,7 @@ namespace glsl {
 
 		void setEnableAlphaTest(int _enable) override
 		{
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			glUniform1i(m_enableAlphaTestLoc, _enable);
 			gDP.changed |= CHANGED_COMBINE;
@@ -648,46 +745,127 @@ namespace glsl {
 
 	/*---------------PostProcessorShader-------------*/
 
-	typedef SpecialShader<VertexShaderTexturedRect, GammaCorrection> GammaCorrectionShaderBase;
+	static
+	graphics::ObjectHandle _createTexturedRectProgram(const opengl::GLInfo & _glinfo,
+		const ShaderPart * _vertexHeader,
+		const ShaderPart * _fragmentHeader,
+		const ShaderPart & _fragmentBody,
+		const ShaderPart * _fragmentEnd)
+	{
+		VertexShaderTexturedRect vertexBody(_glinfo);
+		std::stringstream ssVertexShader;
+		_vertexHeader->write(ssVertexShader);
+		vertexBody.write(ssVertexShader);
+
+		std::stringstream ssFragmentShader;
+		_fragmentHeader->write(ssFragmentShader);
+		_fragmentBody.write(ssFragmentShader);
+		if (_fragmentEnd != nullptr)
+			_fragmentEnd->write(ssFragmentShader);
+
+		return graphics::ObjectHandle(Utils::createRectShaderProgram(ssVertexShader.str().data(), ssFragmentShader.str().data()));
+	}
 
-	class GammaCorrectionShader : public GammaCorrectionShaderBase
+	class PostProcessingShader : public graphics::ShaderProgram
 	{
 	public:
-		GammaCorrectionShader(const opengl::GLInfo & _glinfo,
+		PostProcessingShader(const opengl::GLInfo & _glinfo,
 			opengl::CachedUseProgram * _useProgram,
 			const ShaderPart * _vertexHeader,
 			const ShaderPart * _fragmentHeader,
-			const ShaderPart * _fragmentEnd)
-			: GammaCorrectionShaderBase(_glinfo, _useProgram, _vertexHeader, _fragmentHeader, _fragmentEnd)
+			const ShaderPart * _fragmentEnd,
+			u32 _stages)
+			: m_program(0)
+			, m_useProgram(_useProgram)
 		{
+			PostProcessing fragmentBody(_glinfo, _stages);
+			m_program = _createTexturedRectProgram(_glinfo, _vertexHeader, _fragmentHeader, fragmentBody, _fragmentEnd);
+
 			m_useProgram->useProgram(m_program);
 			const int texLoc = glGetUniformLocation(GLuint(m_program), "uTex0");
 			glUniform1i(texLoc, 0);
-			const int levelLoc = glGetUniformLocation(GLuint(m_program), "uGammaCorrectionLevel");
-			assert(levelLoc >= 0);
-			const f32 gammaLevel = (config.gammaCorrection.force != 0) ? config.gammaCorrection.level : 2.0f;
-			glUniform1f(levelLoc, gammaLevel);
+			if ((_stages & graphics::ppBloom) != 0) {
+				const int bloomLoc = glGetUniformLocation(GLuint(m_program), "uTex1");
+				glUniform1i(bloomLoc, 1);
+				const int strengthLoc = glGetUniformLocation(GLuint(m_program), "uBloomStrength");
+				assert(strengthLoc >= 0);
+				glUniform1f(strengthLoc, config.bloomFilter.blurStrength / 20.0f);
+			}
+			if ((_stages & graphics::ppGammaCorrection) != 0) {
+				const int levelLoc = glGetUniformLocation(GLuint(m_program), "uGammaCorrectionLevel");
+				assert(levelLoc >= 0);
+				const f32 gammaLevel = (config.gammaCorrection.force != 0) ? config.gammaCorrection.level : 2.0f;
+				glUniform1f(levelLoc, gammaLevel);
+			}
 			m_useProgram->useProgram(graphics::ObjectHandle::null);
 		}
-	};
 
-	typedef SpecialShader<VertexShaderTexturedRect, OrientationCorrection> OrientationCorrectionShaderBase;
+		~PostProcessingShader()
+		{
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+			glDeleteProgram(GLuint(m_program));
+		}
+
+		void activate() override
+		{
+			opengl::GraphicsDrawer::flushPending();
+			m_useProgram->useProgram(m_program);
+			gDP.changed |= CHANGED_COMBINE;
+		}
 
-	class OrientationCorrectionShader : public OrientationCorrectionShaderBase
+	protected:
+		graphics::ObjectHandle m_program;
+		opengl::CachedUseProgram * m_useProgram;
+	};
+
+	class DualFilterShader : public graphics::DualFilterShaderProgram
 	{
 	public:
-		OrientationCorrectionShader(const opengl::GLInfo & _glinfo,
+		DualFilterShader(const opengl::GLInfo & _glinfo,
 			opengl::CachedUseProgram * _useProgram,
 			const ShaderPart * _vertexHeader,
 			const ShaderPart * _fragmentHeader,
-			const ShaderPart * _fragmentEnd)
-			: OrientationCorrectionShaderBase(_glinfo, _useProgram, _vertexHeader, _fragmentHeader, _fragmentEnd)
+			const ShaderPart * _fragmentEnd,
+			graphics::DualFilterPass _pass)
+			: m_program(0)
+			, m_useProgram(_useProgram)
 		{
+			DualFilter fragmentBody(_glinfo, _pass);
+			m_program = _createTexturedRectProgram(_glinfo, _vertexHeader, _fragmentHeader, fragmentBody, _fragmentEnd);
+
 			m_useProgram->useProgram(m_program);
 			const int texLoc = glGetUniformLocation(GLuint(m_program), "uTex0");
 			glUniform1i(texLoc, 0);
+			m_texelSizeLoc = glGetUniformLocation(GLuint(m_program), "uTexelSize");
+			assert(m_texelSizeLoc >= 0);
 			m_useProgram->useProgram(graphics::ObjectHandle::null);
 		}
+
+		~DualFilterShader()
+		{
+			m_useProgram->useProgram(graphics::ObjectHandle::null);
+			glDeleteProgram(GLuint(m_program));
+		}
+
+		void activate() override
+		{
+			opengl::GraphicsDrawer::flushPending();
+			m_useProgram->useProgram(m_program);
+			gDP.changed |= CHANGED_COMBINE;
+		}
+
+		void setTexelSize(f32 _width, f32 _height) override
+		{
+			opengl::GraphicsDrawer::flushPending();
+			m_useProgram->useProgram(m_program);
+			glUniform2f(m_texelSizeLoc, _width, _height);
+			gDP.changed |= CHANGED_COMBINE;
+		}
+
+	protected:
+		graphics::ObjectHandle m_program;
+		opengl::CachedUseProgram * m_useProgram;
+		GLint m_texelSizeLoc;
 	};
 
 	/*---------------TexrectDrawerShader-------------*/
@@ -713,6 +891,7 @@ namespace glsl {
 		}
 
 		void setTextColor(float * _color) override {
+			opengl::GraphicsDrawer::flushPending();
 			m_useProgram->useProgram(m_program);
 			glUniform4fv(m_colorLoc, 1, _color);
 			m_useProgram->useProgram(graphics::ObjectHandle::null);
@@ -765,14 +944,14 @@ namespace glsl {
 		return new TexrectCopyShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
 	}
 
-	graphics::ShaderProgram * SpecialShadersFactory::createGammaCorrectionShader() const
+	graphics::ShaderProgram * SpecialShadersFactory::createPostProcessingShader(u32 _stages) const
 	{
-		return new GammaCorrectionShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
+		return new PostProcessingShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd, _stages);
 	}
 
-	graphics::ShaderProgram * SpecialShadersFactory::createOrientationCorrectionShader() const
+	graphics::DualFilterShaderProgram * SpecialShadersFactory::createDualFilterShader(graphics::DualFilterPass _pass) const
 	{
-		return new OrientationCorrectionShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd);
+		return new DualFilterShader(m_glinfo, m_useProgram, m_vertexHeader, m_fragmentHeader, m_fragmentEnd, _pass);
 	}
 
 	graphics::TextDrawerShaderProgram * SpecialShadersFactory::createTextDrawerShader() const
@@ -32,9 +32,9 @@ namespace glsl {
 
 		graphics::ShaderProgram * createTexrectCopyShader() const;
 
-		graphics::ShaderProgram * createGammaCorrectionShader() const;
+		graphics::ShaderProgram * createPostProcessingShader(u32 _stages) const;
 
-		graphics::ShaderProgram * createOrientationCorrectionShader() const;
+		graphics::DualFilterShaderProgram * createDualFilterShader(graphics::DualFilterPass _pass) const;
 
 		graphics::TextDrawerShaderProgram * createTextDrawerShader() const;
 
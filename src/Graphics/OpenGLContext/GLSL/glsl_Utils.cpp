@@ -12,6 +12,8 @@ void Utils::locateAttributes(GLuint _program, bool _rect, bool _textures)
 		if (_textures) {
 			glBindAttribLocation(_program, opengl::rectAttrib::texcoord0, "aTexCoord0");
 			glBindAttribLocation(_program, opengl::rectAttrib::texcoord1, "aTexCoord1");
+			glBindAttribLocation(_program, opengl::rectAttrib::texArray0, "aTexArray0");
+			glBindAttribLocation(_program, opengl::rectAttrib::texArray1, "aTexArray1");
 		}
 		return;
 	}
@@ -20,8 +22,12 @@ void Utils::locateAttributes(GLuint _program, bool _rect, bool _textures)
 	glBindAttribLocation(_program, opengl::triangleAttrib::color, "aColor");
 	glBindAttribLocation(_program, opengl::triangleAttrib::numlights, "aNumLights");
 	glBindAttribLocation(_program, opengl::triangleAttrib::modify, "aModify");
-	if (_textures)
+	glBindAttribLocation(_program, opengl::triangleAttrib::lightState, "aLightState");
+	if (_textures) {
 		glBindAttribLocation(_program, opengl::triangleAttrib::texcoord, "aTexCoord");
+		glBindAttribLocation(_program, opengl::triangleAttrib::texArray0, "aTexArray0");
+		glBindAttribLocation(_program, opengl::triangleAttrib::texArray1, "aTexArray1");
+	}
 }
 
 
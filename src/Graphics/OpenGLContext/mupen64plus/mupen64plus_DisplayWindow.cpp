@@ -30,7 +30,7 @@ private:
 	bool _start() override;
 	void _stop() override;
 	void _swapBuffers() override;
-	void _saveScreenshot() override;
+	void _saveScreenshot(const wchar_t * _folder, const char * _name, u32 _width, u32 _height, const u8 * _data) override;
 	bool _resizeWindow() override;
 	void _changeWindow() override;
 	void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) override {}
@@ -120,7 +120,7 @@ void DisplayWindowMupen64plus::_swapBuffers()
 	CoreVideo_GL_SwapBuffers();
 }
 
-void DisplayWindowMupen64plus::_saveScreenshot()
+void DisplayWindowMupen64plus::_saveScreenshot(const wchar_t * _folder, const char * _name, u32 _width, u32 _height, const u8 * _data)
 {
 }
 
@@ -8,6 +8,9 @@ namespace opengl {
 		const GLuint texcoord = 2U;
 		const GLuint numlights = 3U;
 		const GLuint modify = 4U;
+		const GLuint lightState = 8U;
+		const GLuint texArray0 = 9U;
+		const GLuint texArray1 = 10U;
 	}
 
 	// Rect attributes
@@ -15,5 +18,7 @@ namespace opengl {
 		const GLuint position = 5U;
 		const GLuint texcoord0 = 6U;
 		const GLuint texcoord1 = 7U;
+		const GLuint texArray0 = 11U;
+		const GLuint texArray1 = 12U;
 	}
 }
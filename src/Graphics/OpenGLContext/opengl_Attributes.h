@@ -10,6 +10,9 @@ namespace opengl {
 		extern const GLuint texcoord;
 		extern const GLuint numlights;
 		extern const GLuint modify;
+		extern const GLuint lightState;
+		extern const GLuint texArray0;
+		extern const GLuint texArray1;
 	}
 
 	// Rect attributes
@@ -17,7 +20,9 @@ namespace opengl {
 		extern const GLuint position;
 		extern const GLuint texcoord0;
 		extern const GLuint texcoord1;
+		extern const GLuint texArray0;
+		extern const GLuint texArray1;
 	}
 
-#define MaxAttribIndex 8
+#define MaxAttribIndex 13
 }
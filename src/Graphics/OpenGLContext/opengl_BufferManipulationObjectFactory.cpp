@@ -179,13 +179,20 @@ public:
 	{
 		glGenBuffers(1, &m_PBO);
 		m_bind->bind(graphics::Parameter(GL_PIXEL_UNPACK_BUFFER), graphics::ObjectHandle(m_PBO));
-		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_size * 32, nullptr, m_bufAccessBits);
-		m_bufferData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_size * 32, m_bufMapBits);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_size * m_numBlocks, nullptr, m_bufAccessBits);
+		m_bufferData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_size * m_numBlocks, m_bufMapBits);
 		m_bufferOffset = 0;
+		m_writeOffset = 0;
+		m_writeSize = 0;
+		m_segment = 0;
 		m_bind->bind(graphics::Parameter(GL_PIXEL_UNPACK_BUFFER), graphics::ObjectHandle::null);
 	}
 
 	~PersistentWriteBuffer() {
+		for (GLsync fence : m_fences) {
+			if (fence != 0)
+				glDeleteSync(fence);
+		}
 		glDeleteBuffers(1, &m_PBO);
 		m_PBO = 0;
 	}
@@ -194,21 +201,40 @@ public:
 	{
 		if (_size > m_size)
 			_size = m_size;
-		if (m_bufferOffset + _size > m_size * 32)
+		if (m_bufferOffset + _size > m_size * m_numBlocks) {
+			_fenceSegments(m_numSegments);
+			m_segment = 0;
 			m_bufferOffset = 0;
+		}
+
+		// Uploads from the segments written so far are issued. Fence them and
+		// wait until the GPU has read the segments this write goes to.
+		const size_t segmentSize = m_size * m_numBlocks / m_numSegments;
+		const u32 first = u32(m_bufferOffset / segmentSize);
+		const u32 last = u32((m_bufferOffset + _size - 1) / segmentSize);
+		if (first != m_segment) {
+			_fenceSegments(first);
+			m_segment = first;
+		}
+		for (u32 i = first; i <= last; ++i)
+			_waitSegment(i);
+
+		m_writeSize = _size;
 		return (char*)m_bufferData + m_bufferOffset;
 	}
 
 	void closeWriteBuffer() override
 	{
 #ifdef GL_DEBUG
-		glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER, m_bufferOffset, m_size);
+		glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER, m_bufferOffset, m_writeSize);
 #endif
-		m_bufferOffset += m_size;
+		m_writeOffset = m_bufferOffset;
+		// Keep offsets aligned for any pixel format
+		m_bufferOffset += (m_writeSize + 63) & ~size_t(63);
 	}
 
 	void * getData() override {
-		return (char*)nullptr + m_bufferOffset - m_size;
+		return (char*)nullptr + m_writeOffset;
 	}
 
 	void bind() override {
@@ -220,10 +246,38 @@ public:
 	}
 
 private:
+	void _fenceSegments(u32 _end)
+	{
+		for (u32 i = m_segment; i < _end; ++i) {
+			if (m_fences[i] != 0)
+				glDeleteSync(m_fences[i]);
+			m_fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+	}
+
+	void _waitSegment(u32 _segment)
+	{
+		GLsync & fence = m_fences[_segment];
+		if (fence == 0)
+			return;
+		GLenum res = glClientWaitSync(fence, 0, 0);
+		while (res == GL_TIMEOUT_EXPIRED)
+			res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+		glDeleteSync(fence);
+		fence = 0;
+	}
+
+	static const u32 m_numBlocks = 32;
+	static const u32 m_numSegments = 4;
+
 	CachedBindBuffer * m_bind;
 	size_t m_size;
 	void* m_bufferData;
-	u32 m_bufferOffset;
+	size_t m_bufferOffset;
+	size_t m_writeOffset;
+	size_t m_writeSize;
+	u32 m_segment;
+	GLsync m_fences[m_numSegments] = {};
 	GLuint m_PBO;
 #ifndef GL_DEBUG
 	GLbitfield m_bufAccessBits = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
@@ -295,6 +349,7 @@ public:
 	PBOReadBuffer(CachedBindBuffer * _bind, size_t _size)
 		: m_bind(_bind)
 		, m_size(_size)
+		, m_fence(nullptr)
 	{
 		glGenBuffers(1, &m_PBO);
 		m_bind->bind(graphics::Parameter(GL_PIXEL_PACK_BUFFER), graphics::ObjectHandle(m_PBO));
@@ -303,12 +358,15 @@ public:
 	}
 
 	~PBOReadBuffer() {
+		if (m_fence != nullptr)
+			glDeleteSync(m_fence);
 		glDeleteBuffers(1, &m_PBO);
 		m_PBO = 0;
 	}
 
 	void readPixels(s32 _x,s32 _y, u32 _width, u32 _height, graphics::Parameter _format, graphics::Parameter _type) override
 	{
+		opengl::GraphicsDrawer::flushPending();
 		glReadPixels(_x, _y, _width, _height, GLenum(_format), GLenum(_type), 0);
 	}
 
@@ -324,6 +382,23 @@ public:
 		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 	}
 
+	void fence() override
+	{
+		if (m_fence != nullptr)
+			glDeleteSync(m_fence);
+		m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	bool isReady() override
+	{
+		if (m_fence == nullptr)
+			return true;
+		if (glClientWaitSync(m_fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+			return false;
+		glDeleteSync(m_fence);
+		m_fence = nullptr;
+		return true;
+	}
 
 	void bind() override {
 		m_bind->bind(graphics::Parameter(GL_PIXEL_PACK_BUFFER), graphics::ObjectHandle(m_PBO));
@@ -337,6 +412,7 @@ private:
 	CachedBindBuffer * m_bind;
 	size_t m_size;
 	GLuint m_PBO;
+	GLsync m_fence;
 };
 
 template<typename T>
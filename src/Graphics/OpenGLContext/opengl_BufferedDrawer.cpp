@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <Config.h>
 #include <CRC.h>
 #include "GLFunctions.h"
@@ -7,7 +8,8 @@
 using namespace graphics;
 using namespace opengl;
 
-const u32 BufferedDrawer::m_bufMaxSize = 4194304;
+const u32 BufferedDrawer::m_bufInitSize = 4194304;
+const u32 BufferedDrawer::m_bufMaxSize = 67108864;
 #ifndef GL_DEBUG
 const GLbitfield BufferedDrawer::m_bufAccessBits = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
 const GLbitfield BufferedDrawer::m_bufMapBits = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
@@ -16,37 +18,60 @@ const GLbitfield BufferedDrawer::m_bufAccessBits = GL_MAP_WRITE_BIT | GL_MAP_PER
 const GLbitfield BufferedDrawer::m_bufMapBits = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
 #endif
 
+opengl::GraphicsDrawer * opengl::GraphicsDrawer::s_pending = nullptr;
+
 BufferedDrawer::BufferedDrawer(const GLInfo & _glinfo, CachedVertexAttribArray * _cachedAttribArray, CachedBindBuffer * _bindBuffer)
 : m_glInfo(_glinfo)
 , m_cachedAttribArray(_cachedAttribArray)
 , m_bindBuffer(_bindBuffer)
+, m_batchDraws(_glinfo.multiDraw && _glinfo.bufferStorage && config.generalEmulation.enableDrawBatching != 0)
 {
 	m_vertices.resize(VERTBUFF_SIZE);
 	/* Init buffers for rects */
 	glGenVertexArrays(1, &m_rectsBuffers.vao);
 	glBindVertexArray(m_rectsBuffers.vao);
-	_initBuffer(m_rectsBuffers.vbo, m_bufMaxSize);
+	_initBuffer(m_rectsBuffers.vbo, m_bufInitSize);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::position, true);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord0, true);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, true);
-	glVertexAttribPointer(rectAttrib::position, 4, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, x)));
-	glVertexAttribPointer(rectAttrib::texcoord0, 2, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, s0)));
-	glVertexAttribPointer(rectAttrib::texcoord1, 2, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, s1)));
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, true);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, true);
+	_setRectAttribPointers();
 
 	/* Init buffers for triangles */
 	glGenVertexArrays(1, &m_trisBuffers.vao);
 	glBindVertexArray(m_trisBuffers.vao);
-	_initBuffer(m_trisBuffers.vbo, m_bufMaxSize);
-	_initBuffer(m_trisBuffers.ebo, m_bufMaxSize);
+	_initBuffer(m_trisBuffers.vbo, m_bufInitSize);
+	_initBuffer(m_trisBuffers.ebo, m_bufInitSize);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::position, true);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::color, true);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texcoord, true);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::modify, true);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::numlights, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, true);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texArray0, true);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texArray1, true);
+	_setTrisAttribPointers();
+}
+
+void BufferedDrawer::_setRectAttribPointers()
+{
+	glVertexAttribPointer(rectAttrib::position, 4, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, x)));
+	glVertexAttribPointer(rectAttrib::texcoord0, 2, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, s0)));
+	glVertexAttribPointer(rectAttrib::texcoord1, 2, GL_FLOAT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, s1)));
+	glVertexAttribPointer(rectAttrib::texArray0, 4, GL_SHORT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, texArray.tile[0])));
+	glVertexAttribPointer(rectAttrib::texArray1, 4, GL_SHORT, GL_FALSE, sizeof(RectVertex), (const GLvoid *)(offsetof(RectVertex, texArray.tile[1])));
+}
+
+void BufferedDrawer::_setTrisAttribPointers()
+{
 	glVertexAttribPointer(triangleAttrib::position, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, x)));
 	glVertexAttribPointer(triangleAttrib::color, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, r)));
 	glVertexAttribPointer(triangleAttrib::texcoord, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, s)));
 	glVertexAttribPointer(triangleAttrib::modify, 4, GL_BYTE, GL_TRUE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, modify)));
+	glVertexAttribPointer(triangleAttrib::lightState, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, lightState)));
+	glVertexAttribPointer(triangleAttrib::texArray0, 4, GL_SHORT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, texArray.tile[0])));
+	glVertexAttribPointer(triangleAttrib::texArray1, 4, GL_SHORT, GL_FALSE, sizeof(Vertex), (const GLvoid *)(offsetof(Vertex, texArray.tile[1])));
 }
 
 void BufferedDrawer::_initBuffer(Buffer & _buffer, GLuint _bufSize)
@@ -62,8 +87,34 @@ void BufferedDrawer::_initBuffer(Buffer & _buffer, GLuint _bufSize)
 	}
 }
 
+void BufferedDrawer::_destroyBuffer(Buffer & _buffer)
+{
+	for (GLsync & fence : _buffer.fences) {
+		if (fence != 0) {
+			glDeleteSync(fence);
+			fence = 0;
+		}
+	}
+	// The name may be handed out again by glGenBuffers, so drop it from the binding cache first.
+	m_bindBuffer->bind(Parameter(_buffer.type), ObjectHandle::null);
+	glDeleteBuffers(1, &_buffer.handle);
+	_buffer.handle = 0;
+	_buffer.data = nullptr;
+	_buffer.offset = 0;
+	_buffer.pos = 0;
+	_buffer.segment = 0;
+}
+
 BufferedDrawer::~BufferedDrawer()
 {
+	if (s_pending == this)
+		s_pending = nullptr;
+	for (Buffer * buffer : { &m_rectsBuffers.vbo, &m_trisBuffers.vbo, &m_trisBuffers.ebo }) {
+		for (GLsync fence : buffer->fences) {
+			if (fence != 0)
+				glDeleteSync(fence);
+		}
+	}
 	m_bindBuffer->bind(Parameter(GL_ARRAY_BUFFER), ObjectHandle::null);
 	m_bindBuffer->bind(Parameter(GL_ELEMENT_ARRAY_BUFFER), ObjectHandle::null);
 	GLuint buffers[3] = { m_rectsBuffers.vbo.handle, m_trisBuffers.vbo.handle, m_trisBuffers.ebo.handle };
@@ -73,13 +124,56 @@ BufferedDrawer::~BufferedDrawer()
 	glDeleteVertexArrays(2, arrays);
 }
 
+void BufferedDrawer::_fenceSegments(Buffer & _buffer, u32 _end)
+{
+	// Fences must follow the draws reading the fenced segments.
+	flushDraws();
+	for (u32 i = _buffer.segment; i < _end; ++i) {
+		if (_buffer.fences[i] != 0)
+			glDeleteSync(_buffer.fences[i]);
+		_buffer.fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
+
+void BufferedDrawer::_waitSegment(Buffer & _buffer, u32 _segment)
+{
+	GLsync & fence = _buffer.fences[_segment];
+	if (fence == 0)
+		return;
+
+	GLenum res = glClientWaitSync(fence, 0, 0);
+	if (res == GL_TIMEOUT_EXPIRED) {
+		++m_stalls;
+		do {
+			res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+		} while (res == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(fence);
+	fence = 0;
+}
+
 void BufferedDrawer::_updateBuffer(Buffer & _buffer, u32 _count, u32 _dataSize, const void * _data)
 {
+	if (_dataSize == 0)
+		return;
+
 	if (_buffer.offset + _dataSize > _buffer.size) {
+		_fenceSegments(_buffer, m_numSegments);
+		_buffer.segment = 0;
 		_buffer.offset = 0;
 		_buffer.pos = 0;
 	}
 
+	const GLuint segmentSize = _buffer.size / m_numSegments;
+	const u32 first = u32(_buffer.offset / segmentSize);
+	const u32 last = u32((_buffer.offset + _dataSize - 1) / segmentSize);
+	if (first != _buffer.segment) {
+		_fenceSegments(_buffer, first);
+		_buffer.segment = first;
+	}
+	for (u32 i = first; i <= last; ++i)
+		_waitSegment(_buffer, i);
+
 	if (m_glInfo.bufferStorage) {
 		memcpy(&_buffer.data[_buffer.offset], _data, _dataSize);
 #ifdef GL_DEBUG
@@ -95,6 +189,7 @@ void BufferedDrawer::_updateBuffer(Buffer & _buffer, u32 _count, u32 _dataSize,
 
 	_buffer.offset += _dataSize;
 	_buffer.pos += _count;
+	_buffer.frameBytes += _dataSize;
 }
 
 void BufferedDrawer::_updateRectBuffer(const graphics::Context::DrawRectParameters & _params)
@@ -120,9 +215,10 @@ void BufferedDrawer::_updateRectBuffer(const graphics::Context::DrawRectParamete
 		return;
 	}
 
-	const GLintptr prevOffset = buffer.offset;
+	// Reused rects must stay in the current segment, which is not fenced yet.
+	const u32 prevSegment = buffer.segment;
 	_updateBuffer(buffer, _params.verticesCount, dataSize, _params.vertices);
-	if (buffer.offset < prevOffset)
+	if (buffer.segment != prevSegment)
 		m_rectBufferOffsets.clear();
 
 	buffer.pos = buffer.offset / sizeof(RectVertex);
@@ -132,19 +228,38 @@ void BufferedDrawer::_updateRectBuffer(const graphics::Context::DrawRectParamete
 
 void BufferedDrawer::drawRects(const graphics::Context::DrawRectParameters & _params)
 {
+	if (m_pending.type != BuffersType::rects || m_pending.mode != GLenum(_params.mode))
+		flushDraws();
 	_updateRectBuffer(_params);
 
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord0, _params.texrect);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, _params.texrect);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, _params.texrect);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, _params.texrect);
+	++m_draws;
+
+	// Runs of texrects, sprites and text glyphs drawn with the same state go out as one draw.
+	if (m_batchDraws) {
+		m_pending.type = BuffersType::rects;
+		m_pending.mode = GLenum(_params.mode);
+		m_pending.counts.push_back(_params.verticesCount);
+		m_pending.firsts.push_back(m_rectsBuffers.vbo.pos - _params.verticesCount);
+		s_pending = this;
+		return;
+	}
 
 	glDrawArrays(GLenum(_params.mode), m_rectsBuffers.vbo.pos - _params.verticesCount, _params.verticesCount);
+	++m_submits;
 }
 
-void BufferedDrawer::_convertFromSPVertex(bool _flatColors, u32 _count, const SPVertex * _data)
+void BufferedDrawer::_convertFromSPVertex(bool _flatColors, bool _shaderLighting, const TexArrayAttribs * _texArray,
+	u32 _count, const SPVertex * _data)
 {
 	if (_count > m_vertices.size())
 		m_vertices.resize(_count);
 
+	const TexArrayAttribs & texArray = _texArray != nullptr ? *_texArray : TexArrayAttribs::none;
+
 	for (u32 i = 0; i < _count; ++i) {
 		const SPVertex & src = _data[i];
 		Vertex & dst = m_vertices[i];
@@ -166,6 +281,8 @@ void BufferedDrawer::_convertFromSPVertex(bool _flatColors, u32 _count, const SP
 		dst.s = src.s;
 		dst.t = src.t;
 		dst.modify = src.modify;
+		dst.lightState = _shaderLighting ? f32(src.lightState) : 0.0f;
+		dst.texArray = texArray;
 	}
 }
 
@@ -178,7 +295,7 @@ void BufferedDrawer::_updateTrianglesBuffers(const graphics::Context::DrawTriang
 		m_type = type;
 	}
 
-	_convertFromSPVertex(_params.flatColors, _params.verticesCount, _params.vertices);
+	_convertFromSPVertex(_params.flatColors, _params.shaderLighting, _params.texArray, _params.verticesCount, _params.vertices);
 	const GLsizeiptr vboDataSize = _params.verticesCount * sizeof(Vertex);
 	Buffer & vboBuffer = m_trisBuffers.vbo;
 	_updateBuffer(vboBuffer, _params.verticesCount, vboDataSize, m_vertices.data());
@@ -193,19 +310,39 @@ void BufferedDrawer::_updateTrianglesBuffers(const graphics::Context::DrawTriang
 
 void BufferedDrawer::drawTriangles(const graphics::Context::DrawTriangleParameters & _params)
 {
+	// Per draw vertex attribute and per polygon barriers can not be batched.
+	const bool batch = m_batchDraws && _params.elements != nullptr &&
+		config.generalEmulation.enableHWLighting == 0 &&
+		config.frameBufferEmulation.N64DepthCompare == 0;
+	if (!batch || m_pending.type != BuffersType::triangles || m_pending.mode != GLenum(_params.mode))
+		flushDraws();
+
 	_updateTrianglesBuffers(_params);
+	++m_draws;
+
+	if (batch) {
+		m_pending.type = BuffersType::triangles;
+		m_pending.mode = GLenum(_params.mode);
+		m_pending.counts.push_back(_params.elementsCount);
+		m_pending.indices.push_back((char*)nullptr + m_trisBuffers.ebo.pos - _params.elementsCount);
+		m_pending.baseVertices.push_back(m_trisBuffers.vbo.pos - _params.verticesCount);
+		s_pending = this;
+		return;
+	}
 
 	if (config.generalEmulation.enableHWLighting != 0)
 		glVertexAttrib1f(triangleAttrib::numlights, GLfloat(_params.vertices[0].HWLight));
 
 	if (_params.elements == nullptr) {
 		glDrawArrays(GLenum(_params.mode), m_trisBuffers.vbo.pos - _params.verticesCount, _params.verticesCount);
+		++m_submits;
 		return;
 	}
 
 	if (config.frameBufferEmulation.N64DepthCompare == 0) {
 		glDrawElementsBaseVertex(GLenum(_params.mode), _params.elementsCount, GL_UNSIGNED_BYTE,
 			(char*)nullptr + m_trisBuffers.ebo.pos - _params.elementsCount, m_trisBuffers.vbo.pos - _params.verticesCount);
+		++m_submits;
 		return;
 	}
 
@@ -216,11 +353,41 @@ void BufferedDrawer::drawTriangles(const graphics::Context::DrawTriangleParamete
 		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 		glDrawElementsBaseVertex(GLenum(_params.mode), 3, GL_UNSIGNED_BYTE,
 			(char*)nullptr + eboStartPos + i, vboStartPos);
+		++m_submits;
 	}
 }
 
+void BufferedDrawer::flushDraws()
+{
+	if (m_pending.counts.empty())
+		return;
+
+	s_pending = nullptr;
+	const GLsizei drawCount = GLsizei(m_pending.counts.size());
+	if (m_pending.type == BuffersType::rects) {
+		if (drawCount == 1)
+			glDrawArrays(m_pending.mode, m_pending.firsts[0], m_pending.counts[0]);
+		else
+			glMultiDrawArrays(m_pending.mode, m_pending.firsts.data(), m_pending.counts.data(), drawCount);
+	} else if (drawCount == 1)
+		glDrawElementsBaseVertex(m_pending.mode, m_pending.counts[0], GL_UNSIGNED_BYTE,
+			m_pending.indices[0], m_pending.baseVertices[0]);
+	else
+		glMultiDrawElementsBaseVertex(m_pending.mode, m_pending.counts.data(), GL_UNSIGNED_BYTE,
+			m_pending.indices.data(), drawCount, m_pending.baseVertices.data());
+	++m_submits;
+
+	m_pending.type = BuffersType::none;
+	m_pending.counts.clear();
+	m_pending.indices.clear();
+	m_pending.baseVertices.clear();
+	m_pending.firsts.clear();
+}
+
 void BufferedDrawer::drawLine(f32 _width, SPVertex * _vertices)
 {
+	flushDraws();
+
 	const BuffersType type = BuffersType::triangles;
 
 	if (m_type != type) {
@@ -228,11 +395,76 @@ void BufferedDrawer::drawLine(f32 _width, SPVertex * _vertices)
 		m_type = type;
 	}
 
-	_convertFromSPVertex(false, 2, _vertices);
+	_convertFromSPVertex(false, false, nullptr, 2, _vertices);
 	const GLsizeiptr vboDataSize = 2 * sizeof(Vertex);
 	Buffer & vboBuffer = m_trisBuffers.vbo;
 	_updateBuffer(vboBuffer, 2, vboDataSize, m_vertices.data());
 
 	glLineWidth(_width);
 	glDrawArrays(GL_LINES, m_trisBuffers.vbo.pos - 2, 2);
+	++m_draws;
+	++m_submits;
+}
+
+GLuint BufferedDrawer::_ringSize(const Buffer & _buffer) const
+{
+	const u32 required = _buffer.peakFrameBytes * m_framesInFlight;
+	GLuint size = _buffer.size;
+	while (size < required && size < m_bufMaxSize)
+		size *= 2;
+	return size;
+}
+
+void BufferedDrawer::frameEnd()
+{
+	flushDraws();
+
+	m_stats.size = 0;
+	m_stats.frameBytes = 0;
+	for (Buffer * buffer : { &m_rectsBuffers.vbo, &m_trisBuffers.vbo, &m_trisBuffers.ebo }) {
+		m_stats.size += buffer->size;
+		m_stats.frameBytes += buffer->frameBytes;
+		buffer->peakFrameBytes = std::max(buffer->peakFrameBytes, buffer->frameBytes);
+		buffer->frameBytes = 0;
+	}
+	m_stats.peakFrameBytes = std::max(m_stats.peakFrameBytes, m_stats.frameBytes);
+	m_stats.stalls = m_stalls;
+	m_stalls = 0;
+	m_stats.draws = m_draws;
+	m_stats.submits = m_submits;
+	m_draws = 0;
+	m_submits = 0;
+
+	// Grow a ring which can not hold m_framesInFlight frames of the observed peak usage.
+	GLuint size = _ringSize(m_rectsBuffers.vbo);
+	if (size != m_rectsBuffers.vbo.size) {
+		glBindVertexArray(m_rectsBuffers.vao);
+		m_type = BuffersType::rects;
+		_destroyBuffer(m_rectsBuffers.vbo);
+		_initBuffer(m_rectsBuffers.vbo, size);
+		_setRectAttribPointers();
+		m_rectBufferOffsets.clear();
+	}
+
+	const GLuint vboSize = _ringSize(m_trisBuffers.vbo);
+	const GLuint eboSize = _ringSize(m_trisBuffers.ebo);
+	if (vboSize != m_trisBuffers.vbo.size || eboSize != m_trisBuffers.ebo.size) {
+		glBindVertexArray(m_trisBuffers.vao);
+		m_type = BuffersType::triangles;
+		if (vboSize != m_trisBuffers.vbo.size) {
+			_destroyBuffer(m_trisBuffers.vbo);
+			_initBuffer(m_trisBuffers.vbo, vboSize);
+			_setTrisAttribPointers();
+		}
+		if (eboSize != m_trisBuffers.ebo.size) {
+			_destroyBuffer(m_trisBuffers.ebo);
+			_initBuffer(m_trisBuffers.ebo, eboSize);
+		}
+	}
+}
+
+bool BufferedDrawer::getDrawBufferStats(graphics::DrawBufferStats & _stats) const
+{
+	_stats = m_stats;
+	return true;
 }
@@ -20,6 +20,12 @@ namespace opengl {
 
 		void drawLine(f32 _width, SPVertex * _vertices) override;
 
+		void frameEnd() override;
+
+		bool getDrawBufferStats(graphics::DrawBufferStats & _stats) const override;
+
+		void flushDraws() override;
+
 	private:
 		void _updateRectBuffer(const graphics::Context::DrawRectParameters & _params);
 		void _updateTrianglesBuffers(const graphics::Context::DrawTriangleParameters & _params);
@@ -30,6 +36,10 @@ namespace opengl {
 			triangles
 		};
 
+		static const u32 m_numSegments = 8;
+
+		// Streaming ring split into m_numSegments segments.
+		// A segment is fenced when the ring moves past it and waited for before it is written again.
 		struct Buffer {
 			Buffer(GLenum _type) : type(_type) {}
 
@@ -39,6 +49,10 @@ namespace opengl {
 			GLint pos = 0;
 			GLuint size = 0;
 			GLubyte * data = nullptr;
+			GLsync fences[m_numSegments] = {};
+			u32 segment = 0;
+			u32 frameBytes = 0;
+			u32 peakFrameBytes = 0;
 		};
 
 		struct RectBuffers {
@@ -52,17 +66,37 @@ namespace opengl {
 			Buffer ebo = Buffer(GL_ELEMENT_ARRAY_BUFFER);
 		};
 
+		// Draws held back to be submitted with one glMultiDrawElementsBaseVertex for indexed triangles
+		// or one glMultiDrawArrays for rects. Any state change submits them first, so draw order is kept.
+		struct PendingDraws {
+			BuffersType type = BuffersType::none;
+			GLenum mode = GL_TRIANGLES;
+			std::vector<GLsizei> counts;
+			std::vector<const GLvoid *> indices;
+			std::vector<GLint> baseVertices;
+			std::vector<GLint> firsts;
+		};
+
 		struct Vertex
 		{
 			f32 x, y, z, w;
 			f32 r, g, b, a;
 			f32 s, t;
 			u32 modify;
+			f32 lightState;
+			TexArrayAttribs texArray;
 		};
 
 		void _initBuffer(Buffer & _buffer, GLuint _bufSize);
+		void _destroyBuffer(Buffer & _buffer);
+		GLuint _ringSize(const Buffer & _buffer) const;
+		void _setRectAttribPointers();
+		void _setTrisAttribPointers();
+		void _fenceSegments(Buffer & _buffer, u32 _end);
+		void _waitSegment(Buffer & _buffer, u32 _segment);
 		void _updateBuffer(Buffer & _buffer, u32 _count, u32 _dataSize, const void * _data);
-		void _convertFromSPVertex(bool _flatColors, u32 _count, const SPVertex * _data);
+		void _convertFromSPVertex(bool _flatColors, bool _shaderLighting, const TexArrayAttribs * _texArray,
+			u32 _count, const SPVertex * _data);
 
 		const GLInfo & m_glInfo;
 		CachedVertexAttribArray * m_cachedAttribArray;
@@ -71,13 +105,22 @@ namespace opengl {
 		RectBuffers m_rectsBuffers;
 		TrisBuffers m_trisBuffers;
 		BuffersType m_type = BuffersType::none;
+		u32 m_stalls = 0;
+		u32 m_draws = 0;
+		u32 m_submits = 0;
+		// Without buffer storage every buffer update rebinds the buffer, which submits held back draws anyway.
+		const bool m_batchDraws;
+		PendingDraws m_pending;
+		graphics::DrawBufferStats m_stats = {};
 
 		std::vector<Vertex> m_vertices;
 
 		typedef std::unordered_map<u32, u32> BufferOffsets;
 		BufferOffsets m_rectBufferOffsets;
 
+		static const u32 m_bufInitSize;
 		static const u32 m_bufMaxSize;
+		static const u32 m_framesInFlight = 3;
 		static const GLbitfield m_bufAccessBits;
 		static const GLbitfield m_bufMapBits;
 	};
@@ -31,9 +31,39 @@ void CachedEnable::enable(bool _enable)
 
 void CachedBindTexture::bind(Parameter _tmuIndex, Parameter _target, ObjectHandle _name)
 {
-	if (update(_tmuIndex, _name)) {
-		glActiveTexture(GL_TEXTURE0 + GLuint(_tmuIndex));
-		glBindTexture(GLenum(_target), GLuint(_name));
+	const u32 unit(_tmuIndex);
+#ifdef CACHED_USE_CACHE2
+	// Active unit must be set even if the texture is already bound:
+	// callers may modify the texture through the bind point.
+	if (m_activeUnit != _tmuIndex) {
+		m_activeUnit = _tmuIndex;
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+	if (unit < MaxTextureUnits && _name.isNotNull()) {
+		if (m_units[unit] == _name)
+			return;
+		m_units[unit] = _name;
+	} else if (unit < MaxTextureUnits)
+		m_units[unit].reset();
+#else
+	glActiveTexture(GL_TEXTURE0 + unit);
+#endif
+	GraphicsDrawer::flushPending();
+	glBindTexture(GLenum(_target), GLuint(_name));
+}
+
+void CachedBindTexture::reset()
+{
+	m_activeUnit.reset();
+	for (auto & name : m_units)
+		name.reset();
+}
+
+void CachedBindTexture::reset(ObjectHandle _deleted)
+{
+	for (auto & name : m_units) {
+		if (name == _deleted)
+			name.reset();
 	}
 }
 
@@ -109,6 +139,7 @@ void CachedVertexAttribArray::enableVertexAttribArray(u32 _index, bool _enable)
 		return;
 	m_attribs[_index] = Parameter(u32(_enable));
 
+	GraphicsDrawer::flushPending();
 	if (_enable)
 		glEnableVertexAttribArray(_index);
 	else
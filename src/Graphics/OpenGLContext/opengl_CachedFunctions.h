@@ -5,6 +5,7 @@
 #include <Graphics/Parameter.h>
 #include "opengl_GLInfo.h"
 #include "opengl_Attributes.h"
+#include "opengl_GraphicsDrawer.h"
 
 namespace opengl {
 
@@ -22,6 +23,7 @@ namespace opengl {
 			if (_param == m_cached)
 				return false;
 #endif
+			GraphicsDrawer::flushPending();
 			m_cached = _param;
 			return true;
 		}
@@ -46,6 +48,7 @@ namespace opengl {
 				_p2 == m_p2)
 				return false;
 #endif
+			GraphicsDrawer::flushPending();
 			m_p1 = _p1;
 			m_p2 = _p2;
 			return true;
@@ -77,6 +80,7 @@ namespace opengl {
 				_p4 == m_p4)
 			return false;
 #endif
+			GraphicsDrawer::flushPending();
 			m_p1 = _p1;
 			m_p2 = _p2;
 			m_p3 = _p3;
@@ -129,10 +133,18 @@ namespace opengl {
 
 	typedef CachedBind<decltype(GET_GL_FUNCTION(glBindBuffer))> CachedBindBuffer;
 
-	class CachedBindTexture : public Cached2<graphics::Parameter, graphics::ObjectHandle>
+	class CachedBindTexture
 	{
 	public:
 		void bind(graphics::Parameter _tmuIndex, graphics::Parameter _target, graphics::ObjectHandle _name);
+		void reset();
+		void reset(graphics::ObjectHandle _deleted);
+
+	private:
+		// Texture bound to each unit, so switching between units does not rebind.
+		static const u32 MaxTextureUnits = 9;
+		std::array<graphics::ObjectHandle, MaxTextureUnits> m_units;
+		graphics::Parameter m_activeUnit;
 	};
 
 	class CachedCullFace : public Cached1<graphics::Parameter>
@@ -1,5 +1,6 @@
 #include <Graphics/Context.h>
 #include "opengl_ColorBufferReaderWithBufferStorage.h"
+#include "opengl_GraphicsDrawer.h"
 
 using namespace graphics;
 using namespace opengl;
@@ -44,6 +45,7 @@ void ColorBufferReaderWithBufferStorage::_destroyBuffers()
 const u8 * ColorBufferReaderWithBufferStorage::_readPixels(const ReadColorBufferParams& _params, u32& _heightOffset,
 	u32& _stride)
 {
+	GraphicsDrawer::flushPending();
 	GLenum format = GLenum(_params.colorFormat);
 	GLenum type = GLenum(_params.colorType);
 
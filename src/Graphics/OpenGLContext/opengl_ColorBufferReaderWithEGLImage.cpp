@@ -3,6 +3,7 @@
 #include <GBI.h>
 #include <Graphics/Context.h>
 #include "opengl_ColorBufferReaderWithEGLImage.h"
+#include "opengl_GraphicsDrawer.h"
 
 using namespace opengl;
 using namespace graphics;
@@ -40,6 +41,7 @@ void ColorBufferReaderWithEGLImage::_initBuffers()
 const u8 * ColorBufferReaderWithEGLImage::_readPixels(const ReadColorBufferParams& _params, u32& _heightOffset,
 	u32& _stride)
 {
+	opengl::GraphicsDrawer::flushPending();
 	GLenum format = GLenum(_params.colorFormat);
 	GLenum type = GLenum(_params.colorType);
 
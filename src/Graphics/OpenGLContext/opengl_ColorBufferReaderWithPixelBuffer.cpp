@@ -1,5 +1,6 @@
 #include <Graphics/Context.h>
 #include "opengl_ColorBufferReaderWithPixelBuffer.h"
+#include "opengl_GraphicsDrawer.h"
 
 using namespace graphics;
 using namespace opengl;
@@ -42,6 +43,7 @@ void ColorBufferReaderWithPixelBuffer::_initBuffers()
 const u8 * ColorBufferReaderWithPixelBuffer::_readPixels(const ReadColorBufferParams& _params, u32& _heightOffset,
 	u32& _stride)
 {
+	GraphicsDrawer::flushPending();
 	GLenum format = GLenum(_params.colorFormat);
 	GLenum type = GLenum(_params.colorType);
 
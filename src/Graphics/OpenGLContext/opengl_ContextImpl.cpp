@@ -72,6 +72,9 @@ void ContextImpl::init()
 		m_combinerProgramBuilder->getVertexShaderHeader(),
 		m_combinerProgramBuilder->getFragmentShaderHeader(),
 		m_combinerProgramBuilder->getFragmentShaderEnd()));
+
+	if (config.onScreenDisplay.gpuTime != 0 && m_glInfo.timerQuery)
+		m_timerQueries.reset(new TimerQueries);
 }
 
 void ContextImpl::destroy()
@@ -85,7 +88,9 @@ void ContextImpl::destroy()
 	m_initRenderbuffer.reset();
 	m_addFramebufferRenderTarget.reset();
 	m_graphicsDrawer.reset();
+	m_shaderStorage.reset();
 	m_combinerProgramBuilder.reset();
+	m_timerQueries.reset();
 
 	m_cachedFunctions.reset();
 }
@@ -132,6 +137,7 @@ void ContextImpl::setBlendColor(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 
 void ContextImpl::clearColorBuffer(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 {
+	GraphicsDrawer::flushPending();
 	CachedEnable * enableScissor = m_cachedFunctions->getCachedEnable(graphics::enable::SCISSOR_TEST);
 	enableScissor->enable(false);
 
@@ -143,6 +149,7 @@ void ContextImpl::clearColorBuffer(f32 _red, f32 _green, f32 _blue, f32 _alpha)
 
 void ContextImpl::clearDepthBuffer()
 {
+	GraphicsDrawer::flushPending();
 	CachedEnable * enableScissor = m_cachedFunctions->getCachedEnable(graphics::enable::SCISSOR_TEST);
 	CachedDepthMask * depthMask = m_cachedFunctions->getCachedDepthMask();
 	enableScissor->enable(false);
@@ -160,6 +167,7 @@ void ContextImpl::clearDepthBuffer()
 
 void ContextImpl::setPolygonOffset(f32 _factor, f32 _units)
 {
+	GraphicsDrawer::flushPending();
 	glPolygonOffset(_factor, _units);
 }
 
@@ -172,21 +180,48 @@ graphics::ObjectHandle ContextImpl::createTexture(graphics::Parameter _target)
 
 void ContextImpl::deleteTexture(graphics::ObjectHandle _name)
 {
+	GraphicsDrawer::flushPending();
 	u32 glName(_name);
 	glDeleteTextures(1, &glName);
 	m_init2DTexture->reset(_name);
+	m_set2DTextureParameters->reset(_name);
+	m_cachedFunctions->getCachedBindTexture()->reset(_name);
 }
 
 void ContextImpl::init2DTexture(const graphics::Context::InitTextureParams & _params)
 {
+	GraphicsDrawer::flushPending();
 	m_init2DTexture->init2DTexture(_params);
 }
 
 void ContextImpl::update2DTexture(const graphics::Context::UpdateTextureDataParams & _params)
 {
+	GraphicsDrawer::flushPending();
 	m_update2DTexture->update2DTexture(_params);
 }
 
+void ContextImpl::initTextureArray(const graphics::Context::InitTextureParams & _params)
+{
+	GraphicsDrawer::flushPending();
+	m_cachedFunctions->getCachedBindTexture()->bind(_params.textureUnitIndex, graphics::textureTarget::TEXTURE_2D_ARRAY, _params.handle);
+	if (m_glInfo.texStorage)
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GLenum(_params.internalFormat), _params.width, _params.height, _params.layers);
+	else
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GLint(_params.internalFormat), _params.width, _params.height, _params.layers,
+			0, GLenum(_params.format), GLenum(_params.dataType), nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+}
+
+void ContextImpl::updateTextureArray(const graphics::Context::UpdateTextureDataParams & _params)
+{
+	GraphicsDrawer::flushPending();
+	m_cachedFunctions->getCachedBindTexture()->bind(_params.textureUnitIndex, graphics::textureTarget::TEXTURE_2D_ARRAY, _params.handle);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, _params.x, _params.y, _params.layer, _params.width, _params.height, 1,
+		GLenum(_params.format), GLenum(_params.dataType), _params.data);
+}
+
 void ContextImpl::setTextureParameters(const graphics::Context::TexParameters & _parameters)
 {
 	m_set2DTextureParameters->setTextureParameters(_parameters);
@@ -217,6 +252,7 @@ s32 ContextImpl::getMaxTextureSize() const
 
 void ContextImpl::bindImageTexture(const graphics::Context::BindImageTextureParameters & _params)
 {
+	GraphicsDrawer::flushPending();
 	if (IS_GL_FUNCTION_VALID(glBindImageTexture))
 		glBindImageTexture(GLuint(_params.imageUnit), GLuint(_params.texture), 0, GL_FALSE, 0, GLenum(_params.accessMode), GLenum(_params.textureFormat));
 }
@@ -254,6 +290,7 @@ void ContextImpl::deleteFramebuffer(graphics::ObjectHandle _name)
 {
 	u32 fbo(_name);
 	if (fbo != 0) {
+		GraphicsDrawer::flushPending();
 		glDeleteFramebuffers(1, &fbo);
 		m_cachedFunctions->getCachedBindFramebuffer()->reset();
 	}
@@ -262,6 +299,7 @@ void ContextImpl::deleteFramebuffer(graphics::ObjectHandle _name)
 void ContextImpl::bindFramebuffer(graphics::BufferTargetParam _target, graphics::ObjectHandle _name)
 {
 	if (m_glInfo.renderer == Renderer::VideoCore) {
+		GraphicsDrawer::flushPending();
 		CachedDepthMask * depthMask = m_cachedFunctions->getCachedDepthMask();
 		depthMask->setDepthMask(true);
 		glClear(GL_DEPTH_BUFFER_BIT);
@@ -276,16 +314,21 @@ graphics::ObjectHandle ContextImpl::createRenderbuffer()
 
 void ContextImpl::initRenderbuffer(const graphics::Context::InitRenderbufferParams & _params)
 {
+	GraphicsDrawer::flushPending();
 	m_initRenderbuffer->initRenderbuffer(_params);
 }
 
 void ContextImpl::addFrameBufferRenderTarget(const graphics::Context::FrameBufferRenderTarget & _params)
 {
+	GraphicsDrawer::flushPending();
 	m_addFramebufferRenderTarget->addFrameBufferRenderTarget(_params);
 }
 
 bool ContextImpl::blitFramebuffers(const graphics::Context::BlitFramebuffersParams & _params)
 {
+	GraphicsDrawer::flushPending();
+	if (m_timerQueries)
+		m_timerQueries->mark(graphics::GPUTimerStage::Blit);
 	return m_blitFramebuffers->blitFramebuffers(_params);
 }
 
@@ -324,16 +367,31 @@ graphics::CombinerProgram * ContextImpl::createCombinerProgram(Combiner & _color
 	return m_combinerProgramBuilder->buildCombinerProgram(_color, _alpha, _key);
 }
 
-bool ContextImpl::saveShadersStorage(const graphics::Combiners & _combiners)
+bool ContextImpl::openShadersStorage()
+{
+	if (!m_shaderStorage)
+		m_shaderStorage.reset(new glsl::ShaderStorage(m_glInfo, m_cachedFunctions->getCachedUseProgram()));
+	return m_shaderStorage->open();
+}
+
+void ContextImpl::closeShadersStorage()
 {
-	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram());
-	return storage.saveShadersStorage(_combiners);
+	if (m_shaderStorage)
+		m_shaderStorage->close();
 }
 
-bool ContextImpl::loadShadersStorage(graphics::Combiners & _combiners)
+graphics::CombinerProgram * ContextImpl::loadShaderProgram(const CombinerKey & _key)
 {
-	glsl::ShaderStorage storage(m_glInfo, m_cachedFunctions->getCachedUseProgram());
-	return storage.loadShadersStorage(_combiners);
+	if (!m_shaderStorage)
+		return nullptr;
+	return m_shaderStorage->loadShaderProgram(_key);
+}
+
+bool ContextImpl::storeShaderProgram(graphics::CombinerProgram * _program)
+{
+	if (!m_shaderStorage)
+		return false;
+	return m_shaderStorage->storeShaderProgram(_program);
 }
 
 graphics::ShaderProgram * ContextImpl::createDepthFogShader()
@@ -361,14 +419,14 @@ graphics::ShaderProgram * ContextImpl::createTexrectCopyShader()
 	return m_specialShadersFactory->createTexrectCopyShader();
 }
 
-graphics::ShaderProgram * ContextImpl::createGammaCorrectionShader()
+graphics::ShaderProgram * ContextImpl::createPostProcessingShader(u32 _stages)
 {
-	return m_specialShadersFactory->createGammaCorrectionShader();
+	return m_specialShadersFactory->createPostProcessingShader(_stages);
 }
 
-graphics::ShaderProgram * ContextImpl::createOrientationCorrectionShader()
+graphics::DualFilterShaderProgram * ContextImpl::createDualFilterShader(graphics::DualFilterPass _pass)
 {
-	return m_specialShadersFactory->createOrientationCorrectionShader();
+	return m_specialShadersFactory->createDualFilterShader(_pass);
 }
 
 graphics::TextDrawerShaderProgram * ContextImpl::createTextDrawerShader()
@@ -383,19 +441,30 @@ void ContextImpl::resetShaderProgram()
 
 void ContextImpl::drawTriangles(const graphics::Context::DrawTriangleParameters & _params)
 {
+	if (m_timerQueries)
+		m_timerQueries->mark(graphics::GPUTimerStage::Draw);
 	m_graphicsDrawer->drawTriangles(_params);
 }
 
 void ContextImpl::drawRects(const graphics::Context::DrawRectParameters & _params)
 {
+	if (m_timerQueries)
+		m_timerQueries->mark(graphics::GPUTimerStage::Draw);
 	m_graphicsDrawer->drawRects(_params);
 }
 
 void ContextImpl::drawLine(f32 _width, SPVertex * _vertices)
 {
+	if (m_timerQueries)
+		m_timerQueries->mark(graphics::GPUTimerStage::Draw);
 	m_graphicsDrawer->drawLine(_width, _vertices);
 }
 
+void ContextImpl::flushDraws()
+{
+	GraphicsDrawer::flushPending();
+}
+
 
 f32 ContextImpl::getMaxLineWidth()
 {
@@ -421,6 +490,18 @@ bool ContextImpl::isSupported(graphics::SpecialFeatures _feature) const
 		return m_glInfo.imageTextures;
 	case graphics::SpecialFeatures::ShaderProgramBinary:
 		return m_glInfo.shaderStorage;
+	case graphics::SpecialFeatures::GPUTimers:
+		return m_glInfo.timerQuery;
+	case graphics::SpecialFeatures::VertexShaderLighting:
+		return !m_glInfo.isGLES2;
+	case graphics::SpecialFeatures::TextureCompressionS3TC:
+		return m_glInfo.s3tc;
+	case graphics::SpecialFeatures::TextureCompressionETC2:
+		return m_glInfo.etc2;
+	case graphics::SpecialFeatures::PersistentPixelBuffers:
+		return !m_glInfo.isGLES2 && m_glInfo.bufferStorage;
+	case graphics::SpecialFeatures::TextureArrays:
+		return !m_glInfo.isGLES2;
 	case graphics::SpecialFeatures::DepthFramebufferTextures:
 		if (!m_glInfo.isGLES2 || Utils::isExtensionSupported(m_glInfo, "GL_OES_depth_texture"))
 			return true;
@@ -439,3 +520,41 @@ bool ContextImpl::isFramebufferError() const
 {
 	return Utils::isFramebufferError();
 }
+
+void ContextImpl::beginGPUTimer(graphics::GPUTimerStage _stage)
+{
+	GraphicsDrawer::flushPending();
+	if (m_timerQueries)
+		m_timerQueries->begin(_stage);
+}
+
+void ContextImpl::endGPUTimer(graphics::GPUTimerStage _stage)
+{
+	GraphicsDrawer::flushPending();
+	if (m_timerQueries)
+		m_timerQueries->end(_stage);
+}
+
+void ContextImpl::resolveGPUTimers()
+{
+	if (m_timerQueries)
+		m_timerQueries->frameEnd();
+}
+
+bool ContextImpl::getGPUTimings(graphics::GPUTimings & _timings) const
+{
+	if (!m_timerQueries)
+		return false;
+	_timings = m_timerQueries->getTimings();
+	return true;
+}
+
+void ContextImpl::frameEnd()
+{
+	m_graphicsDrawer->frameEnd();
+}
+
+bool ContextImpl::getDrawBufferStats(graphics::DrawBufferStats & _stats) const
+{
+	return m_graphicsDrawer->getDrawBufferStats(_stats);
+}
@@ -6,10 +6,12 @@
 #include "opengl_GLInfo.h"
 #include "opengl_CachedFunctions.h"
 #include "opengl_GraphicsDrawer.h"
+#include "opengl_TimerQueries.h"
 
 namespace glsl {
 	class CombinerProgramBuilder;
 	class SpecialShadersFactory;
+	class ShaderStorage;
 }
 
 namespace opengl {
@@ -56,6 +58,10 @@ namespace opengl {
 
 		void update2DTexture(const graphics::Context::UpdateTextureDataParams & _params) override;
 
+		void initTextureArray(const graphics::Context::InitTextureParams & _params) override;
+
+		void updateTextureArray(const graphics::Context::UpdateTextureDataParams & _params) override;
+
 		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override;
 
 		void bindTexture(const graphics::Context::BindTextureParameters & _params) override;
@@ -100,9 +106,13 @@ namespace opengl {
 
 		graphics::CombinerProgram * createCombinerProgram(Combiner & _color, Combiner & _alpha, const CombinerKey & _key) override;
 
-		bool saveShadersStorage(const graphics::Combiners & _combiners) override;
+		bool openShadersStorage() override;
+
+		void closeShadersStorage() override;
 
-		bool loadShadersStorage(graphics::Combiners & _combiners) override;
+		graphics::CombinerProgram * loadShaderProgram(const CombinerKey & _key) override;
+
+		bool storeShaderProgram(graphics::CombinerProgram * _program) override;
 
 		graphics::ShaderProgram * createDepthFogShader() override;
 
@@ -114,9 +124,9 @@ namespace opengl {
 
 		graphics::ShaderProgram * createTexrectCopyShader() override;
 
-		graphics::ShaderProgram * createGammaCorrectionShader() override;
+		graphics::ShaderProgram * createPostProcessingShader(u32 _stages) override;
 
-		graphics::ShaderProgram * createOrientationCorrectionShader() override;
+		graphics::DualFilterShaderProgram * createDualFilterShader(graphics::DualFilterPass _pass) override;
 
 		graphics::TextDrawerShaderProgram * createTextDrawerShader() override;
 
@@ -128,6 +138,8 @@ namespace opengl {
 
 		void drawLine(f32 _width, SPVertex * _vertices) override;
 
+		void flushDraws() override;
+
 		f32 getMaxLineWidth() override;
 
 		bool isSupported(graphics::SpecialFeatures _feature) const override;
@@ -136,6 +148,20 @@ namespace opengl {
 
 		bool isFramebufferError() const override;
 
+		/*---------------Profiling-------------*/
+
+		void beginGPUTimer(graphics::GPUTimerStage _stage) override;
+
+		void endGPUTimer(graphics::GPUTimerStage _stage) override;
+
+		void resolveGPUTimers() override;
+
+		bool getGPUTimings(graphics::GPUTimings & _timings) const override;
+
+		void frameEnd() override;
+
+		bool getDrawBufferStats(graphics::DrawBufferStats & _stats) const override;
+
 	private:
 		std::unique_ptr<CachedFunctions> m_cachedFunctions;
 		std::unique_ptr<Create2DTexture> m_createTexture;
@@ -156,6 +182,8 @@ namespace opengl {
 
 		std::unique_ptr<glsl::CombinerProgramBuilder> m_combinerProgramBuilder;
 		std::unique_ptr<glsl::SpecialShadersFactory> m_specialShadersFactory;
+		std::unique_ptr<glsl::ShaderStorage> m_shaderStorage;
+		std::unique_ptr<TimerQueries> m_timerQueries;
 		GLInfo m_glInfo;
 	};
 
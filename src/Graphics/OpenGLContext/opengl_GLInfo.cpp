@@ -63,6 +63,13 @@ void GLInfo::init() {
 #endif
 	texStorage = (isGLESX && (numericVersion >= 30)) || (!isGLESX && numericVersion >= 42) ||
 			Utils::isExtensionSupported(*this, "GL_ARB_texture_storage");
+	timerQuery = !isGLESX && ((numericVersion >= 33) || Utils::isExtensionSupported(*this, "GL_ARB_timer_query")) &&
+			IS_GL_FUNCTION_VALID(glQueryCounter) && IS_GL_FUNCTION_VALID(glGetQueryObjectui64v);
+	multiDraw = !isGLESX && ((numericVersion >= 32) || Utils::isExtensionSupported(*this, "GL_ARB_draw_elements_base_vertex")) &&
+			IS_GL_FUNCTION_VALID(glMultiDrawElementsBaseVertex) && IS_GL_FUNCTION_VALID(glMultiDrawArrays);
+	s3tc = Utils::isExtensionSupported(*this, "GL_EXT_texture_compression_s3tc") && IS_GL_FUNCTION_VALID(glCompressedTexImage2D);
+	etc2 = ((isGLESX && numericVersion >= 30) || (!isGLESX && numericVersion >= 43) ||
+			Utils::isExtensionSupported(*this, "GL_ARB_ES3_compatibility")) && IS_GL_FUNCTION_VALID(glCompressedTexImage2D);
 
 	shaderStorage = false;
 	if (config.generalEmulation.enableShadersStorage != 0) {
@@ -21,6 +21,10 @@ struct GLInfo {
 	bool texStorage    = false;
 	bool shaderStorage = false;
 	bool msaa = false;
+	bool timerQuery = false;
+	bool multiDraw = false;
+	bool s3tc = false;
+	bool etc2 = false;
 	Renderer renderer = Renderer::Other;
 
 	void init();
@@ -13,6 +13,24 @@ namespace opengl {
 		virtual void drawRects(const graphics::Context::DrawRectParameters & _params) = 0;
 
 		virtual void drawLine(f32 _width, SPVertex * _vertices) = 0;
+
+		virtual void frameEnd() {}
+
+		virtual bool getDrawBufferStats(graphics::DrawBufferStats & _stats) const { return false; }
+
+		// Submits draws held back for batching.
+		virtual void flushDraws() {}
+
+		// Held back draws were issued with the current GL state,
+		// so they must be submitted before any of it changes.
+		static void flushPending()
+		{
+			if (s_pending != nullptr)
+				s_pending->flushDraws();
+		}
+
+	protected:
+		static GraphicsDrawer * s_pending;
 	};
 }
 
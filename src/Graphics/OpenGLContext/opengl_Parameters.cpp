@@ -21,6 +21,9 @@ namespace graphics {
 		InternalColorFormatParam DEPTH(GL_DEPTH_COMPONENT24);
 		InternalColorFormatParam RG32F(GL_RG32F);
 		InternalColorFormatParam LUMINANCE(0x1909);
+		InternalColorFormatParam COMPRESSED_RGB_S3TC_DXT1(0x83F0);
+		InternalColorFormatParam COMPRESSED_RGBA_S3TC_DXT5(0x83F3);
+		InternalColorFormatParam COMPRESSED_RGB8_ETC2(0x9274);
 	}
 
 	namespace datatype {
@@ -35,6 +38,7 @@ namespace graphics {
 	namespace textureTarget {
 		TextureTargetParam TEXTURE_2D(GL_TEXTURE_2D);
 		TextureTargetParam TEXTURE_2D_MULTISAMPLE(GL_TEXTURE_2D_MULTISAMPLE);
+		TextureTargetParam TEXTURE_2D_ARRAY(GL_TEXTURE_2D_ARRAY);
 		TextureTargetParam RENDERBUFFER(GL_RENDERBUFFER);
 	}
 
@@ -67,6 +71,7 @@ namespace graphics {
 		TextureUnitParam ZLUTTex(4U);
 		TextureUnitParam PaletteTex(5U);
 		TextureUnitParam MSTex[2] = { 6U, 7U };
+		TextureUnitParam ArrayTex(8U);
 	}
 
 	namespace textureImageUnits {
@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <Graphics/Parameters.h>
 #include "opengl_GLInfo.h"
 #include "opengl_CachedFunctions.h"
@@ -50,6 +51,21 @@ namespace opengl {
 
 	/*---------------Init2DTexture-------------*/
 
+	// Returns image size in bytes for block compressed formats, 0 for uncompressed ones.
+	static
+	GLsizei compressedImageSize(GLenum _internalFormat, u32 _width, u32 _height)
+	{
+		const GLsizei blocks = GLsizei(((_width + 3) >> 2) * ((_height + 3) >> 2));
+		switch (_internalFormat) {
+		case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+		case 0x9274: // GL_COMPRESSED_RGB8_ETC2
+			return blocks * 8;
+		case 0x83F3: // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+			return blocks * 16;
+		}
+		return 0;
+	}
+
 	class Init2DTexImage : public Init2DTexture
 	{
 	public:
@@ -60,6 +76,18 @@ namespace opengl {
 			if (_params.msaaLevel == 0) {
 
 				m_bind->bind(_params.textureUnitIndex, graphics::textureTarget::TEXTURE_2D, _params.handle);
+				const GLsizei compressedSize = compressedImageSize(GLenum(_params.internalFormat), _params.width, _params.height);
+				if (compressedSize != 0) {
+					glCompressedTexImage2D(GL_TEXTURE_2D,
+										   _params.mipMapLevel,
+										   GLenum(_params.internalFormat),
+										   _params.width,
+										   _params.height,
+										   0,
+										   compressedSize,
+										   _params.data);
+					return;
+				}
 				glTexImage2D(GL_TEXTURE_2D,
 							 _params.mipMapLevel,
 							 GLuint(_params.internalFormat),
@@ -81,7 +109,7 @@ namespace opengl {
 		}
 
 		void reset(graphics::ObjectHandle _deleted) override {
-			m_bind->reset();
+			m_bind->reset(_deleted);
 		}
 
 	private:
@@ -108,8 +136,8 @@ namespace opengl {
 		{
 			if (_params.msaaLevel == 0) {
 				m_bind->bind(_params.textureUnitIndex, graphics::textureTarget::TEXTURE_2D, _params.handle);
-				if (m_handle != _params.handle) {
-					m_handle = _params.handle;
+				// Texture objects keep their immutable storage when reused
+				if (m_storage.insert(u32(_params.handle)).second) {
 					glTexStorage2D(GL_TEXTURE_2D,
 								   _params.mipMapLevels,
 								   GLenum(_params.internalFormat),
@@ -117,7 +145,18 @@ namespace opengl {
 								   _params.height);
 				}
 
-				if (_params.data != nullptr) {
+				const GLsizei compressedSize = compressedImageSize(GLenum(_params.internalFormat), _params.width, _params.height);
+				if (compressedSize != 0) {
+					if (_params.data != nullptr)
+						glCompressedTexSubImage2D(GL_TEXTURE_2D,
+							_params.mipMapLevel,
+							0, 0,
+							_params.width,
+							_params.height,
+							GLenum(_params.internalFormat),
+							compressedSize,
+							_params.data);
+				} else if (_params.data != nullptr) {
 					glTexSubImage2D(GL_TEXTURE_2D,
 						_params.mipMapLevel,
 						0, 0,
@@ -147,15 +186,14 @@ namespace opengl {
 
 		void reset(graphics::ObjectHandle _deleted) override
 		{
-			m_bind->reset();
-			if (m_handle == _deleted)
-				m_handle = graphics::ObjectHandle(0);
+			m_bind->reset(_deleted);
+			m_storage.erase(u32(_deleted));
 		}
 
 	private:
 		CachedBindTexture* m_bind;
 		bool m_imageTextures;
-		graphics::ObjectHandle m_handle;
+		std::unordered_set<u32> m_storage;
 	};
 
 	class Init2DTextureStorage : public Init2DTexture
@@ -172,8 +210,7 @@ namespace opengl {
 		{
 
 			if (_params.msaaLevel == 0) {
-				if (m_handle != _params.handle) {
-					m_handle = _params.handle;
+				if (m_storage.insert(u32(_params.handle)).second) {
 					glTextureStorage2D(GLuint(_params.handle),
 								   _params.mipMapLevels,
 								   GLenum(_params.internalFormat),
@@ -181,7 +218,18 @@ namespace opengl {
 								   _params.height);
 				}
 
-				if (_params.data != nullptr) {
+				const GLsizei compressedSize = compressedImageSize(GLenum(_params.internalFormat), _params.width, _params.height);
+				if (compressedSize != 0) {
+					if (_params.data != nullptr)
+						glCompressedTextureSubImage2D(GLuint(_params.handle),
+							_params.mipMapLevel,
+							0, 0,
+							_params.width,
+							_params.height,
+							GLenum(_params.internalFormat),
+							compressedSize,
+							_params.data);
+				} else if (_params.data != nullptr) {
 					glTextureSubImage2D(GLuint(_params.handle),
 						_params.mipMapLevel,
 						0, 0,
@@ -210,12 +258,11 @@ namespace opengl {
 
 		void reset(graphics::ObjectHandle _deleted) override
 		{
-			if (m_handle == _deleted)
-				m_handle = graphics::ObjectHandle(0);
+			m_storage.erase(u32(_deleted));
 		}
 
 	private:
-		graphics::ObjectHandle m_handle;
+		std::unordered_set<u32> m_storage;
 	};
 
 	/*---------------Update2DTexture-------------*/
@@ -285,6 +332,54 @@ namespace opengl {
 
 	/*---------------Set2DTextureParameters-------------*/
 
+	// Keeps parameters already applied to each texture object.
+	// Texture cache activates the same small textures many times per frame
+	// with the same sampler state, so most glTexParameter calls are redundant.
+	class TextureParametersCache
+	{
+	public:
+		typedef graphics::Context::TexParameters TexParameters;
+
+		// Returns parameters which differ from the applied ones.
+		// Draws held back with the applied parameters are submitted before they change.
+		TexParameters update(const TexParameters & _parameters)
+		{
+			TexParameters & cached = m_parameters[u32(_parameters.handle)];
+			TexParameters changed;
+			changed.handle = _parameters.handle;
+			changed.textureUnitIndex = _parameters.textureUnitIndex;
+			changed.target = _parameters.target;
+			bool bChanged = false;
+			bChanged |= _update(_parameters.magFilter, cached.magFilter, changed.magFilter);
+			bChanged |= _update(_parameters.minFilter, cached.minFilter, changed.minFilter);
+			bChanged |= _update(_parameters.wrapS, cached.wrapS, changed.wrapS);
+			bChanged |= _update(_parameters.wrapT, cached.wrapT, changed.wrapT);
+			bChanged |= _update(_parameters.maxMipmapLevel, cached.maxMipmapLevel, changed.maxMipmapLevel);
+			bChanged |= _update(_parameters.maxAnisotropy, cached.maxAnisotropy, changed.maxAnisotropy);
+			if (bChanged)
+				GraphicsDrawer::flushPending();
+			return changed;
+		}
+
+		void reset(graphics::ObjectHandle _deleted)
+		{
+			m_parameters.erase(u32(_deleted));
+		}
+
+	private:
+		template<class T>
+		static bool _update(const T & _value, T & _cached, T & _changed)
+		{
+			if (!_value.isValid() || _value == _cached)
+				return false;
+			_cached = _value;
+			_changed = _value;
+			return true;
+		}
+
+		std::unordered_map<u32, TexParameters> m_parameters;
+	};
+
 	class SetTexParameters : public Set2DTextureParameters
 	{
 	public:
@@ -293,9 +388,10 @@ namespace opengl {
 			, m_supportMipmapLevel(_supportMipmapLevel) {
 		}
 
-		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override
+		void setTextureParameters(const graphics::Context::TexParameters & _params) override
 		{
-			m_bind->bind(_parameters.textureUnitIndex, _parameters.target, _parameters.handle);
+			m_bind->bind(_params.textureUnitIndex, _params.target, _params.handle);
+			const graphics::Context::TexParameters _parameters = m_cache.update(_params);
 			const GLenum target(_parameters.target);
 			if (_parameters.magFilter.isValid())
 				glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GLint(_parameters.magFilter));
@@ -308,12 +404,18 @@ namespace opengl {
 			if (m_supportMipmapLevel && _parameters.maxMipmapLevel.isValid())
 				glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, GLint(_parameters.maxMipmapLevel));
 			if (_parameters.maxAnisotropy.isValid())
-				glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, GLfloat(_parameters.maxMipmapLevel));
+				glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, GLfloat(_parameters.maxAnisotropy));
+		}
+
+		void reset(graphics::ObjectHandle _deleted) override
+		{
+			m_cache.reset(_deleted);
 		}
 
 	private:
 		CachedBindTexture* m_bind;
 		bool m_supportMipmapLevel;
+		TextureParametersCache m_cache;
 	};
 
 
@@ -330,16 +432,10 @@ namespace opengl {
 
 		SetTextureParameters() {}
 
-		void setTextureParameters(const graphics::Context::TexParameters & _parameters) override
+		void setTextureParameters(const graphics::Context::TexParameters & _params) override
 		{
+			const graphics::Context::TexParameters _parameters = m_cache.update(_params);
 			const u32 handle(_parameters.handle);
-			auto it = m_parameters.find(handle);
-			// TODO make cacheable
-			if (it == m_parameters.end()) {
-				auto res = m_parameters.emplace(handle, _parameters);
-				if (res.second)
-					it = res.first;
-			}
 
 			if (_parameters.magFilter.isValid())
 				glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GLint(_parameters.magFilter));
@@ -355,9 +451,13 @@ namespace opengl {
 				glTextureParameterf(handle, GL_TEXTURE_MAX_ANISOTROPY_EXT, GLfloat(_parameters.maxAnisotropy));
 		}
 
+		void reset(graphics::ObjectHandle _deleted) override
+		{
+			m_cache.reset(_deleted);
+		}
+
 	private:
-		typedef std::unordered_map<u32, graphics::Context::TexParameters> TextureParameters;
-		TextureParameters m_parameters;
+		TextureParametersCache m_cache;
 	};
 
 	/*---------------TextureManipulationObjectFactory-------------*/
@@ -35,6 +35,7 @@ namespace opengl {
 	public:
 		virtual ~Set2DTextureParameters() {}
 		virtual void setTextureParameters(const graphics::Context::TexParameters & _parameters) = 0;
+		virtual void reset(graphics::ObjectHandle _deleted) = 0;
 	};
 
 	class TextureManipulationObjectFactory
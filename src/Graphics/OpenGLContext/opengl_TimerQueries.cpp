@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "opengl_TimerQueries.h"
+
+using namespace opengl;
+using graphics::GPUTimerStage;
+
+TimerQueries::TimerQueries()
+: m_curFrame(0)
+, m_curStage(NoStage)
+{
+	std::fill(std::begin(m_timings.stageTime), std::end(m_timings.stageTime), 0.0f);
+	m_timings.frameTime = 0.0f;
+}
+
+TimerQueries::~TimerQueries()
+{
+	for (u32 i = 0; i < FramesInFlight; ++i)
+		_release(m_frames[i]);
+	if (!m_freeQueries.empty())
+		glDeleteQueries(GLsizei(m_freeQueries.size()), m_freeQueries.data());
+}
+
+void TimerQueries::_timestamp(u32 _stage)
+{
+	GLuint name;
+	if (m_freeQueries.empty()) {
+		glGenQueries(1, &name);
+	} else {
+		name = m_freeQueries.back();
+		m_freeQueries.pop_back();
+	}
+	glQueryCounter(name, GL_TIMESTAMP);
+	m_frames[m_curFrame].push_back({ name, _stage });
+}
+
+void TimerQueries::mark(GPUTimerStage _stage)
+{
+	if (!m_stack.empty() || m_curStage == u32(_stage))
+		return;
+	m_curStage = u32(_stage);
+	_timestamp(m_curStage);
+}
+
+void TimerQueries::begin(GPUTimerStage _stage)
+{
+	m_stack.push_back(m_curStage);
+	if (m_curStage == u32(_stage))
+		return;
+	m_curStage = u32(_stage);
+	_timestamp(m_curStage);
+}
+
+void TimerQueries::end(GPUTimerStage _stage)
+{
+	if (m_stack.empty())
+		return;
+	const u32 prevStage = m_stack.back();
+	m_stack.pop_back();
+	if (prevStage == m_curStage)
+		return;
+	m_curStage = prevStage;
+	_timestamp(m_curStage);
+}
+
+void TimerQueries::_release(std::vector<Query> & _frame)
+{
+	for (const Query & q : _frame)
+		m_freeQueries.push_back(q.name);
+	_frame.clear();
+}
+
+bool TimerQueries::_resolve(std::vector<Query> & _frame)
+{
+	if (_frame.size() < 2)
+		return false;
+
+	GLint available = 0;
+	glGetQueryObjectiv(_frame.back().name, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == 0)
+		return false;
+
+	GLuint64 stageTime[NoStage + 1] = {};
+	GLuint64 prev = 0, first = 0;
+	for (size_t i = 0; i < _frame.size(); ++i) {
+		GLuint64 stamp = 0;
+		glGetQueryObjectui64v(_frame[i].name, GL_QUERY_RESULT, &stamp);
+		if (i == 0)
+			first = stamp;
+		else if (stamp > prev)
+			stageTime[_frame[i - 1].stage] += stamp - prev;
+		prev = stamp;
+	}
+
+	for (u32 i = 0; i < NoStage; ++i)
+		m_timings.stageTime[i] = f32(stageTime[i]) / 1000000.0f;
+	m_timings.frameTime = prev > first ? f32(prev - first) / 1000000.0f : 0.0f;
+	return true;
+}
+
+void TimerQueries::frameEnd()
+{
+	if (!m_frames[m_curFrame].empty())
+		_timestamp(NoStage);
+	m_stack.clear();
+	m_curStage = NoStage;
+
+	m_curFrame = (m_curFrame + 1) % FramesInFlight;
+	// The slot about to be reused holds the oldest frame. If its results are
+	// still not available, drop it rather than wait for the GPU.
+	_resolve(m_frames[m_curFrame]);
+	_release(m_frames[m_curFrame]);
+}
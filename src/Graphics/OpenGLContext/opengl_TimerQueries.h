@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <Graphics/Context.h>
+#include "GLFunctions.h"
+
+namespace opengl {
+
+	// Ring of GL_TIMESTAMP queries. Each timestamp opens an interval which is
+	// attributed to a stage until the next timestamp. Results are read back
+	// a few frames later without stalling the pipeline.
+	class TimerQueries
+	{
+	public:
+		TimerQueries();
+		~TimerQueries();
+
+		// Implicit stage switch for draws and blits. Ignored inside begin/end.
+		void mark(graphics::GPUTimerStage _stage);
+
+		void begin(graphics::GPUTimerStage _stage);
+
+		void end(graphics::GPUTimerStage _stage);
+
+		void frameEnd();
+
+		const graphics::GPUTimings & getTimings() const { return m_timings; }
+
+	private:
+		struct Query {
+			GLuint name;
+			u32 stage;
+		};
+
+		void _timestamp(u32 _stage);
+		bool _resolve(std::vector<Query> & _frame);
+		void _release(std::vector<Query> & _frame);
+
+		static const u32 FramesInFlight = 4;
+		static const u32 NoStage = u32(graphics::GPUTimerStage::Count);
+
+		std::vector<Query> m_frames[FramesInFlight];
+		std::vector<GLuint> m_freeQueries;
+		std::vector<u32> m_stack;
+		u32 m_curFrame;
+		u32 m_curStage;
+		graphics::GPUTimings m_timings;
+	};
+
+}
@@ -15,10 +15,15 @@ UnbufferedDrawer::UnbufferedDrawer(const GLInfo & _glinfo, CachedVertexAttribArr
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texcoord, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::numlights, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::modify, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texArray0, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texArray1, false);
 
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::position, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord0, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, false);
 
 	m_attribsData.fill(nullptr);
 }
@@ -69,12 +74,33 @@ void UnbufferedDrawer::drawTriangles(const graphics::Context::DrawTriangleParame
 			glVertexAttribPointer(triangleAttrib::modify, 4, GL_BYTE, GL_FALSE, sizeof(SPVertex), ptr);
 	}
 
+	if (_params.shaderLighting) {
+		m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, true);
+		const void * ptr = &_params.vertices->lightState;
+		if (_updateAttribPointer(triangleAttrib::lightState, ptr))
+			glVertexAttribPointer(triangleAttrib::lightState, 1, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(SPVertex), ptr);
+	} else {
+		m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, false);
+		glVertexAttrib1f(triangleAttrib::lightState, 0.0f);
+	}
+
 	if (config.generalEmulation.enableHWLighting != 0)
 		glVertexAttrib1f(triangleAttrib::numlights, GLfloat(_params.vertices[0].HWLight));
 
+	if (_params.combiner->usesTexture()) {
+		// All vertices of a draw share the textures
+		const TexArrayAttribs & texArray = _params.texArray != nullptr ? *_params.texArray : TexArrayAttribs::none;
+		const s16 * tile0 = texArray.tile[0];
+		const s16 * tile1 = texArray.tile[1];
+		glVertexAttrib4f(triangleAttrib::texArray0, GLfloat(tile0[0]), GLfloat(tile0[1]), GLfloat(tile0[2]), GLfloat(tile0[3]));
+		glVertexAttrib4f(triangleAttrib::texArray1, GLfloat(tile1[0]), GLfloat(tile1[1]), GLfloat(tile1[2]), GLfloat(tile1[3]));
+	}
+
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::position, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord0, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, false);
 
 	if (_params.elements == nullptr) {
 		glDrawArrays(GLenum(_params.mode), 0, _params.verticesCount);
@@ -118,10 +144,25 @@ void UnbufferedDrawer::drawRects(const graphics::Context::DrawRectParameters & _
 	} else
 		m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, false);
 
+	if (_params.texrect) {
+		m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, true);
+		m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, true);
+		const void * ptr0 = _params.vertices->texArray.tile[0];
+		if (_updateAttribPointer(rectAttrib::texArray0, ptr0))
+			glVertexAttribPointer(rectAttrib::texArray0, 4, GL_SHORT, GL_FALSE, sizeof(RectVertex), ptr0);
+		const void * ptr1 = _params.vertices->texArray.tile[1];
+		if (_updateAttribPointer(rectAttrib::texArray1, ptr1))
+			glVertexAttribPointer(rectAttrib::texArray1, 4, GL_SHORT, GL_FALSE, sizeof(RectVertex), ptr1);
+	} else {
+		m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, false);
+		m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, false);
+	}
+
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::position, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::color, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texcoord, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::modify, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, false);
 
 	glDrawArrays(GLenum(_params.mode), 0, _params.verticesCount);
 }
@@ -144,10 +185,14 @@ void UnbufferedDrawer::drawLine(f32 _width, SPVertex * _vertices)
 
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::texcoord, false);
 	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::modify, false);
+	m_cachedAttribArray->enableVertexAttribArray(triangleAttrib::lightState, false);
+	glVertexAttrib1f(triangleAttrib::lightState, 0.0f);
 
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::position, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord0, false);
 	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texcoord1, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray0, false);
+	m_cachedAttribArray->enableVertexAttribArray(rectAttrib::texArray1, false);
 
 	glLineWidth(_width);
 	glDrawArrays(GL_LINES, 0, 2);
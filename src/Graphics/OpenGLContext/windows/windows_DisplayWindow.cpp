@@ -19,7 +19,7 @@ private:
 	bool _start() override;
 	void _stop() override;
 	void _swapBuffers() override;
-	void _saveScreenshot() override;
+	void _saveScreenshot(const wchar_t * _folder, const char * _name, u32 _width, u32 _height, const u8 * _data) override;
 	bool _resizeWindow() override;
 	void _changeWindow() override;
 	void _readScreen(void **_pDest, long *_pWidth, long *_pHeight) override;
@@ -156,18 +156,9 @@ void DisplayWindowWindows::_swapBuffers()
 		SwapBuffers( hDC );
 }
 
-void DisplayWindowWindows::_saveScreenshot()
+void DisplayWindowWindows::_saveScreenshot(const wchar_t * _folder, const char * _name, u32 _width, u32 _height, const u8 * _data)
 {
-	unsigned char * pixelData = NULL;
-	GLint oldMode;
-	glGetIntegerv(GL_READ_BUFFER, &oldMode);
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-	glReadBuffer(GL_FRONT);
-	pixelData = (unsigned char*)malloc(m_screenWidth * m_screenHeight * 3);
-	glReadPixels(0, m_heightOffset, m_screenWidth, m_screenHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelData);
-	glReadBuffer(oldMode);
-	SaveScreenshot(m_strScreenDirectory, RSP.romname, m_screenWidth, m_screenHeight, pixelData);
-	free( pixelData );
+	SaveScreenshot(_folder, _name, _width, _height, _data);
 }
 
 void DisplayWindowWindows::_changeWindow()
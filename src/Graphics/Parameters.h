@@ -21,6 +21,9 @@ namespace graphics {
 		extern InternalColorFormatParam DEPTH;
 		extern InternalColorFormatParam RG32F;
 		extern InternalColorFormatParam LUMINANCE;
+		extern InternalColorFormatParam COMPRESSED_RGB_S3TC_DXT1;
+		extern InternalColorFormatParam COMPRESSED_RGBA_S3TC_DXT5;
+		extern InternalColorFormatParam COMPRESSED_RGB8_ETC2;
 	}
 
 	namespace datatype {
@@ -35,6 +38,7 @@ namespace graphics {
 	namespace textureTarget {
 		extern TextureTargetParam TEXTURE_2D;
 		extern TextureTargetParam TEXTURE_2D_MULTISAMPLE;
+		extern TextureTargetParam TEXTURE_2D_ARRAY;
 		extern TextureTargetParam RENDERBUFFER;
 	}
 
@@ -67,6 +71,7 @@ namespace graphics {
 		extern TextureUnitParam ZLUTTex;
 		extern TextureUnitParam PaletteTex;
 		extern TextureUnitParam MSTex[2];
+		extern TextureUnitParam ArrayTex;
 	}
 
 	namespace textureImageUnits {
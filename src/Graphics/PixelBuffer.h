@@ -21,6 +21,10 @@ namespace graphics {
 		virtual void readPixels(s32 _x,s32 _y, u32 _width, u32 _height, Parameter _format, Parameter _type) = 0;
 		virtual void * getDataRange(u32 _offset, u32 _range) = 0;
 		virtual void closeReadBuffer() = 0;
+		// Marks the end of the read commands issued so far
+		virtual void fence() = 0;
+		// True once the GPU has finished the read. Does not block.
+		virtual bool isReady() = 0;
 		virtual void bind() = 0;
 		virtual void unbind() = 0;
 	};
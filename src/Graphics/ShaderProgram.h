@@ -32,4 +32,25 @@ namespace graphics {
 	public:
 		virtual void setTextColor(float * _color) = 0;
 	};
+
+	// Per-pixel post processing stages fused into a single pass
+	enum PostProcessingStage : u32 {
+		ppOrientationCorrection = 1,
+		ppGammaCorrection = 2,
+		ppBloom = 4,
+		ppCount = 8
+	};
+
+	enum class DualFilterPass {
+		ExtractBright,
+		Downsample,
+		Upsample
+	};
+
+	class DualFilterShaderProgram : public ShaderProgram
+	{
+	public:
+		// Size of the source texel in texture coordinates
+		virtual void setTexelSize(f32 _width, f32 _height) = 0;
+	};
 }
@@ -23,9 +23,12 @@
 #include "RSP.h"
 #include "RDP.h"
 #include "VI.h"
+#include "VertexBatchCache.h"
 
 using namespace graphics;
 
+const TexArrayAttribs TexArrayAttribs::none = { { { -1, 1, 1, 0 }, { -1, 1, 1, 0 } } };
+
 GraphicsDrawer::GraphicsDrawer()
 : m_modifyVertices(0)
 , m_bImageTexture(false)
@@ -54,6 +57,9 @@ void GraphicsDrawer::addTriangle(int _v0, int _v1, int _v2)
 		triangles.vertices[_v2].modify;
 
 	if ((gSP.geometryMode & G_LIGHTING) == 0) {
+		for (u32 i = firstIndex; i < triangles.num; ++i)
+			gSPResolveLightState(triangles.vertices[triangles.elements[i]]);
+
 		if ((gSP.geometryMode & G_SHADE) == 0) {
 			// Prim shading
 			for (u32 i = firstIndex; i < triangles.num; ++i) {
@@ -669,20 +675,22 @@ void GraphicsDrawer::drawTriangles()
 	Context::DrawTriangleParameters triParams;
 	triParams.mode = drawmode::TRIANGLES;
 	triParams.flatColors = m_bFlatColors;
+	triParams.shaderLighting = !m_bFlatColors;
 	triParams.elementsType = datatype::UNSIGNED_BYTE;
 	triParams.verticesCount = static_cast<u32>(triangles.maxElement) + 1;
 	triParams.elementsCount = triangles.num;
 	triParams.vertices = triangles.vertices.data();
 	triParams.elements = triangles.elements.data();
+	triParams.texArray = &textureCache().getTexArrayAttribs();
 	triParams.combiner = currentCombiner();
 	gfxContext.drawTriangles(triParams);
 	g_debugger.addTriangles(triParams);
 
 	if (config.frameBufferEmulation.enable != 0) {
-		const f32 maxY = renderTriangles(triangles.vertices.data(), triangles.elements.data(), triangles.num);
-		frameBufferList().setBufferChanged(maxY);
+		_setBufferChanged(triangles.vertices.data(), triangles.elements.data(), triangles.num, 3);
 		if (config.frameBufferEmulation.copyDepthToRDRAM == Config::cdSoftwareRender &&
 			gDP.otherMode.depthUpdate != 0) {
+			renderTriangles(triangles.vertices.data(), triangles.elements.data(), triangles.num);
 			FrameBuffer * pCurrentDepthBuffer = frameBufferList().findBuffer(gDP.depthImageAddress);
 			if (pCurrentDepthBuffer != nullptr)
 				pCurrentDepthBuffer->m_cleared = false;
@@ -698,11 +706,9 @@ void GraphicsDrawer::drawScreenSpaceTriangle(u32 _numVtx)
 	if (_numVtx == 0 || !_canDraw())
 		return;
 
-	f32 maxY = 0;
 	for (u32 i = 0; i < _numVtx; ++i) {
 		SPVertex & vtx = m_dmaVertices[i];
 		vtx.modify = MODIFY_ALL;
-		maxY = std::max(maxY, vtx.y);
 	}
 	m_modifyVertices = MODIFY_ALL;
 
@@ -715,11 +721,12 @@ void GraphicsDrawer::drawScreenSpaceTriangle(u32 _numVtx)
 	triParams.flatColors = m_bFlatColors;
 	triParams.verticesCount = _numVtx;
 	triParams.vertices = m_dmaVertices.data();
+	triParams.texArray = &textureCache().getTexArrayAttribs();
 	triParams.combiner = currentCombiner();
 	gfxContext.drawTriangles(triParams);
 	g_debugger.addTriangles(triParams);
 
-	frameBufferList().setBufferChanged(maxY);
+	_setBufferChanged(m_dmaVertices.data(), nullptr, _numVtx, 1);
 	gSP.changed |= CHANGED_GEOMETRYMODE;
 }
 
@@ -735,15 +742,16 @@ void GraphicsDrawer::drawDMATriangles(u32 _numVtx)
 	triParams.flatColors = m_bFlatColors;
 	triParams.verticesCount = _numVtx;
 	triParams.vertices = m_dmaVertices.data();
+	triParams.texArray = &textureCache().getTexArrayAttribs();
 	triParams.combiner = currentCombiner();
 	gfxContext.drawTriangles(triParams);
 	g_debugger.addTriangles(triParams);
 
 	if (config.frameBufferEmulation.enable != 0) {
-		const f32 maxY = renderTriangles(m_dmaVertices.data(), nullptr, _numVtx);
-		frameBufferList().setBufferChanged(maxY);
+		_setBufferChanged(m_dmaVertices.data(), nullptr, _numVtx, 3);
 		if (config.frameBufferEmulation.copyDepthToRDRAM == Config::cdSoftwareRender &&
 			gDP.otherMode.depthUpdate != 0) {
+			renderTriangles(m_dmaVertices.data(), nullptr, _numVtx);
 			FrameBuffer * pCurrentDepthBuffer = frameBufferList().findBuffer(gDP.depthImageAddress);
 			if (pCurrentDepthBuffer != nullptr)
 				pCurrentDepthBuffer->m_cleared = false;
@@ -835,6 +843,9 @@ void GraphicsDrawer::drawLine(int _v0, int _v1, float _width)
 	if (!_canDraw())
 		return;
 
+	gSPResolveLightState(triangles.vertices[_v0]);
+	gSPResolveLightState(triangles.vertices[_v1]);
+
 	f32 lineWidth = _width;
 	if (config.frameBufferEmulation.nativeResFactor == 0)
 		lineWidth *= dwnd().getScaleX();
@@ -857,6 +868,17 @@ void GraphicsDrawer::drawLine(int _v0, int _v1, float _width)
 
 	SPVertex vertexBuf[2] = { triangles.vertices[_v0], triangles.vertices[_v1] };
 	gfxContext.drawLine(lineWidth, vertexBuf);
+
+	if (config.frameBufferEmulation.enable != 0)
+		_setBufferChanged(vertexBuf, nullptr, 2, 2, _width);
+}
+
+void GraphicsDrawer::_setBufferChanged(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements,
+	u32 _primitiveSize, f32 _border) const
+{
+	f32 ulx, uly, lrx, lry;
+	if (calcScreenBounds(_pVertices, _pElements, _numElements, _primitiveSize, ulx, uly, lrx, lry))
+		frameBufferList().setBufferChanged(ulx - _border, uly - _border, lrx + _border, lry + _border);
 }
 
 void GraphicsDrawer::drawRect(int _ulx, int _uly, int _lrx, int _lry)
@@ -1161,27 +1183,23 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 			}
 
 			if (cache.current[t]->frameBufferTexture != CachedTexture::fbMultiSample) {
-				Context::TexParameters texParams;
+				TextureParam wrapS, wrapT;
 
 				if ((cache.current[t]->mirrorS == 0 && cache.current[t]->maskS == 0 &&
 					(texST[t].s0 < texST[t].s1 ?
 					texST[t].s0 >= 0.0 && texST[t].s1 <= (float)cache.current[t]->width :
 					texST[t].s1 >= 0.0 && texST[t].s0 <= (float)cache.current[t]->width))
 					|| (cache.current[t]->maskS == 0 && (texST[t].s0 < -1024.0f || texST[t].s1 > 1023.99f)))
-					texParams.wrapS = textureParameters::WRAP_CLAMP_TO_EDGE;
+					wrapS = textureParameters::WRAP_CLAMP_TO_EDGE;
 
 				if (cache.current[t]->mirrorT == 0 &&
 					(texST[t].t0 < texST[t].t1 ?
 					texST[t].t0 >= 0.0f && texST[t].t1 <= (float)cache.current[t]->height :
 					texST[t].t1 >= 0.0f && texST[t].t0 <= (float)cache.current[t]->height))
-					texParams.wrapT = textureParameters::WRAP_CLAMP_TO_EDGE;
+					wrapT = textureParameters::WRAP_CLAMP_TO_EDGE;
 
-				if (texParams.wrapS.isValid() || texParams.wrapT.isValid()) {
-					texParams.handle = cache.current[t]->name;
-					texParams.target = textureTarget::TEXTURE_2D;
-					texParams.textureUnitIndex = textureIndices::Tex[t];
-					gfxContext.setTextureParameters(texParams);
-				}
+				if (wrapS.isValid() || wrapT.isValid())
+					cache.setTextureParameters(t, wrapS, wrapT, TextureParam());
 			}
 
 			texST[t].s0 *= cache.current[t]->scaleS;
@@ -1191,15 +1209,11 @@ void GraphicsDrawer::drawTexturedRect(const TexturedRectParams & _params)
 		}
 	}
 
-	if (gDP.otherMode.cycleType == G_CYC_COPY && cache.current[0]->frameBufferTexture != CachedTexture::fbMultiSample) {
-		Context::TexParameters texParams;
-		texParams.handle = cache.current[0]->name;
-		texParams.target = textureTarget::TEXTURE_2D;
-		texParams.textureUnitIndex = textureIndices::Tex[0];
-		texParams.minFilter = textureParameters::FILTER_NEAREST;
-		texParams.magFilter = textureParameters::FILTER_NEAREST;
-		gfxContext.setTextureParameters(texParams);
-	}
+	if (gDP.otherMode.cycleType == G_CYC_COPY && cache.current[0]->frameBufferTexture != CachedTexture::fbMultiSample)
+		cache.setTextureParameters(0, TextureParam(), TextureParam(), textureParameters::FILTER_NEAREST);
+
+	for (u32 i = 0; i < 4; ++i)
+		m_rect[i].texArray = cache.getTexArrayAttribs();
 
 	m_rect[0].s0 = texST[0].s0;
 	m_rect[0].t0 = texST[0].t0;
@@ -1316,7 +1330,9 @@ void GraphicsDrawer::_drawOSD(const char *_pText, float _x, float & _y)
 
 void GraphicsDrawer::drawOSD()
 {
-	if ((config.onScreenDisplay.fps | config.onScreenDisplay.vis | config.onScreenDisplay.percent) == 0 &&
+	const u32 gpuTime = gfxContext.isSupported(SpecialFeatures::GPUTimers) ? config.onScreenDisplay.gpuTime : 0;
+	const u32 statistics = config.onScreenDisplay.statistics;
+	if ((config.onScreenDisplay.fps | config.onScreenDisplay.vis | config.onScreenDisplay.percent | gpuTime | statistics) == 0 &&
 		m_osdMessages.empty())
 		return;
 
@@ -1364,6 +1380,64 @@ void GraphicsDrawer::drawOSD()
 		_drawOSD(buf, x, y);
 	}
 
+	GPUTimings timings;
+	if (gpuTime && gfxContext.getGPUTimings(timings)) {
+		char gpuBuf[64];
+		sprintf(gpuBuf, "GPU %.1f ms", timings.frameTime);
+		_drawOSD(gpuBuf, x, y);
+		sprintf(gpuBuf, "D %.1f B %.1f P %.1f R %.1f",
+			timings.stageTime[u32(GPUTimerStage::Draw)],
+			timings.stageTime[u32(GPUTimerStage::Blit)],
+			timings.stageTime[u32(GPUTimerStage::PostProcessing)],
+			timings.stageTime[u32(GPUTimerStage::ReadBack)]);
+		_drawOSD(gpuBuf, x, y);
+	}
+
+	DrawBufferStats bufferStats;
+	if (statistics && gfxContext.getDrawBufferStats(bufferStats)) {
+		char bufferBuf[64];
+		sprintf(bufferBuf, "VB %.2f/%.1f MB W %u DC %u/%u",
+			bufferStats.frameBytes / 1048576.0f,
+			bufferStats.size / 1048576.0f,
+			bufferStats.stalls,
+			bufferStats.submits,
+			bufferStats.draws);
+		_drawOSD(bufferBuf, x, y);
+	}
+
+	if (statistics) {
+		const RSPStats & rspStats = RSP_GetStats();
+		char rspBuf[64];
+		sprintf(rspBuf, "DL %u cmds %.2f ms %.1f M/s",
+			rspStats.commands,
+			rspStats.time,
+			rspStats.time > 0.0f ? rspStats.commands / (rspStats.time * 1000.0f) : 0.0f);
+		_drawOSD(rspBuf, x, y);
+	}
+
+	if (statistics && config.generalEmulation.enableVertexCache != 0) {
+		const VertexBatchCache::Stats & cacheStats = VertexBatchCache::get().getStats();
+		char cacheBuf[64];
+		sprintf(cacheBuf, "VC %u/%u hits %uK vtx",
+			cacheStats.hits,
+			cacheStats.hits + cacheStats.misses,
+			cacheStats.vertices / 1024);
+		_drawOSD(cacheBuf, x, y);
+	}
+
+	if (statistics) {
+		const TextureCache::Stats & texStats = textureCache().getStats();
+		char texBuf[96];
+		sprintf(texBuf, "TX %s %u/%u hits %u promoted %u/%u reused",
+			config.texture.cachePolicy == Config::tcp2Q ? "2Q" : "LRU",
+			texStats.hits,
+			texStats.hits + texStats.misses,
+			texStats.promoted,
+			texStats.reused,
+			texStats.reused + texStats.created);
+		_drawOSD(texBuf, x, y);
+	}
+
 	for (const std::string & m : m_osdMessages) {
 		_drawOSD(m.c_str(), x, y);
 	}
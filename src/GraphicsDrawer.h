@@ -29,10 +29,23 @@ enum class DrawingState
 	TexRect = 4,
 };
 
+// Texture array layer, width, height and sampler mode of tiles 0 and 1.
+// Passed with every vertex, so draws with different array textures are batched together.
+// Layer -1: the tile has its own texture object. Mode: wrapS | wrapT << 2 | filter << 4,
+// wrap 0 repeat, 1 mirrored repeat, 2 clamp to edge; filter 0 nearest, 1 linear.
+struct TexArrayAttribs
+{
+	s16 tile[2][4];
+
+	// Both tiles with own texture objects
+	static const TexArrayAttribs none;
+};
+
 struct RectVertex
 {
 	float x, y, z, w;
 	float s0, t0, s1, t1;
+	TexArrayAttribs texArray;
 };
 
 typedef std::chrono::milliseconds Milliseconds;
@@ -174,6 +187,8 @@ private:
 	void _prepareDrawTriangle();
 	bool _canDraw() const;
 	void _drawThickLine(int _v0, int _v1, float _width);
+	void _setBufferChanged(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements,
+		u32 _primitiveSize, f32 _border = 0.0f) const;
 
 	void _drawOSD(const char *_pText, float _x, float & _y);
 
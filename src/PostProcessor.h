@@ -1,14 +1,14 @@
 #ifndef POST_PROCESSOR_H
 #define POST_PROCESSOR_H
 
+#include <array>
 #include <memory>
+#include <vector>
 #include "Types.h"
 #include "Textures.h"
 #include "Graphics/ObjectHandle.h"
-
-namespace graphics {
-	class ShaderProgram;
-}
+#include "Graphics/Parameter.h"
+#include "Graphics/ShaderProgram.h"
 
 struct FrameBuffer;
 
@@ -17,9 +17,7 @@ public:
 	void init();
 	void destroy();
 
-	FrameBuffer * doBlur(FrameBuffer * _pBuffer);
-	FrameBuffer * doGammaCorrection(FrameBuffer * _pBuffer);
-	FrameBuffer * doOrientationCorrection(FrameBuffer * _pBuffer);
+	FrameBuffer * doPostProcessing(FrameBuffer * _pBuffer);
 
 	static PostProcessor & get();
 
@@ -28,26 +26,29 @@ private:
 	PostProcessor(const PostProcessor & _other);
 
 	void _createResultBuffer(const FrameBuffer * _pMainBuffer);
-	void _initGammaCorrection();
-	void _destroyGammaCorrection();
-	void _initOrientationCorrection();
-	void _destroyOrientationCorrection();
-	void _initBlur();
-	void _destroyBlur();
+	void _createBloomLevels();
+	void _destroyBloomLevels();
 	void _preDraw(FrameBuffer * _pBuffer);
 	void _postDraw();
+	void _drawPass(CachedTexture * _pSrc, CachedTexture * _pSrc1, graphics::ObjectHandle _dstFBO, const CachedTexture * _pDst,
+		graphics::TextureParam _filter, graphics::ShaderProgram * _program);
+	void _doBloom();
+	graphics::ShaderProgram * _getPostProcessingProgram(u32 _stages);
 
-	std::unique_ptr<graphics::ShaderProgram> m_gammaCorrectionProgram;
-	std::unique_ptr<graphics::ShaderProgram> m_orientationCorrectionProgram;
+	struct BloomLevel {
+		CachedTexture * pTexture;
+		graphics::ObjectHandle fbo;
+	};
 
-	std::unique_ptr<FrameBuffer> m_pResultBuffer;
+	std::array<std::unique_ptr<graphics::ShaderProgram>, graphics::ppCount> m_postProcessingPrograms;
+	std::unique_ptr<graphics::DualFilterShaderProgram> m_bloomExtractProgram;
+	std::unique_ptr<graphics::DualFilterShaderProgram> m_bloomDownsampleProgram;
+	std::unique_ptr<graphics::DualFilterShaderProgram> m_bloomUpsampleProgram;
 
-	graphics::ObjectHandle m_FBO_glowMap;
-	graphics::ObjectHandle m_FBO_blur;
+	std::unique_ptr<FrameBuffer> m_pResultBuffer;
+	std::vector<BloomLevel> m_bloomLevels;
 
 	CachedTexture * m_pTextureOriginal;
-	CachedTexture * m_pTextureGlowMap;
-	CachedTexture * m_pTextureBlur;
 
 #ifdef OS_ANDROID
 	static PostProcessor processor;
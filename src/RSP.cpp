@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include "DebugDump.h"
 #include "RSP.h"
@@ -16,12 +17,17 @@
 #include "PluginAPI.h"
 #include "Config.h"
 #include "TextureFilterHandler.h"
+#include "VertexBatchCache.h"
 #include "DisplayWindow.h"
+#include "Graphics/Context.h"
 
 using namespace std;
 
 RSPInfo		RSP;
 
+static RSPStats frameStats = {};
+static RSPStats lastFrameStats = {};
+
 void RSP_CheckDLCounter()
 {
 	if (RSP.count != -1) {
@@ -77,6 +83,9 @@ void RSP_ProcessDList()
 
 	depthBufferList().setNotCleared();
 
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	u32 commands = 0;
+
 	switch (GBI.getMicrocodeType()) {
 	case Turbo3D:
 		RunTurbo3D();
@@ -107,9 +116,15 @@ void RSP_ProcessDList()
 
 			GBI.cmd[RSP.cmd](RSP.w0, RSP.w1);
 			RSP_CheckDLCounter();
+			++commands;
 		}
 	}
 
+	gfxContext.flushDraws();
+
+	frameStats.commands += commands;
+	frameStats.time += std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
 	if (config.frameBufferEmulation.copyDepthToRDRAM != Config::cdDisable) {
 		if ((config.generalEmulation.hacks & hack_rectDepthBufferCopyCBFD) != 0) {
 			; // do nothing
@@ -124,10 +139,23 @@ void RSP_ProcessDList()
 	gDP.changed |= CHANGED_COLORBUFFER;
 }
 
+void RSP_FrameEnd()
+{
+	lastFrameStats = frameStats;
+	frameStats = RSPStats();
+}
+
+const RSPStats & RSP_GetStats()
+{
+	return lastFrameStats;
+}
+
 static
 void RSP_SetDefaultState()
 {
+	const u32 lightStatesVersion = gSP.lightStates.version;
 	memset(&gSP, 0, sizeof(gSPInfo));
+	gSP.lightStates.version = lightStatesVersion + 1;
 
 	gSPTexture(1.0f, 1.0f, 0, 0, TRUE);
 	gDP.loadTile = &gDP.tiles[7];
@@ -209,6 +237,7 @@ void RSP_Init()
 
 	if (strcmp(RSP.romname, romname) != 0)
 		TFH.shutdown();
+	VertexBatchCache::get().clear();
 
 	strncpy(RSP.romname, romname, 21);
 	setDepthClearColor();
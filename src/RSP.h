@@ -16,6 +16,12 @@ typedef struct
 
 extern RSPInfo RSP;
 
+struct RSPStats
+{
+	u32 commands;
+	f32 time; // ms spent processing display lists
+};
+
 extern u32 DepthClearColor;
 extern u32 rectDepthBufferCopyFrame;
 
@@ -25,5 +31,8 @@ void RSP_Init();
 void RSP_ProcessDList();
 void RSP_LoadMatrix( f32 mtx[4][4], u32 address );
 void RSP_CheckDLCounter();
+void RSP_FrameEnd();
+// Counters of the last finished frame
+const RSPStats & RSP_GetStats();
 
 #endif
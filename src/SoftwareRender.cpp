@@ -3,6 +3,7 @@
 #include "DepthBufferRender/ClipPolygon.h"
 #include "DepthBufferRender/DepthBufferRender.h"
 #include "gSP.h"
+#include "gDP.h"
 #include "SoftwareRender.h"
 #include "DepthBuffer.h"
 #include "Config.h"
@@ -164,13 +165,12 @@ int clipW(const SPVertex ** _vsrc, SPVertex * _vdst)
 	return dsti;
 }
 
-f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements)
+void renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements)
 {
 	vertexclip vclip[16];
 	vertexi vdraw[12];
 	const SPVertex * vsrc[4];
 	SPVertex vdata[6];
-	f32 maxY = 0.0f;
 	for (u32 i = 0; i < _numElements; i += 3) {
 		u32 orbits = 0;
 		if (_pElements != nullptr) {
@@ -197,7 +197,6 @@ f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _num
 			assert(numVertex == 3);
 			if ((gSP.geometryMode & G_CULL_BACK) != 0) {
 				for (int k = 0; k < 3; ++k) {
-					maxY = std::max(maxY, vclip[k].y);
 					vdraw[k].x = floatToFixed16(vclip[k].x);
 					vdraw[k].y = floatToFixed16(vclip[k].y);
 					vdraw[k].z = floatToFixed16(vclip[k].z);
@@ -205,7 +204,6 @@ f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _num
 			} else {
 				for (int k = 0; k < 3; ++k) {
 					const u32 idx = 3 - k - 1;
-					maxY = std::max(maxY, vclip[idx].y);
 					vdraw[k].x = floatToFixed16(vclip[idx].x);
 					vdraw[k].y = floatToFixed16(vclip[idx].y);
 					vdraw[k].z = floatToFixed16(vclip[idx].z);
@@ -219,7 +217,6 @@ f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _num
 
 			if ((gSP.geometryMode & G_CULL_BACK) != 0) {
 				for (int k = 0; k < numVertex; ++k) {
-					maxY = std::max(maxY, vtx[k]->y);
 					vdraw[k].x = floatToFixed16(vtx[k]->x);
 					vdraw[k].y = floatToFixed16(vtx[k]->y);
 					vdraw[k].z = floatToFixed16(vtx[k]->z);
@@ -227,7 +224,6 @@ f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _num
 			} else {
 				for (int k = 0; k < numVertex; ++k) {
 					const u32 idx = numVertex - k - 1;
-					maxY = std::max(maxY, vtx[idx]->y);
 					vdraw[k].x = floatToFixed16(vtx[idx]->x);
 					vdraw[k].y = floatToFixed16(vtx[idx]->y);
 					vdraw[k].z = floatToFixed16(vtx[idx]->z);
@@ -241,5 +237,96 @@ f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _num
 			gDP.otherMode.depthUpdate != 0)
 			Rasterize(vdraw, numVertex, dzdx);
 	}
-	return maxY;
+}
+
+static
+void projectVertex(const SPVertex & _v, f32 & _x, f32 & _y)
+{
+	if ((_v.modify & MODIFY_XY) != 0) {
+		_x = _v.x;
+		_y = _v.y;
+	} else {
+		_x = gSP.viewport.vtrans[0] + (_v.x / _v.w) * gSP.viewport.vscale[0];
+		_y = gSP.viewport.vtrans[1] + (_v.y / _v.w) * -gSP.viewport.vscale[1];
+	}
+}
+
+inline
+bool isInFrontOfEye(const SPVertex & _v)
+{
+	return (_v.modify & MODIFY_XY) != 0 || _v.w >= 0.01f;
+}
+
+struct ScreenBounds
+{
+	f32 ulx, uly, lrx, lry;
+	bool empty = true;
+
+	void add(f32 _x, f32 _y)
+	{
+		if (empty) {
+			ulx = lrx = _x;
+			uly = lry = _y;
+			empty = false;
+		} else {
+			ulx = std::min(ulx, _x);
+			uly = std::min(uly, _y);
+			lrx = std::max(lrx, _x);
+			lry = std::max(lry, _y);
+		}
+	}
+};
+
+// Adds the part of the primitive which lies in front of the eye.
+// Edges crossing the w = 0.01 plane are cut there, as clipW does.
+static
+void addPrimitiveBounds(const SPVertex ** _vsrc, u32 _numVertices, ScreenBounds & _bounds)
+{
+	f32 x, y;
+	for (u32 i = 0; i < _numVertices; ++i) {
+		const SPVertex & v1 = *_vsrc[i];
+		const SPVertex & v2 = *_vsrc[(i + 1) % _numVertices];
+		const bool inside1 = isInFrontOfEye(v1);
+		if (inside1) {
+			projectVertex(v1, x, y);
+			_bounds.add(x, y);
+		}
+		if (_numVertices == 1 || inside1 == isInFrontOfEye(v2))
+			continue;
+
+		if (((v1.modify | v2.modify) & MODIFY_XY) != 0) {
+			// Screen space and clip space vertices can't be interpolated.
+			_bounds.add(gDP.scissor.ulx, gDP.scissor.uly);
+			_bounds.add(gDP.scissor.lrx, gDP.scissor.lry);
+			continue;
+		}
+
+		SPVertex cut;
+		const f32 a = (0.01f - v1.w) / (v2.w - v1.w);
+		cut.x = v1.x + (v2.x - v1.x) * a;
+		cut.y = v1.y + (v2.y - v1.y) * a;
+		cut.w = 0.01f;
+		cut.modify = 0;
+		projectVertex(cut, x, y);
+		_bounds.add(x, y);
+	}
+}
+
+bool calcScreenBounds(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements, u32 _primitiveSize,
+	f32 & _ulx, f32 & _uly, f32 & _lrx, f32 & _lry)
+{
+	ScreenBounds bounds;
+	const SPVertex * vsrc[3];
+	for (u32 i = 0; i + _primitiveSize <= _numElements; i += _primitiveSize) {
+		for (u32 j = 0; j < _primitiveSize; ++j)
+			vsrc[j] = &_pVertices[_pElements != nullptr ? _pElements[i + j] : i + j];
+		addPrimitiveBounds(vsrc, _primitiveSize, bounds);
+	}
+	if (bounds.empty)
+		return false;
+	_ulx = bounds.ulx;
+	_uly = bounds.uly;
+	_lrx = bounds.lrx;
+	_lry = bounds.lry;
+	return true;
 }
@@ -3,6 +3,11 @@
 
 #include "gSP.h"
 
-f32 renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements);
+void renderTriangles(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements);
+
+// Conservative screen space bounds of the primitives made of _primitiveSize (1 to 3) vertices each.
+// _pElements may be nullptr for sequential vertices. Parts behind the eye are clipped away.
+bool calcScreenBounds(const SPVertex * _pVertices, const u8 * _pElements, u32 _numElements, u32 _primitiveSize,
+	f32 & _ulx, f32 & _uly, f32 & _lrx, f32 & _lry);
 
 #endif // SOFTWARE_RENDER_H
@@ -9,6 +9,7 @@
 #include "FrameBuffer.h"
 #include "TextureFilterHandler.h"
 #include "DisplayWindow.h"
+#include "CRC.h"
 #include "wst.h"
 
 static
@@ -83,10 +84,18 @@ u32 TextureFilterHandler::_getConfigOptions() const
 	u32 options = textureFilters[config.textureFilter.txFilterMode] | textureEnhancements[config.textureFilter.txEnhancementMode];
 	if (config.textureFilter.txHiresEnable)
 		options |= RICE_HIRESTEXTURES;
+	if (config.textureFilter.txHiresStream)
+		options |= STREAM_HIRESTEX;
 	if (config.textureFilter.txForce16bpp)
 		options |= FORCE16BPP_TEX | FORCE16BPP_HIRESTEX;
 	if (config.textureFilter.txCacheCompression)
 		options |= GZ_TEXCACHE | GZ_HIRESTEXCACHE;
+	if (config.textureFilter.txBlockCompression) {
+		if (gfxContext.isSupported(graphics::SpecialFeatures::TextureCompressionS3TC))
+			options |= COMPRESS_TEX | COMPRESS_HIRESTEX;
+		else if (gfxContext.isSupported(graphics::SpecialFeatures::TextureCompressionETC2))
+			options |= COMPRESS_TEX | COMPRESS_HIRESTEX | ETC2_COMPRESSION;
+	}
 	if (config.textureFilter.txSaveCache)
 		options |= (DUMP_TEXCACHE | DUMP_HIRESTEXCACHE);
 	if (config.textureFilter.txHiresFullAlphaChannel)
@@ -127,6 +136,8 @@ void TextureFilterHandler::init()
 		32, // max texture bpp supported by hardware
 		m_options,
 		config.textureFilter.txCacheSize, // cache texture to system memory
+		config.textureFilter.txHiresCacheSize, // memory budget of streamed hires textures
+		CRC_HashId(), // hash of the texture checksums, recorded in the texture cache file
 		txCachePath, // path to store cache files
 		pTexPackPath, // path to texture packs folder
 		wRomName, // name of ROM. must be no longer than 256 characters
@@ -482,10 +482,15 @@ void TextureCache::_initDummyTexture(CachedTexture * _pDummy)
 	_pDummy->tMem = 0;
 }
 
+// Largest texture mip level decoded into the upload buffer
+static const u32 uploadBufferBlockSize = 512 * 1024;
+
 void TextureCache::init()
 {
 	m_maxBytes = config.texture.maxBytes;
 	m_curUnpackAlignment = 0;
+	if (gfxContext.isSupported(SpecialFeatures::PersistentPixelBuffers))
+		m_uploadBuffer.reset(gfxContext.createPixelWriteBuffer(uploadBufferBlockSize));
 
 	u32 dummyTexture[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
@@ -505,6 +510,7 @@ void TextureCache::init()
 	gfxContext.init2DTexture(params);
 
 	m_cachedBytes = m_pDummy->textureBytes;
+	m_texArray = TexArrayAttribs::none;
 	activateDummy( 0 );
 	activateDummy(1);
 	current[0] = current[1] = nullptr;
@@ -530,48 +536,183 @@ void TextureCache::init()
 		activateMSDummy(1);
 	}
 
+	_initTextureArray();
+
 	assert(!gfxContext.isError());
 }
 
+void TextureCache::_initTextureArray()
+{
+	m_freeArrayLayers.clear();
+	if (config.texture.enableTextureArray == 0 || !gfxContext.isSupported(SpecialFeatures::TextureArrays))
+		return;
+
+	m_textureArray = gfxContext.createTexture(textureTarget::TEXTURE_2D_ARRAY);
+	Context::InitTextureParams params;
+	params.handle = m_textureArray;
+	params.textureUnitIndex = textureIndices::ArrayTex;
+	params.width = arrayLayerSize;
+	params.height = arrayLayerSize;
+	params.layers = arrayLayers;
+	params.format = colorFormat::RGBA;
+	params.internalFormat = internalcolorFormat::RGBA8;
+	params.dataType = datatype::UNSIGNED_BYTE;
+	gfxContext.initTextureArray(params);
+
+	for (u32 i = arrayLayers; i > 0; --i)
+		m_freeArrayLayers.push_back(s16(i - 1));
+}
+
+bool TextureCache::_useTextureArray(const CachedTexture * _pTexture) const
+{
+	// The shader reads the array without mipmaps, so LOD combiners keep regular textures.
+	return !m_freeArrayLayers.empty() &&
+		_pTexture->realWidth <= arrayLayerSize &&
+		_pTexture->realHeight <= arrayLayerSize &&
+		_pTexture->max_level == 0 &&
+		!currentCombiner()->usesLOD() &&
+		(config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) == 0 &&
+		((config.generalEmulation.hacks&hack_LoadDepthTextures) == 0 || gDP.colorImage.address != gDP.depthImageAddress);
+}
+
+void TextureCache::_releaseArrayLayer(const CachedTexture & _texture)
+{
+	if (_texture.arrayLayer >= 0)
+		m_freeArrayLayers.push_back(_texture.arrayLayer);
+}
+
 void TextureCache::destroy()
 {
 	current[0] = current[1] = nullptr;
 
 	for (Textures::const_iterator cur = m_textures.cbegin(); cur != m_textures.cend(); ++cur)
 		gfxContext.deleteTexture(cur->name);
+	for (Textures::const_iterator cur = m_probationTextures.cbegin(); cur != m_probationTextures.cend(); ++cur)
+		gfxContext.deleteTexture(cur->name);
 	m_textures.clear();
+	m_probationTextures.clear();
 	m_lruTextureLocations.clear();
+	m_ghosts.clear();
+	m_ghostLocations.clear();
+	_trimTexturePool(0);
 
 	for (FBTextures::const_iterator cur = m_fbTextures.cbegin(); cur != m_fbTextures.cend(); ++cur)
 		gfxContext.deleteTexture(cur->second.name);
 	m_fbTextures.clear();
+	m_uploadBuffer.reset();
+
+	if (m_textureArray.isNotNull())
+		gfxContext.deleteTexture(m_textureArray);
+	m_textureArray.reset();
+	m_freeArrayLayers.clear();
 
 	m_cachedBytes = 0;
+	m_probationBytes = 0;
+	m_ghostBytes = 0;
+}
+
+u32 * TextureCache::_stageTexels(u32 _bytes)
+{
+	if (!m_uploadBuffer || _bytes > uploadBufferBlockSize)
+		return nullptr;
+
+	m_uploadBuffer->bind();
+	u32 * pTexels = (u32*)m_uploadBuffer->getWriteBuffer(_bytes);
+	if (pTexels == nullptr)
+		m_uploadBuffer->unbind();
+	return pTexels;
+}
+
+// Allocates the texture level and fills it with texels written to _pBuffer.
+// The pixel unpack buffer must be unbound while the storage is allocated without data.
+static
+void uploadStagedTexels(PixelWriteBuffer * _pBuffer, Context::InitTextureParams & _params)
+{
+	_pBuffer->closeWriteBuffer();
+	_pBuffer->unbind();
+	_params.data = nullptr;
+	gfxContext.init2DTexture(_params);
+
+	Context::UpdateTextureDataParams updateParams;
+	updateParams.handle = _params.handle;
+	updateParams.textureUnitIndex = _params.textureUnitIndex;
+	updateParams.mipMapLevel = _params.mipMapLevel;
+	updateParams.width = _params.width;
+	updateParams.height = _params.height;
+	updateParams.format = _params.format;
+	updateParams.dataType = _params.dataType;
+	PixelBufferBinder<PixelWriteBuffer> binder(_pBuffer);
+	updateParams.data = _pBuffer->getData();
+	gfxContext.update2DTexture(updateParams);
 }
 
 void TextureCache::_checkCacheSize()
 {
 	const size_t maxCacheSize = 8000;
-	if (m_textures.size() >= maxCacheSize) {
-		CachedTexture& clsTex = m_textures.back();
-		m_cachedBytes -= clsTex.textureBytes;
-		gfxContext.deleteTexture(clsTex.name);
-		m_lruTextureLocations.erase(clsTex.crc);
-		m_textures.pop_back();
+	if (m_textures.size() + m_probationTextures.size() >= maxCacheSize)
+		_evictTexture();
+
+	while (m_cachedBytes > m_maxBytes && !(m_textures.empty() && m_probationTextures.empty()))
+		_evictTexture();
+}
+
+void TextureCache::_evictTexture()
+{
+	// Textures used only once go first while they take more than a quarter of the budget.
+	// With the LRU policy the probation queue is always empty.
+	const bool evictProbation = !m_probationTextures.empty() &&
+		(m_textures.empty() || m_probationBytes > m_maxBytes / 4);
+	Textures & textures = evictProbation ? m_probationTextures : m_textures;
+	Textures::iterator iter = std::prev(textures.end());
+	if (evictProbation)
+		_addGhost(*iter);
+	_removeTexture(iter);
+}
+
+void TextureCache::_addGhost(const CachedTexture & _texture)
+{
+	Ghost_Locations::iterator locations_iter = m_ghostLocations.find(_texture.crc);
+	if (locations_iter != m_ghostLocations.end()) {
+		m_ghostBytes -= locations_iter->second->textureBytes;
+		m_ghosts.erase(locations_iter->second);
+		m_ghostLocations.erase(locations_iter);
 	}
 
-	if (m_cachedBytes <= m_maxBytes)
-		return;
+	// Remember evicted textures worth half of the cache budget.
+	const u32 maxGhostBytes = m_maxBytes / 2;
+	while (!m_ghosts.empty() && m_ghostBytes + _texture.textureBytes > maxGhostBytes) {
+		m_ghostBytes -= m_ghosts.back().textureBytes;
+		m_ghostLocations.erase(m_ghosts.back().crc);
+		m_ghosts.pop_back();
+	}
 
-	Textures::iterator iter = m_textures.end();
-	do {
-		--iter;
-		CachedTexture& tex = *iter;
-		m_cachedBytes -= tex.textureBytes;
-		gfxContext.deleteTexture(tex.name);
-		m_lruTextureLocations.erase(tex.crc);
-	} while (m_cachedBytes > m_maxBytes && iter != m_textures.cbegin());
-	m_textures.erase(iter, m_textures.end());
+	m_ghosts.push_front({ _texture.crc, _texture.textureBytes });
+	m_ghostLocations[_texture.crc] = m_ghosts.begin();
+	m_ghostBytes += _texture.textureBytes;
+}
+
+void TextureCache::_useTexture(Textures::iterator _iter)
+{
+	if (_iter->bProbation) {
+		_iter->bProbation = false;
+		m_probationBytes -= _iter->textureBytes;
+		++m_frameStats.promoted;
+		m_textures.splice(m_textures.begin(), m_probationTextures, _iter);
+	} else
+		m_textures.splice(m_textures.begin(), m_textures, _iter);
+}
+
+void TextureCache::_removeTexture(Textures::iterator _iter)
+{
+	m_cachedBytes -= _iter->textureBytes;
+	if (_iter->bProbation)
+		m_probationBytes -= _iter->textureBytes;
+	_releaseTexture(*_iter);
+	m_lruTextureLocations.erase(_iter->crc);
+	if (_iter->bProbation)
+		m_probationTextures.erase(_iter);
+	else
+		m_textures.erase(_iter);
 }
 
 CachedTexture * TextureCache::_addTexture(u32 _crc32)
@@ -579,13 +720,88 @@ CachedTexture * TextureCache::_addTexture(u32 _crc32)
 	if (m_curUnpackAlignment == 0)
 		m_curUnpackAlignment = gfxContext.getTextureUnpackAlignment();
 	_checkCacheSize();
-	m_textures.emplace_front(gfxContext.createTexture(textureTarget::TEXTURE_2D));
-	Textures::iterator new_iter = m_textures.begin();
+	// New textures wait in the probation queue for a second use, unless they were evicted from it recently.
+	bool probation = config.texture.cachePolicy == Config::tcp2Q;
+	Ghost_Locations::iterator ghost_iter = m_ghostLocations.find(_crc32);
+	if (ghost_iter != m_ghostLocations.end()) {
+		probation = false;
+		m_ghostBytes -= ghost_iter->second->textureBytes;
+		m_ghosts.erase(ghost_iter->second);
+		m_ghostLocations.erase(ghost_iter);
+	}
+
+	Textures & textures = probation ? m_probationTextures : m_textures;
+	// The texture object is assigned at the first upload, when the size and format of its storage are known.
+	textures.emplace_front(ObjectHandle::null);
+	Textures::iterator new_iter = textures.begin();
 	new_iter->crc = _crc32;
+	new_iter->bProbation = probation;
 	m_lruTextureLocations.insert(std::pair<u32, Textures::iterator>(_crc32, new_iter));
 	return &(*new_iter);
 }
 
+ObjectHandle TextureCache::_textureObject(CachedTexture * _pTexture, u32 _width, u32 _height, Parameter _internalFormat, u32 _mipMapLevels)
+{
+	const u64 storageKey = u64(_width) | (u64(_height) << 16) | (u64(_mipMapLevels) << 32) | (u64(u32(_internalFormat)) << 40);
+	if (_pTexture->name.isNotNull()) {
+		if (_pTexture->storageKey == storageKey)
+			return _pTexture->name;
+		_releaseTexture(*_pTexture);
+	}
+
+	_pTexture->storageKey = storageKey;
+	TexturePool_Locations::iterator locations_iter = m_texturePoolLocations.find(storageKey);
+	if (locations_iter == m_texturePoolLocations.end()) {
+		++m_frameStats.created;
+		_pTexture->name = gfxContext.createTexture(textureTarget::TEXTURE_2D);
+		return _pTexture->name;
+	}
+
+	++m_frameStats.reused;
+	TexturePool::iterator iter = locations_iter->second;
+	_pTexture->name = iter->name;
+	m_pooledBytes -= iter->textureBytes;
+	m_texturePoolLocations.erase(locations_iter);
+	m_texturePool.erase(iter);
+	return _pTexture->name;
+}
+
+void TextureCache::_releaseTexture(const CachedTexture & _texture)
+{
+	_releaseArrayLayer(_texture);
+	if (!_texture.name.isNotNull())
+		return;
+
+	// Keep at most an eighth of the cache budget in released textures.
+	const u32 maxPooledBytes = m_maxBytes / 8;
+	if (_texture.textureBytes > maxPooledBytes) {
+		gfxContext.deleteTexture(_texture.name);
+		return;
+	}
+
+	_trimTexturePool(maxPooledBytes - _texture.textureBytes);
+	m_texturePool.push_front({ _texture.storageKey, _texture.name, _texture.textureBytes });
+	m_texturePoolLocations.insert(std::pair<u64, TexturePool::iterator>(_texture.storageKey, m_texturePool.begin()));
+	m_pooledBytes += _texture.textureBytes;
+}
+
+void TextureCache::_trimTexturePool(u32 _maxBytes)
+{
+	while (m_pooledBytes > _maxBytes && !m_texturePool.empty()) {
+		PooledTexture & oldest = m_texturePool.back();
+		auto range = m_texturePoolLocations.equal_range(oldest.storageKey);
+		for (TexturePool_Locations::iterator iter = range.first; iter != range.second; ++iter) {
+			if (iter->second == std::prev(m_texturePool.end())) {
+				m_texturePoolLocations.erase(iter);
+				break;
+			}
+		}
+		gfxContext.deleteTexture(oldest.name);
+		m_pooledBytes -= oldest.textureBytes;
+		m_texturePool.pop_back();
+	}
+}
+
 void TextureCache::removeFrameBufferTexture(CachedTexture * _pTexture)
 {
 	if (_pTexture == nullptr)
@@ -721,7 +937,14 @@ void _updateCachedTexture(const GHQTexInfo & _info, CachedTexture *_pTexture, in
 	_pTexture->textureBytes = _info.width * _info.height;
 
 	Parameter format(_info.format);
-	if (format == internalcolorFormat::RGB8 ||
+	if (format == internalcolorFormat::COMPRESSED_RGB_S3TC_DXT1 ||
+		format == internalcolorFormat::COMPRESSED_RGB8_ETC2) {
+		_pTexture->textureBytes = ((_info.width + 3) >> 2) * ((_info.height + 3) >> 2) * 8;
+	}
+	else if (format == internalcolorFormat::COMPRESSED_RGBA_S3TC_DXT5) {
+		_pTexture->textureBytes = ((_info.width + 3) >> 2) * ((_info.height + 3) >> 2) * 16;
+	}
+	else if (format == internalcolorFormat::RGB8 ||
 		format == internalcolorFormat::RGBA4 ||
 		format == internalcolorFormat::RGB5_A1) {
 		_pTexture->textureBytes <<= 1;
@@ -737,6 +960,17 @@ void _updateCachedTexture(const GHQTexInfo & _info, CachedTexture *_pTexture, in
 	_pTexture->bHDTexture = true;
 }
 
+void TextureCache::_markHiresPending(CachedTexture *_pTexture, u64 _ricecrc)
+{
+	if (config.textureFilter.txHiresStream != 0 && txfilter_hirestexpending(_ricecrc))
+		_pTexture->hiresPendingCrc = _ricecrc;
+}
+
+bool TextureCache::_hiresStreamed(const CachedTexture & _texture)
+{
+	return _texture.hiresPendingCrc != 0 && !txfilter_hirestexpending(_texture.hiresPendingCrc);
+}
+
 bool TextureCache::_loadHiresBackground(CachedTexture *_pTexture)
 {
 	if (!TFH.isInited())
@@ -769,7 +1003,6 @@ bool TextureCache::_loadHiresBackground(CachedTexture *_pTexture)
 			ghqTexInfo.width != 0 && ghqTexInfo.height != 0) {
 		ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
 		Context::InitTextureParams params;
-		params.handle = _pTexture->name;
 		params.mipMapLevel = 0;
 		params.msaaLevel = 0;
 		params.width = ghqTexInfo.width;
@@ -778,12 +1011,14 @@ bool TextureCache::_loadHiresBackground(CachedTexture *_pTexture)
 		params.internalFormat = InternalColorFormatParam(ghqTexInfo.format);
 		params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
 		params.data = ghqTexInfo.data;
+		params.handle = _textureObject(_pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
 		gfxContext.init2DTexture(params);
 
 		assert(!gfxContext.isError());
 		_updateCachedTexture(ghqTexInfo, _pTexture, ghqTexInfo.width / tile_width);
 		return true;
 	}
+	_markHiresPending(_pTexture, ricecrc);
 	return false;
 }
 
@@ -822,8 +1057,15 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 	pSwapped = (u8*)malloc(numBytes);
 	assert(pSwapped != nullptr);
 	UnswapCopyWrap(RDRAM, gSP.bgImage.address, pSwapped, 0, RDRAMSize, numBytes);
-	pDest = (u32*)malloc(pTexture->textureBytes);
-	assert(pDest != nullptr);
+	const bool bReadTexels =
+		((config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 && gDP.colorImage.address == gDP.depthImageAddress) ||
+		((config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0 && config.textureFilter.txFilterIgnoreBG == 0);
+	pDest = bReadTexels ? nullptr : _stageTexels(pTexture->textureBytes);
+	const bool bStaged = pDest != nullptr;
+	if (!bStaged) {
+		pDest = (u32*)malloc(pTexture->textureBytes);
+		assert(pDest != nullptr);
+	}
 
 	clampSClamp = pTexture->width - 1;
 	clampTClamp = pTexture->height - 1;
@@ -867,7 +1109,6 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 
 			ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
 			Context::InitTextureParams params;
-			params.handle = pTexture->name;
 			params.mipMapLevel = 0;
 			params.msaaLevel = 0;
 			params.width = ghqTexInfo.width;
@@ -876,6 +1117,7 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 			params.internalFormat = InternalColorFormatParam(ghqTexInfo.format);
 			params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
 			params.data = ghqTexInfo.data;
+			params.handle = _textureObject(pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
 			gfxContext.init2DTexture(params);
 			_updateCachedTexture(ghqTexInfo, pTexture, ghqTexInfo.width / pTexture->realWidth);
 			bLoaded = true;
@@ -885,7 +1127,6 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 		if (pTexture->realWidth % 2 != 0 && glInternalFormat != internalcolorFormat::RGBA8)
 			gfxContext.setTextureUnpackAlignment(2);
 		Context::InitTextureParams params;
-		params.handle = pTexture->name;
 		params.mipMapLevel = 0;
 		params.msaaLevel = 0;
 		params.width = pTexture->realWidth;
@@ -894,12 +1135,17 @@ void TextureCache::_loadBackground(CachedTexture *pTexture)
 		params.internalFormat = gfxContext.convertInternalTextureFormat(u32(glInternalFormat));
 		params.dataType = glType;
 		params.data = pDest;
-		gfxContext.init2DTexture(params);
+		params.handle = _textureObject(pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
+		if (bStaged)
+			uploadStagedTexels(m_uploadBuffer.get(), params);
+		else
+			gfxContext.init2DTexture(params);
 	}
 	if (m_curUnpackAlignment > 1)
 		gfxContext.setTextureUnpackAlignment(m_curUnpackAlignment);
 	free(pSwapped);
-	free(pDest);
+	if (!bStaged)
+		free(pDest);
 }
 
 bool TextureCache::_loadHiresTexture(u32 _tile, CachedTexture *_pTexture, u64 & _ricecrc)
@@ -957,7 +1203,6 @@ bool TextureCache::_loadHiresTexture(u32 _tile, CachedTexture *_pTexture, u64 &
 		ghqTexInfo.width != 0 && ghqTexInfo.height != 0) {
 		ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
 		Context::InitTextureParams params;
-		params.handle = _pTexture->name;
 		params.mipMapLevel = 0;
 		params.msaaLevel = 0;
 		params.width = ghqTexInfo.width;
@@ -966,12 +1211,14 @@ bool TextureCache::_loadHiresTexture(u32 _tile, CachedTexture *_pTexture, u64 &
 		params.format = ColorFormatParam(ghqTexInfo.texture_format);
 		params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
 		params.data = ghqTexInfo.data;
+		params.handle = _textureObject(_pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
 		gfxContext.init2DTexture(params);
 		assert(!gfxContext.isError());
 		_updateCachedTexture(ghqTexInfo, _pTexture, ghqTexInfo.width / tile_width);
 		return true;
 	}
 
+	_markHiresPending(_pTexture, _ricecrc);
 	return false;
 }
 
@@ -981,7 +1228,6 @@ void TextureCache::_loadDepthTexture(CachedTexture * _pTexture, u16* _pDest)
 		return;
 
 	Context::InitTextureParams params;
-	params.handle = _pTexture->name;
 	params.mipMapLevel = 0;
 	params.msaaLevel = 0;
 	params.width = _pTexture->realWidth;
@@ -990,6 +1236,7 @@ void TextureCache::_loadDepthTexture(CachedTexture * _pTexture, u16* _pDest)
 	params.format = colorFormat::RED;
 	params.dataType = datatype::UNSIGNED_SHORT;
 	params.data = _pDest;
+	params.handle = _textureObject(_pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
 	gfxContext.init2DTexture(params);
 }
 
@@ -1125,9 +1372,17 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 	DatatypeParam glType;
 	u32 sizeShift;
 
+	_pTexture->max_level = 0;
+
+	if (config.generalEmulation.enableLOD != 0 && gSP.texture.level > 1)
+		_pTexture->max_level = static_cast<u8>(_tile == 0 ? 0 : gSP.texture.level - 1);
+
+	// Layers of the texture array are RGBA8
+	const bool bArrayLayer = _useTextureArray(_pTexture);
+
 	const TextureLoadParameters & loadParams =
 			ImageFormat::get().tlp[gDP.otherMode.textureLUT][_pTexture->size][_pTexture->format];
-	if (loadParams.autoFormat == internalcolorFormat::RGBA8) {
+	if (bArrayLayer || loadParams.autoFormat == internalcolorFormat::RGBA8) {
 		sizeShift = 2;
 		_pTexture->textureBytes = (_pTexture->realWidth * _pTexture->realHeight) << sizeShift;
 		GetTexel = loadParams.Get32;
@@ -1141,14 +1396,19 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 		glType = loadParams.glType16;
 	}
 
-	pDest = (u32*)malloc(_pTexture->textureBytes);
-	assert(pDest != nullptr);
+	// Texels are decoded straight into the upload buffer unless they are read back on the CPU
+	const bool bReadTexels =
+		((config.generalEmulation.hacks&hack_LoadDepthTextures) != 0 && gDP.colorImage.address == gDP.depthImageAddress) ||
+		(m_toggleDumpTex && config.textureFilter.txHiresEnable != 0 && config.textureFilter.txDump != 0) ||
+		(config.textureFilter.txEnhancementMode | config.textureFilter.txFilterMode) != 0;
+	pDest = bReadTexels ? nullptr : _stageTexels(_pTexture->textureBytes);
+	const bool bStaged = pDest != nullptr;
+	if (!bStaged) {
+		pDest = (u32*)malloc(_pTexture->textureBytes);
+		assert(pDest != nullptr);
+	}
 
 	s32 mipLevel = 0;
-	_pTexture->max_level = 0;
-
-	if (config.generalEmulation.enableLOD != 0 && gSP.texture.level > 1)
-		_pTexture->max_level = static_cast<u8>(_tile == 0 ? 0 : gSP.texture.level - 1);
 
 	ObjectHandle name;
 	CachedTexture tmptex(name);
@@ -1186,7 +1446,6 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 							&ghqTexInfo) != 0 && ghqTexInfo.data != nullptr) {
 				ghqTexInfo.format = gfxContext.convertInternalTextureFormat(ghqTexInfo.format);
 				Context::InitTextureParams params;
-				params.handle = _pTexture->name;
 				params.textureUnitIndex = textureIndices::Tex[_tile];
 				params.mipMapLevel = 0;
 				params.msaaLevel = 0;
@@ -1196,18 +1455,40 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 				params.format = ColorFormatParam(ghqTexInfo.texture_format);
 				params.dataType = DatatypeParam(ghqTexInfo.pixel_type);
 				params.data = ghqTexInfo.data;
+				params.handle = _textureObject(_pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels);
 				gfxContext.init2DTexture(params);
 				_updateCachedTexture(ghqTexInfo, _pTexture, ghqTexInfo.width / tmptex.realWidth);
 				bLoaded = true;
 			}
 		}
-		if (!bLoaded) {
+		if (!bLoaded && bArrayLayer) {
+			_pTexture->arrayLayer = m_freeArrayLayers.back();
+			m_freeArrayLayers.pop_back();
+			Context::UpdateTextureDataParams params;
+			params.handle = m_textureArray;
+			params.textureUnitIndex = textureIndices::ArrayTex;
+			params.layer = _pTexture->arrayLayer;
+			params.width = tmptex.realWidth;
+			params.height = tmptex.realHeight;
+			params.format = colorFormat::RGBA;
+			params.dataType = glType;
+			if (bStaged) {
+				m_uploadBuffer->closeWriteBuffer();
+				PixelBufferBinder<PixelWriteBuffer> binder(m_uploadBuffer.get());
+				params.data = m_uploadBuffer->getData();
+				gfxContext.updateTextureArray(params);
+			} else {
+				params.data = pDest;
+				gfxContext.updateTextureArray(params);
+			}
+			// The layer is taken whole, whatever the texture size
+			_pTexture->textureBytes = arrayLayerSize * arrayLayerSize * 4;
+		} else if (!bLoaded) {
 			if (tmptex.realWidth % 2 != 0 &&
 				glInternalFormat != internalcolorFormat::RGBA8 &&
 				m_curUnpackAlignment > 1)
 				gfxContext.setTextureUnpackAlignment(2);
 			Context::InitTextureParams params;
-			params.handle = _pTexture->name;
 			params.textureUnitIndex = textureIndices::Tex[_tile];
 			params.mipMapLevel = mipLevel;
 			params.mipMapLevels = _pTexture->max_level + 1;
@@ -1218,7 +1499,11 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 			params.format = colorFormat::RGBA;
 			params.dataType = glType;
 			params.data = pDest;
-			gfxContext.init2DTexture(params);
+			params.handle = mipLevel == 0 ? _textureObject(_pTexture, params.width, params.height, params.internalFormat, params.mipMapLevels) : _pTexture->name;
+			if (bStaged)
+				uploadStagedTexels(m_uploadBuffer.get(), params);
+			else
+				gfxContext.init2DTexture(params);
 		}
 		if (mipLevel == _pTexture->max_level)
 			break;
@@ -1242,10 +1527,17 @@ void TextureCache::_load(u32 _tile, CachedTexture *_pTexture)
 		if (tmptex.realHeight > 1)
 			tmptex.realHeight >>= 1;
 		_pTexture->textureBytes += (tmptex.realWidth * tmptex.realHeight) << sizeShift;
+		if (bStaged) {
+			// The GPU may not have read the previous level yet
+			pDest = _stageTexels((tmptex.realWidth * tmptex.realHeight) << sizeShift);
+			if (pDest == nullptr)
+				break;
+		}
 	}
 	if (m_curUnpackAlignment > 1)
 		gfxContext.setTextureUnpackAlignment(m_curUnpackAlignment);
-	free(pDest);
+	if (!bStaged)
+		free(pDest);
 }
 
 struct TextureParams
@@ -1346,13 +1638,65 @@ void TextureCache::activateTexture(u32 _t, CachedTexture *_pTexture)
 			params.maxAnisotropy = Parameter(config.texture.maxAnisotropyF);
 	}
 
-	gfxContext.setTextureParameters(params);
-
 	current[_t] = _pTexture;
+
+	s16 * texArray = m_texArray.tile[_t];
+	texArray[0] = _pTexture->arrayLayer;
+	if (_pTexture->arrayLayer < 0) {
+		gfxContext.setTextureParameters(params);
+		return;
+	}
+
+	texArray[1] = s16(_pTexture->realWidth);
+	texArray[2] = s16(_pTexture->realHeight);
+	texArray[3] = 0;
+
+	Context::BindTextureParameters bindParams;
+	bindParams.texture = m_textureArray;
+	bindParams.textureUnitIndex = textureIndices::ArrayTex;
+	bindParams.target = textureTarget::TEXTURE_2D_ARRAY;
+	gfxContext.bindTexture(bindParams);
+	setTextureParameters(_t, params.wrapS, params.wrapT, params.magFilter);
+}
+
+static
+u32 arrayWrapMode(Parameter _wrap)
+{
+	if (_wrap == textureParameters::WRAP_CLAMP_TO_EDGE)
+		return 2;
+	if (_wrap == textureParameters::WRAP_MIRRORED_REPEAT)
+		return 1;
+	return 0;
+}
+
+void TextureCache::setTextureParameters(u32 _t, TextureParam _wrapS, TextureParam _wrapT, TextureParam _filter)
+{
+	CachedTexture * pTexture = current[_t];
+	if (pTexture->arrayLayer >= 0) {
+		s16 & mode = m_texArray.tile[_t][3];
+		if (_wrapS.isValid())
+			mode = s16((mode & ~0x03) | arrayWrapMode(_wrapS));
+		if (_wrapT.isValid())
+			mode = s16((mode & ~0x0C) | (arrayWrapMode(_wrapT) << 2));
+		if (_filter.isValid())
+			mode = s16((mode & ~0x10) | (_filter == textureParameters::FILTER_LINEAR ? 0x10 : 0));
+		return;
+	}
+
+	Context::TexParameters params;
+	params.handle = pTexture->name;
+	params.target = textureTarget::TEXTURE_2D;
+	params.textureUnitIndex = textureIndices::Tex[_t];
+	params.wrapS = _wrapS;
+	params.wrapT = _wrapT;
+	params.minFilter = _filter;
+	params.magFilter = _filter;
+	gfxContext.setTextureParameters(params);
 }
 
 void TextureCache::activateDummy(u32 _t)
 {
+	m_texArray.tile[_t][0] = -1;
 	Context::TexParameters params;
 	params.handle = m_pDummy->name;
 	params.target = textureTarget::TEXTURE_2D;
@@ -1364,6 +1708,7 @@ void TextureCache::activateDummy(u32 _t)
 
 void TextureCache::activateMSDummy(u32 _t)
 {
+	m_texArray.tile[_t][0] = -1;
 	Context::TexParameters params;
 	params.handle = m_pMSDummy->name;
 	params.target = textureTarget::TEXTURE_2D_MULTISAMPLE;
@@ -1392,19 +1737,25 @@ void TextureCache::_updateBackground()
 	if (locations_iter != m_lruTextureLocations.end()) {
 		Textures::iterator iter = locations_iter->second;
 		CachedTexture & current = *iter;
-		m_textures.splice(m_textures.begin(), m_textures, iter);
 
-		assert(current.width == gSP.bgImage.width);
-		assert(current.height == gSP.bgImage.height);
-		assert(current.format == gSP.bgImage.format);
-		assert(current.size == gSP.bgImage.size);
+		if (!_hiresStreamed(current)) {
+			_useTexture(iter);
 
-		activateTexture(0, &current);
-		m_hits++;
-		return;
+			assert(current.width == gSP.bgImage.width);
+			assert(current.height == gSP.bgImage.height);
+			assert(current.format == gSP.bgImage.format);
+			assert(current.size == gSP.bgImage.size);
+
+			activateTexture(0, &current);
+			++m_frameStats.hits;
+			return;
+		}
+
+		// The hires replacement is ready, load it instead of the native texture.
+		_removeTexture(iter);
 	}
 
-	m_misses++;
+	++m_frameStats.misses;
 
 	CachedTexture * pCurrent = _addTexture(crc);
 
@@ -1445,6 +1796,8 @@ void TextureCache::_updateBackground()
 	activateTexture(0, pCurrent);
 
 	m_cachedBytes += pCurrent->textureBytes;
+	if (pCurrent->bProbation)
+		m_probationBytes += pCurrent->textureBytes;
 	current[0] = pCurrent;
 }
 
@@ -1454,10 +1807,22 @@ void TextureCache::_clear()
 
 	for (auto cur = m_textures.cbegin(); cur != m_textures.cend(); ++cur) {
 		m_cachedBytes -= cur->textureBytes;
-		gfxContext.deleteTexture(cur->name);
+		_releaseTexture(*cur);
+	}
+	for (auto cur = m_probationTextures.cbegin(); cur != m_probationTextures.cend(); ++cur) {
+		m_cachedBytes -= cur->textureBytes;
+		_releaseTexture(*cur);
 	}
 	m_textures.clear();
+	m_probationTextures.clear();
 	m_lruTextureLocations.clear();
+	m_probationBytes = 0;
+}
+
+void TextureCache::frameEnd()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = Stats();
 }
 
 void TextureCache::update(u32 _t)
@@ -1529,7 +1894,11 @@ void TextureCache::update(u32 _t)
 
 	const u32 crc = _calculateCRC(_t, params, sizes.bytes);
 
-	if (current[_t] != nullptr && current[_t]->crc == crc) {
+	// Array textures have no mipmaps. LOD combiners reload them as regular textures.
+	const bool bArrayUsable = !currentCombiner()->usesLOD();
+
+	if (current[_t] != nullptr && current[_t]->crc == crc && current[_t]->hiresPendingCrc == 0 &&
+		(current[_t]->arrayLayer < 0 || bArrayUsable)) {
 		activateTexture(_t, current[_t]);
 		return;
 	}
@@ -1539,24 +1908,25 @@ void TextureCache::update(u32 _t)
 		Textures::iterator iter = locations_iter->second;
 		CachedTexture & current = *iter;
 
-		if (current.width == sizes.width && current.height == sizes.height) {
-			m_textures.splice(m_textures.begin(), m_textures, iter);
+		if (current.width == sizes.width && current.height == sizes.height && !_hiresStreamed(current) &&
+			(current.arrayLayer < 0 || bArrayUsable)) {
+			_useTexture(iter);
 
 			assert(current.format == pTile->format);
 			assert(current.size == pTile->size);
 
 			activateTexture(_t, &current);
-			m_hits++;
+			++m_frameStats.hits;
 			return;
 		}
 
-		m_cachedBytes -= current.textureBytes;
-		gfxContext.deleteTexture(current.name);
-		m_lruTextureLocations.erase(locations_iter);
-		m_textures.erase(iter);
+		// The other tile may still use the removed texture
+		if (this->current[_t ^ 1] == &current)
+			this->current[_t ^ 1] = nullptr;
+		_removeTexture(iter);
 	}
 
-	m_misses++;
+	++m_frameStats.misses;
 
 	CachedTexture * pCurrent = _addTexture(crc);
 
@@ -1601,6 +1971,8 @@ void TextureCache::update(u32 _t)
 	activateTexture( _t, pCurrent );
 
 	m_cachedBytes += pCurrent->textureBytes;
+	if (pCurrent->bProbation)
+		m_probationBytes += pCurrent->textureBytes;
 	current[_t] = pCurrent;
 }
 
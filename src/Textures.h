@@ -4,17 +4,21 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <memory>
+#include <vector>
 
 #include "CRC.h"
 #include "convert.h"
 #include "Graphics/ObjectHandle.h"
 #include "Graphics/Parameter.h"
+#include "Graphics/PixelBuffer.h"
+#include "GraphicsDrawer.h"
 
 typedef u32 (*GetTexelFunc)( u64 *src, u16 x, u16 i, u8 palette );
 
 struct CachedTexture
 {
-	CachedTexture(graphics::ObjectHandle _name) : name(_name), max_level(0), frameBufferTexture(fbNone), bHDTexture(false) {}
+	CachedTexture(graphics::ObjectHandle _name) : name(_name), max_level(0), frameBufferTexture(fbNone), bHDTexture(false), bProbation(false), hiresPendingCrc(0), storageKey(0), arrayLayer(-1) {}
 
 	graphics::ObjectHandle name;
 	u32		crc;
@@ -44,6 +48,10 @@ struct CachedTexture
 		fbMultiSample = 2
 	} frameBufferTexture;
 	bool bHDTexture;
+	bool bProbation;		// Not used since it was loaded. Such textures are evicted first by the 2Q policy.
+	u64 hiresPendingCrc;	// Rice crc of a hires replacement which is still streaming in
+	u64 storageKey;			// Size, format and mip levels of the texture object storage
+	s16 arrayLayer;			// Layer in the texture array, or -1 for textures with their own texture object
 };
 
 
@@ -60,11 +68,29 @@ struct TextureCache
 	void activateDummy(u32 _t);
 	void activateMSDummy(u32 _t);
 	void update(u32 _t);
+	void frameEnd();
+	// Overrides wrap modes or filtering of the texture active on tile _t. Invalid parameters are kept.
+	void setTextureParameters(u32 _t, graphics::TextureParam _wrapS, graphics::TextureParam _wrapT, graphics::TextureParam _filter);
+
+	// Array layer, size and sampler mode of the active textures, drawn with every vertex
+	const TexArrayAttribs & getTexArrayAttribs() const { return m_texArray; }
+
+	struct Stats
+	{
+		u32 hits = 0;
+		u32 misses = 0;
+		u32 created = 0;	// texture objects created for misses
+		u32 reused = 0;		// texture objects of evicted textures reused for misses
+		u32 promoted = 0;	// probation textures moved to the frequently used queue
+	};
+
+	// Counters of the last finished frame
+	const Stats & getStats() const { return m_lastFrameStats; }
 
 	static TextureCache & get();
 
 private:
-	TextureCache() : m_pDummy(nullptr), m_hits(0), m_misses(0), m_maxBytes(0), m_cachedBytes(0), m_curUnpackAlignment(4), m_toggleDumpTex(false)
+	TextureCache() : m_pDummy(nullptr), m_maxBytes(0), m_cachedBytes(0), m_probationBytes(0), m_ghostBytes(0), m_pooledBytes(0), m_curUnpackAlignment(4), m_toggleDumpTex(false)
 	{
 		current[0] = nullptr;
 		current[1] = nullptr;
@@ -72,29 +98,82 @@ private:
 	}
 	TextureCache(const TextureCache &);
 
+	typedef std::list<CachedTexture> Textures;
+	typedef std::unordered_map<u32, Textures::iterator> Texture_Locations;
+
 	void _checkCacheSize();
+	u32 * _stageTexels(u32 _bytes);
 	CachedTexture * _addTexture(u32 _crc32);
+	void _useTexture(Textures::iterator _iter);
+	void _removeTexture(Textures::iterator _iter);
+	void _evictTexture();
+	void _addGhost(const CachedTexture & _texture);
+	graphics::ObjectHandle _textureObject(CachedTexture * _pTexture, u32 _width, u32 _height, graphics::Parameter _internalFormat, u32 _mipMapLevels);
+	void _releaseTexture(const CachedTexture & _texture);
+	void _trimTexturePool(u32 _maxBytes);
 	void _load(u32 _tile, CachedTexture *_pTexture);
 	bool _loadHiresTexture(u32 _tile, CachedTexture *_pTexture, u64 & _ricecrc);
 	void _loadBackground(CachedTexture *pTexture);
 	bool _loadHiresBackground(CachedTexture *_pTexture);
+	void _markHiresPending(CachedTexture *_pTexture, u64 _ricecrc);
+	bool _hiresStreamed(const CachedTexture & _texture);
 	void _loadDepthTexture(CachedTexture * _pTexture, u16* _pDest);
 	void _updateBackground();
 	void _clear();
 	void _initDummyTexture(CachedTexture * _pDummy);
+	void _initTextureArray();
+	bool _useTextureArray(const CachedTexture * _pTexture) const;
+	void _releaseArrayLayer(const CachedTexture & _texture);
 	void _getTextureDestData(CachedTexture& tmptex, u32* pDest, graphics::Parameter glInternalFormat, GetTexelFunc GetTexel, u16* pLine);
 
-	typedef std::list<CachedTexture> Textures;
-	typedef std::unordered_map<u32, Textures::iterator> Texture_Locations;
 	typedef std::map<graphics::ObjectHandle, CachedTexture> FBTextures;
+
+	// Checksums of textures evicted from the probation queue, most recent first.
+	// A texture loaded again while it is remembered here skips probation.
+	struct GhostTexture
+	{
+		u32 crc;
+		u32 textureBytes;
+	};
+	typedef std::list<GhostTexture> Ghosts;
+	typedef std::unordered_map<u32, Ghosts::iterator> Ghost_Locations;
+
+	// Texture objects of evicted textures, most recently released first.
+	// Their immutable storage is reused by new textures of the same size and format.
+	struct PooledTexture
+	{
+		u64 storageKey;
+		graphics::ObjectHandle name;
+		u32 textureBytes;
+	};
+	typedef std::list<PooledTexture> TexturePool;
+	typedef std::unordered_multimap<u64, TexturePool::iterator> TexturePool_Locations;
+
+	// Staging memory which decoded texels are written to and uploaded from
+	std::unique_ptr<graphics::PixelWriteBuffer> m_uploadBuffer;
 	Textures m_textures;
+	Textures m_probationTextures;
 	Texture_Locations m_lruTextureLocations;
+	Ghosts m_ghosts;
+	Ghost_Locations m_ghostLocations;
 	FBTextures m_fbTextures;
+	TexturePool m_texturePool;
+	TexturePool_Locations m_texturePoolLocations;
 	CachedTexture * m_pDummy;
 	CachedTexture * m_pMSDummy;
-	u32 m_hits, m_misses;
+	// Textures up to arrayLayerSize texels square share the layers of one texture array
+	static const u32 arrayLayerSize = 64;
+	static const u32 arrayLayers = 256;
+	graphics::ObjectHandle m_textureArray;
+	std::vector<s16> m_freeArrayLayers;
+	TexArrayAttribs m_texArray;
+	Stats m_frameStats;
+	Stats m_lastFrameStats;
 	u32 m_maxBytes;
 	u32 m_cachedBytes;
+	u32 m_probationBytes;
+	u32 m_ghostBytes;
+	u32 m_pooledBytes;
 	s32 m_curUnpackAlignment;
 	bool m_toggleDumpTex;
 };
@@ -1,7 +1,7 @@
 #include "GLideNHQ/Ext_TxFilter.h"
 
 TAPI boolean TAPIENTRY
-txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize,
+txfilter_init(int maxwidth, int maxheight, int maxbpp, int options, int cachesize, int hirescachesize, int hashid,
 	const wchar_t *path, const wchar_t * texPackPath, const wchar_t*ident, dispInfoFuncExt callback) 
 {
 	return 0;
@@ -42,3 +42,8 @@ txfilter_reloadhirestex()
 	return 0;
 }
 
+TAPI boolean TAPIENTRY
+txfilter_hirestexpending(uint64 r_crc64)
+{
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include <iterator>
+#include <string.h>
+#include "VertexBatchCache.h"
+
+VertexBatchCache & VertexBatchCache::get()
+{
+	static VertexBatchCache cache;
+	return cache;
+}
+
+bool VertexBatchCache::load(u64 _key, u32 _num, SPVertex * _vertices)
+{
+	Batch_Locations::iterator iter = m_locations.find(_key);
+	if (iter == m_locations.end() || iter->second->vertices.size() != _num) {
+		++m_frameStats.misses;
+		return false;
+	}
+
+	m_batches.splice(m_batches.begin(), m_batches, iter->second);
+	memcpy(_vertices, m_batches.front().vertices.data(), _num * sizeof(SPVertex));
+	++m_frameStats.hits;
+	return true;
+}
+
+void VertexBatchCache::store(u64 _key, u32 _num, const SPVertex * _vertices)
+{
+	if (_num == 0 || _num > s_maxVertices)
+		return;
+
+	Batch_Locations::iterator iter = m_locations.find(_key);
+	if (iter != m_locations.end()) {
+		m_numVertices -= u32(iter->second->vertices.size());
+		m_batches.erase(iter->second);
+		m_locations.erase(iter);
+	}
+
+	// Evict least recently used batches. The last one keeps its storage for the new batch.
+	bool reuse = false;
+	while (!m_batches.empty() && m_numVertices + _num > s_maxVertices) {
+		Batches::iterator last = std::prev(m_batches.end());
+		m_numVertices -= u32(last->vertices.size());
+		m_locations.erase(last->key);
+		if (m_numVertices + _num <= s_maxVertices) {
+			m_batches.splice(m_batches.begin(), m_batches, last);
+			reuse = true;
+		} else
+			m_batches.erase(last);
+	}
+	if (!reuse)
+		m_batches.emplace_front();
+
+	Batch & batch = m_batches.front();
+	batch.key = _key;
+	batch.vertices.assign(_vertices, _vertices + _num);
+	m_locations[_key] = m_batches.begin();
+	m_numVertices += _num;
+}
+
+void VertexBatchCache::clear()
+{
+	m_batches.clear();
+	m_locations.clear();
+	m_numVertices = 0;
+}
+
+void VertexBatchCache::frameEnd()
+{
+	m_frameStats.vertices = m_numVertices;
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = Stats();
+}
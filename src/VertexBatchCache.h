@@ -0,0 +1,52 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "Types.h"
+#include "gSP.h"
+
+// Vertices loaded by gSPVertex, gSPCIVertex and gSPDMAVertex after transformation
+// and lighting. Batches are keyed by a hash of their RDRAM source data and of
+// the state they were processed with, so static geometry is processed once.
+class VertexBatchCache
+{
+public:
+	struct Stats
+	{
+		u32 hits = 0;
+		u32 misses = 0;
+		u32 vertices = 0;
+	};
+
+	// Copies the batch cached for _key to _vertices. Returns false on a miss.
+	bool load(u64 _key, u32 _num, SPVertex * _vertices);
+	void store(u64 _key, u32 _num, const SPVertex * _vertices);
+	void clear();
+	void frameEnd();
+
+	// Counters of the last finished frame
+	const Stats & getStats() const { return m_lastFrameStats; }
+
+	static VertexBatchCache & get();
+
+private:
+	VertexBatchCache() = default;
+	VertexBatchCache(const VertexBatchCache & _other) = delete;
+
+	struct Batch
+	{
+		u64 key;
+		std::vector<SPVertex> vertices;
+	};
+
+	typedef std::list<Batch> Batches;
+	typedef std::unordered_map<u64, Batches::iterator> Batch_Locations;
+
+	static const u32 s_maxVertices = 64 * 1024;
+
+	Batches m_batches;
+	Batch_Locations m_locations;
+	u32 m_numVertices = 0;
+	Stats m_frameStats;
+	Stats m_lastFrameStats;
+};
@@ -146,6 +146,7 @@ void ZSort_DrawObject (u8 * _addr, u32 _type)
 		vtx.a = _addr[7^3] * 0.0039215689f;
 		vtx.flag = 0;
 		vtx.HWLight = 0;
+		vtx.lightState = 0;
 		vtx.clip = 0;
 		if (textured != 0) {
 			vtx.s = _FIXED2FLOAT(((s16*)_addr)[4^1], 5 );
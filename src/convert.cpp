@@ -1,5 +1,19 @@
 #include "convert.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONVERT_SSE2
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
 const volatile unsigned char Five2Eight[32] =
 {
 	  0, // 00000 = 00000000
@@ -99,6 +113,74 @@ const volatile unsigned char One2Eight[2] =
 	255, // 1 = 11111111
 };
 
+// Byte swap each of _numDWords dwords from _src to _dest. Neither range wraps.
+static
+void UnswapCopyDWords(const u8 *_src, u8 *_dest, u32 _numDWords)
+{
+	u32 i = 0;
+#ifdef __AVX2__
+	const __m256i swap256 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+											 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	for (; i + 8 <= _numDWords; i += 8) {
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(_src + (i << 2)));
+		_mm256_storeu_si256((__m256i*)(_dest + (i << 2)), _mm256_shuffle_epi8(v, swap256));
+	}
+#endif
+#if defined(CONVERT_SSE2)
+#ifdef __SSSE3__
+	const __m128i swap128 = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+#endif
+	for (; i + 4 <= _numDWords; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(_src + (i << 2)));
+#ifdef __SSSE3__
+		v = _mm_shuffle_epi8(v, swap128);
+#else
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+#endif
+		_mm_storeu_si128((__m128i*)(_dest + (i << 2)), v);
+	}
+#elif defined(CONVERT_NEON)
+	for (; i + 4 <= _numDWords; i += 4)
+		vst1q_u8(_dest + (i << 2), vrev32q_u8(vld1q_u8(_src + (i << 2))));
+#endif
+	for (; i < _numDWords; ++i) {
+		const u8 *src = _src + (i << 2);
+		u8 *dest = _dest + (i << 2);
+		dest[3] = src[0];
+		dest[2] = src[1];
+		dest[1] = src[2];
+		dest[0] = src[3];
+	}
+}
+
+// Swap the dwords of each of _numQWords qwords in place. The range does not wrap.
+static
+void DWordInterleave(u32 *_src, u32 _numQWords)
+{
+	u32 i = 0;
+#ifdef __AVX2__
+	for (; i + 4 <= _numQWords; i += 4) {
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(_src + (i << 1)));
+		_mm256_storeu_si256((__m256i*)(_src + (i << 1)), _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+#endif
+#if defined(CONVERT_SSE2)
+	for (; i + 2 <= _numQWords; i += 2) {
+		const __m128i v = _mm_loadu_si128((const __m128i*)(_src + (i << 1)));
+		_mm_storeu_si128((__m128i*)(_src + (i << 1)), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+#elif defined(CONVERT_NEON)
+	for (; i + 2 <= _numQWords; i += 2)
+		vst1q_u32(_src + (i << 1), vrev64q_u32(vld1q_u32(_src + (i << 1))));
+#endif
+	for (; i < _numQWords; ++i) {
+		const u32 p0 = _src[i << 1];
+		_src[i << 1] = _src[(i << 1) + 1];
+		_src[(i << 1) + 1] = p0;
+	}
+}
+
 void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes)
 {
 	// copy leading bytes
@@ -119,7 +201,29 @@ void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMa
 	}
 
 	// copy dwords
-	int numDWords = numBytes >> 2;
+	u32 numDWords = numBytes >> 2;
+	if ((destMask & (destMask + 1)) == 0) {
+		// Power of two destination: split the copy at the wrap points into contiguous spans
+		while (numDWords != 0) {
+			const u32 destPos = destIdx & destMask;
+			const u64 spanBytes = u64(destMask) + 1 - destPos;
+			if (spanBytes < 4) {
+				// dword straddles the wrap point
+				dest[(destIdx + 3) & destMask] = src[srcIdx++];
+				dest[(destIdx + 2) & destMask] = src[srcIdx++];
+				dest[(destIdx + 1) & destMask] = src[srcIdx++];
+				dest[(destIdx + 0) & destMask] = src[srcIdx++];
+				destIdx += 4;
+				--numDWords;
+				continue;
+			}
+			const u32 spanDWords = spanBytes >= (u64(numDWords) << 2) ? numDWords : u32(spanBytes >> 2);
+			UnswapCopyDWords(src + srcIdx, dest + destPos, spanDWords);
+			srcIdx += spanDWords << 2;
+			destIdx += spanDWords << 2;
+			numDWords -= spanDWords;
+		}
+	}
 	while (numDWords--) {
 		dest[(destIdx + 3) & destMask] = src[srcIdx++];
 		dest[(destIdx + 2) & destMask] = src[srcIdx++];
@@ -142,6 +246,19 @@ void UnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMa
 
 void DWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords)
 {
+	if ((srcIdx & 1) == 0 && srcMask != 0 && (srcMask & (srcMask + 1)) == 0) {
+		// Qwords never straddle the wrap point, so swap contiguous spans up to it
+		while (numQWords != 0) {
+			const u32 pos = srcIdx & srcMask;
+			const u64 spanQWords = (u64(srcMask) + 1 - pos) >> 1;
+			const u32 span = spanQWords >= numQWords ? numQWords : u32(spanQWords);
+			DWordInterleave(src + pos, span);
+			srcIdx += span << 1;
+			numQWords -= span;
+		}
+		return;
+	}
+
 	u32 p0, idx0, idx1;
 	while (numQWords--)	{
 		idx0 = srcIdx++ & srcMask;
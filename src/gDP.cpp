@@ -755,7 +755,7 @@ void gDPFillRectangle( s32 ulx, s32 uly, s32 lrx, s32 lry )
 		}
 	}
 
-	frameBufferList().setBufferChanged(lry);
+	frameBufferList().setBufferChanged((f32)ulx, (f32)uly, (f32)lrx, (f32)lry);
 
 	DebugMsg( DEBUG_NORMAL, "gDPFillRectangle( %i, %i, %i, %i );\n", ulx, uly, lrx, lry );
 }
@@ -840,7 +840,7 @@ void gDPTextureRectangle(f32 ulx, f32 uly, f32 lrx, f32 lry, s32 tile, f32 s, f3
 	gSP.textureTile[0] = textureTileOrg[0];
 	gSP.textureTile[1] = textureTileOrg[1];
 
-	frameBufferList().setBufferChanged(lry);
+	frameBufferList().setBufferChanged(ulx, uly, lrx, lry);
 
 	if (flip)
 		DebugMsg( DEBUG_NORMAL, "gDPTextureRectangleFlip( %f, %f, %f, %f, %i, %f, %f, %f, %f);\n",
@@ -20,6 +20,8 @@
 #include "DepthBuffer.h"
 #include "Config.h"
 #include "Log.h"
+#include "VertexBatchCache.h"
+#include "xxHash/xxhash.h"
 
 #include <Graphics/Context.h>
 #include <Graphics/Parameters.h>
@@ -325,6 +327,7 @@ void gSPProcessVertex4(u32 v)
 		vPos[i][1] = vtx.y;
 		vPos[i][2] = vtx.z;
 		vtx.modify = 0;
+		vtx.lightState = 0;
 	}
 	gSPTransformVertex4(v, gSP.matrix.combined );
 
@@ -353,7 +356,16 @@ void gSPProcessVertex4(u32 v)
 	if (gSP.matrix.billboard)
 		gSPBillboardVertex4(v);
 
-	if (gSP.geometryMode & G_LIGHTING) {
+	if ((gSP.geometryMode & G_LIGHTING) != 0 && gSP.lightStates.current != 0) {
+		for(int i = 0; i < 4; ++i) {
+			SPVertex & vtx = drawer.getVertex(v+i);
+			vtx.HWLight = 0;
+			vtx.lightState = u8(gSP.lightStates.current);
+			vtx.r = vtx.nx;
+			vtx.g = vtx.ny;
+			vtx.b = vtx.nz;
+		}
+	} else if (gSP.geometryMode & G_LIGHTING) {
 		if (gSP.geometryMode & G_POINT_LIGHTING)
 			gSPPointLightVertex4(v, vPos);
 		else
@@ -623,8 +635,15 @@ void gSPProcessVertex(u32 v)
 
 	gSPClipVertex(v);
 	vtx.modify = 0;
+	vtx.lightState = 0;
 
-	if (gSP.geometryMode & G_LIGHTING) {
+	if ((gSP.geometryMode & G_LIGHTING) != 0 && gSP.lightStates.current != 0) {
+		vtx.HWLight = 0;
+		vtx.lightState = u8(gSP.lightStates.current);
+		vtx.r = vtx.nx;
+		vtx.g = vtx.ny;
+		vtx.b = vtx.nz;
+	} else if (gSP.geometryMode & G_LIGHTING) {
 		if (gSP.geometryMode & G_POINT_LIGHTING)
 			gSPPointLightVertex(vtx, vPos);
 		else
@@ -975,6 +994,199 @@ void gSPUpdateLookatVectors()
 	gSP.changed ^= CHANGED_LOOKAT;
 }
 
+void gSPResolveLightState(SPVertex & _vtx)
+{
+	if (_vtx.lightState == 0)
+		return;
+
+	const SPLightState & state = gSP.lightStates.states[_vtx.lightState - 1];
+	const u32 numLights = u32(state.params[0]);
+	_vtx.r = state.rgb[numLights][R];
+	_vtx.g = state.rgb[numLights][G];
+	_vtx.b = state.rgb[numLights][B];
+	for (u32 i = 0; i < numLights; ++i) {
+		f32 intensity = DotProduct(&_vtx.nx, state.dir[i]);
+		if (intensity < 0.0f)
+			intensity = 0.0f;
+		_vtx.r += state.rgb[i][R] * intensity;
+		_vtx.g += state.rgb[i][G] * intensity;
+		_vtx.b += state.rgb[i][B] * intensity;
+	}
+	_vtx.r = min(1.0f, _vtx.r);
+	_vtx.g = min(1.0f, _vtx.g);
+	_vtx.b = min(1.0f, _vtx.b);
+
+	if (state.params[1] != 0.0f) {
+		f32 x, y;
+		if (state.params[2] != 0.0f) {
+			x = DotProduct(state.texGen[0], &_vtx.nx);
+			y = DotProduct(state.texGen[1], &_vtx.nx);
+		} else {
+			f32 fLightDir[3] = {
+				DotProduct(state.texGen[0], &_vtx.nx),
+				DotProduct(state.texGen[1], &_vtx.nx),
+				DotProduct(state.texGen[2], &_vtx.nx)
+			};
+			Normalize(fLightDir);
+			x = fLightDir[0];
+			y = fLightDir[1];
+		}
+		if (state.params[1] == 2.0f) {
+			_vtx.s = acosf(-x) * 325.94931f;
+			_vtx.t = acosf(-y) * 325.94931f;
+		} else {
+			_vtx.s = (x + 1.0f) * 512.0f;
+			_vtx.t = (y + 1.0f) * 512.0f;
+		}
+	}
+
+	_vtx.lightState = 0;
+}
+
+static
+void gSPUpdateLightState()
+{
+	gSP.lightStates.current = 0;
+	if ((gSP.geometryMode & G_LIGHTING) == 0 ||
+		(gSP.geometryMode & G_POINT_LIGHTING) != 0 ||
+		config.generalEmulation.enableShaderLighting == 0 ||
+		config.generalEmulation.enableHWLighting != 0 ||
+		GBI.getMicrocodeType() == F3DEX2CBFD ||
+		gSP.numLights > 7 ||
+		!gfxContext.isSupported(SpecialFeatures::VertexShaderLighting))
+		return;
+
+	SPLightState state;
+	memset(&state, 0, sizeof(SPLightState));
+	for (s32 i = 0; i < gSP.numLights; ++i)
+		memcpy(state.dir[i], gSP.lights.i_xyz[i], sizeof(f32) * 3);
+	for (s32 i = 0; i <= gSP.numLights; ++i)
+		memcpy(state.rgb[i], gSP.lights.rgb[i], sizeof(f32) * 3);
+	state.params[0] = f32(gSP.numLights);
+
+	if (GBI.isTextureGen() && (gSP.geometryMode & G_TEXTURE_GEN) != 0) {
+		state.params[1] = (gSP.geometryMode & G_TEXTURE_GEN_LINEAR) != 0 ? 2.0f : 1.0f;
+		if (gSP.lookatEnable) {
+			memcpy(state.texGen[0], gSP.lookat.i_xyz[0], sizeof(f32) * 3);
+			memcpy(state.texGen[1], gSP.lookat.i_xyz[1], sizeof(f32) * 3);
+			state.params[2] = 1.0f;
+		} else {
+			// Rows of the modelview rotation, see TransformVectorNormalize
+			f32 (*mtx)[4] = gSP.matrix.modelView[gSP.matrix.modelViewi];
+			for (u32 i = 0; i < 3; ++i) {
+				state.texGen[i][0] = mtx[0][i];
+				state.texGen[i][1] = mtx[1][i];
+				state.texGen[i][2] = mtx[2][i];
+			}
+		}
+	}
+
+	for (u32 i = 0; i < gSP.lightStates.num; ++i) {
+		if (memcmp(&gSP.lightStates.states[i], &state, sizeof(SPLightState)) == 0) {
+			gSP.lightStates.current = i + 1;
+			return;
+		}
+	}
+
+	if (gSP.lightStates.num == LIGHTSTATES_SIZE) {
+		// Draw pending triangles with the full table, then light on CPU
+		// the loaded vertices which still refer to it.
+		GraphicsDrawer & drawer = dwnd().getDrawer();
+		drawer.drawTriangles();
+		for (u32 i = 0; i < VERTBUFF_SIZE; ++i)
+			gSPResolveLightState(drawer.getVertex(i));
+		gSP.lightStates.num = 0;
+	}
+
+	gSP.lightStates.states[gSP.lightStates.num++] = state;
+	gSP.lightStates.current = gSP.lightStates.num;
+	++gSP.lightStates.version;
+}
+
+// Key of _n vertices loaded from RDRAM with the current matrices, lights and modes.
+// Returns 0 when the processed vertices must not be cached.
+static
+u64 gSPVertexBatchKey(u32 _n, u32 _address, u32 _size, u32 _colorAddress = 0, u32 _colorSize = 0)
+{
+	if (config.generalEmulation.enableVertexCache == 0 || gSP.matrix.billboard != 0 || _n == 0)
+		return 0;
+
+	// Vertex data is read with byte swapping inside words
+	const u32 start = _address & ~3U;
+	const u32 end = (_address + _size + 3U) & ~3U;
+	if (end > RDRAMSize + 1 || _colorAddress + _colorSize > RDRAMSize + 1)
+		return 0;
+
+	if (gSP.changed & CHANGED_MATRIX)
+		gSPCombineMatrices();
+
+	DisplayWindow & wnd = dwnd();
+	struct
+	{
+		f32 combined[4][4];
+		f32 adjustScale;
+		u32 geometryMode;
+		u32 microcode;
+		u32 flags;
+		u32 num;
+	} state;
+	memset(&state, 0, sizeof(state));
+	memcpy(state.combined, gSP.matrix.combined, sizeof(state.combined));
+	state.adjustScale = (wnd.isAdjustScreen() && (gDP.colorImage.width > VI.width * 98 / 100)) ? wnd.getAdjustScale() : 1.0f;
+	state.geometryMode = gSP.geometryMode;
+	state.microcode = GBI.getMicrocodeType();
+	state.flags =
+		(gSP.viewport.vscale[0] < 0 ? 1U : 0U) |
+		(gSP.viewport.vscale[1] < 0 ? 2U : 0U) |
+		(gSP.matrix.projection[3][2] == -1.f ? 4U : 0U) |
+		(gSP.lookatEnable ? 8U : 0U) |
+		(GBI.isTextureGen() ? 16U : 0U) |
+		(config.generalEmulation.enableHWLighting != 0 ? 32U : 0U) |
+		(gSP.lightStates.current != 0 ? 64U : 0U);
+	state.num = _n;
+
+	u64 key = XXH64(&state, sizeof(state), 0);
+	if ((gSP.geometryMode & (G_LIGHTING | G_ACCLAIM_LIGHTING)) != 0) {
+		key = XXH64(&gSP.lights, sizeof(gSP.lights), key);
+		key = XXH64(&gSP.lookat, sizeof(gSP.lookat), key);
+		key = XXH64(&gSP.numLights, sizeof(gSP.numLights), key);
+		key = XXH64(gSP.matrix.modelView[gSP.matrix.modelViewi], sizeof(gSP.matrix.modelView[0]), key);
+		key = XXH64(gSP.vertexCoordMod, sizeof(gSP.vertexCoordMod), key);
+		if (gSP.lightStates.current != 0)
+			key = XXH64(&gSP.lightStates.states[gSP.lightStates.current - 1], sizeof(SPLightState), key);
+	}
+	key = XXH64(&RDRAM[start], end - start, key);
+	if (_colorSize != 0)
+		key = XXH64(&RDRAM[_colorAddress], _colorSize, key);
+	return key != 0 ? key : 1;
+}
+
+static
+bool gSPLoadVertexBatch(u64 _key, u32 _n, u32 _v0)
+{
+	if (_key == 0)
+		return false;
+
+	GraphicsDrawer & drawer = dwnd().getDrawer();
+	if (!VertexBatchCache::get().load(_key, _n, &drawer.getVertex(_v0)))
+		return false;
+
+	// The light state table may have been refilled since the batch was stored
+	for (u32 i = _v0; i < _v0 + _n; ++i) {
+		SPVertex & vtx = drawer.getVertex(i);
+		if (vtx.lightState != 0)
+			vtx.lightState = u8(gSP.lightStates.current);
+	}
+	return true;
+}
+
+static
+void gSPStoreVertexBatch(u64 _key, u32 _n, u32 _v0)
+{
+	if (_key != 0)
+		VertexBatchCache::get().store(_key, _n, &dwnd().getDrawer().getVertex(_v0));
+}
+
 void gSPVertex(u32 a, u32 n, u32 v0)
 {
 	u32 address = RSP_SegmentToPhysical(a);
@@ -994,11 +1206,15 @@ void gSPVertex(u32 a, u32 n, u32 v0)
 		if (((gSP.geometryMode & G_TEXTURE_GEN) != 0) && ((gSP.changed & CHANGED_LOOKAT) != 0))
 			gSPUpdateLookatVectors();
 	}
+	gSPUpdateLightState();
 
 	Vertex *vertex = (Vertex*)&RDRAM[address];
 
 	GraphicsDrawer & drawer = dwnd().getDrawer();
 	if ((n + v0) <= INDEXMAP_SIZE) {
+		const u64 batchKey = gSPVertexBatchKey(n, address, sizeof(Vertex) * n);
+		if (gSPLoadVertexBatch(batchKey, n, v0))
+			return;
 		unsigned int i = v0;
 #ifdef __VEC4_OPT
 		for (; i < n - (n%4) + v0; i += 4) {
@@ -1050,6 +1266,7 @@ void gSPVertex(u32 a, u32 n, u32 v0)
 			DebugMsg(DEBUG_DETAIL, "v%d - x: %f, y: %f, z: %f, w: %f, s: %f, t: %f, r=%02f, g=%02f, b=%02f, a=%02f\n", i, vtx.x, vtx.y, vtx.z, vtx.w, vtx.s, vtx.t, vtx.r, vtx.g, vtx.b, vtx.a);
 			vertex++;
 		}
+		gSPStoreVertexBatch(batchKey, n, v0);
 	} else {
 		LOG(LOG_ERROR, "Using Vertex outside buffer v0=%i, n=%i\n", v0, n);
 		DebugMsg(DEBUG_NORMAL | DEBUG_ERROR, "//Using Vertex outside buffer v0 = %i, n = %i\n", v0, n);
@@ -1072,11 +1289,16 @@ void gSPCIVertex( u32 a, u32 n, u32 v0 )
 		if (((gSP.geometryMode & G_TEXTURE_GEN) != 0) && ((gSP.changed & CHANGED_LOOKAT) != 0))
 			gSPUpdateLookatVectors();
 	}
+	gSPUpdateLightState();
 
 	PDVertex *vertex = (PDVertex*)&RDRAM[address];
 
 	GraphicsDrawer & drawer = dwnd().getDrawer();
 	if ((n + v0) <= INDEXMAP_SIZE) {
+		// Colors and normals come from a table indexed by the low byte of ci
+		const u64 batchKey = gSPVertexBatchKey(n, address, sizeof(PDVertex) * n, gSP.vertexColorBase, 256 + 3);
+		if (gSPLoadVertexBatch(batchKey, n, v0))
+			return;
 		unsigned int i = v0;
 #ifdef __VEC4_OPT
 		for (; i < n - (n%4) + v0; i += 4) {
@@ -1131,6 +1353,7 @@ void gSPCIVertex( u32 a, u32 n, u32 v0 )
 			gSPProcessVertex(v);
 			vertex++;
 		}
+		gSPStoreVertexBatch(batchKey, n, v0);
 	} else {
 		LOG(LOG_ERROR, "Using Vertex outside buffer v0=%i, n=%i\n", v0, n);
 		DebugMsg(DEBUG_NORMAL | DEBUG_ERROR, "//Using Vertex outside buffer v0 = %i, n = %i\n", v0, n);
@@ -1153,9 +1376,13 @@ void gSPDMAVertex( u32 a, u32 n, u32 v0 )
 		if (((gSP.geometryMode & G_TEXTURE_GEN) != 0) && ((gSP.changed & CHANGED_LOOKAT) != 0))
 			gSPUpdateLookatVectors();
 	}
+	gSPUpdateLightState();
 
 	GraphicsDrawer & drawer = dwnd().getDrawer();
 	if ((n + v0) <= INDEXMAP_SIZE) {
+		const u64 batchKey = gSPVertexBatchKey(n, address, 10 * n);
+		if (gSPLoadVertexBatch(batchKey, n, v0))
+			return;
 		u32 i = v0;
 #ifdef __VEC4_OPT
 		for (; i < n - (n%4) + v0; i += 4) {
@@ -1204,6 +1431,7 @@ void gSPDMAVertex( u32 a, u32 n, u32 v0 )
 			gSPProcessVertex(v);
 			address += 10;
 		}
+		gSPStoreVertexBatch(batchKey, n, v0);
 	} else {
 		LOG(LOG_ERROR, "Using Vertex outside buffer v0=%i, n=%i\n", v0, n);
 		DebugMsg(DEBUG_NORMAL | DEBUG_ERROR, "//Using Vertex outside buffer v0 = %i, n = %i\n", v0, n);
@@ -1225,6 +1453,7 @@ void gSPCBFDVertex( u32 a, u32 n, u32 v0 )
 		if (((gSP.geometryMode & G_TEXTURE_GEN) != 0) && ((gSP.changed & CHANGED_LOOKAT) != 0))
 			gSPUpdateLookatVectors();
 	}
+	gSPUpdateLightState();
 
 	Vertex *vertex = (Vertex*)&RDRAM[address];
 
@@ -1306,6 +1535,8 @@ void gSPT3DUXVertex(u32 a, u32 n, u32 ci)
 	if ((address + sizeof(T3DUXVertex)* n) > RDRAMSize)
 		return;
 
+	gSPUpdateLightState();
+
 	GraphicsDrawer & drawer = dwnd().getDrawer();
 	u32 i = 0;
 #ifdef __VEC4_OPT
@@ -1660,6 +1891,8 @@ void gSPModifyVertex( u32 _vtx, u32 _where, u32 _val )
 	GraphicsDrawer & drawer = dwnd().getDrawer();
 
 	SPVertex & vtx0 = drawer.getVertex(_vtx);
+	if (_where == G_MWO_POINT_RGBA || _where == G_MWO_POINT_ST)
+		gSPResolveLightState(vtx0);
 	switch (_where) {
 		case G_MWO_POINT_RGBA:
 			vtx0.r = _SHIFTR( _val, 24, 8 ) * 0.0039215689f;
@@ -44,8 +44,23 @@ struct SPVertex
 	u8 HWLight;
 	u8 clip;
 	s16 flag;
+	u8 lightState;
 };
 
+#define LIGHTSTATES_SIZE 8
+
+// Lighting and texture generation state of vertices lit in the vertex shader.
+// Uploaded as LIGHTSTATE_VEC4 vec4 uniforms per state.
+struct SPLightState
+{
+	f32 dir[7][4];
+	f32 rgb[8][4];
+	f32 texGen[3][4];
+	f32 params[4]; // number of lights, texture generation mode, lookat enabled
+};
+
+#define LIGHTSTATE_VEC4 (sizeof(SPLightState) / (4 * sizeof(f32)))
+
 struct gSPInfo
 {
 	u32 segment[16];
@@ -91,6 +106,12 @@ struct gSPInfo
 	s32 numLights;
 	bool lookatEnable;
 
+	struct
+	{
+		SPLightState states[LIGHTSTATES_SIZE];
+		u32 num, current, version;
+	} lightStates;
+
 	struct
 	{
 		f32 scales, scalet;
@@ -173,6 +194,7 @@ void gSPModifyVertex(u32 _vtx, u32 _where, u32 _val );
 void gSPNumLights( s32 n );
 void gSPLightColor( u32 lightNum, u32 packedColor );
 void gSPFogFactor( s16 fm, s16 fo );
+void gSPResolveLightState(SPVertex & _vtx);
 void gSPPerspNormalize( u16 scale );
 void gSPTexture( f32 sc, f32 tc, s32 level, s32 tile, s32 on );
 void gSPEndDisplayList();
@@ -23,6 +23,10 @@ MY_LOCAL_SRC_FILES :=                               \
     $(SRCDIR)/CommonPluginAPI.cpp                   \
     $(SRCDIR)/Config.cpp                            \
     $(SRCDIR)/convert.cpp                           \
+    $(SRCDIR)/CRC.cpp                               \
+    $(SRCDIR)/CRC32.cpp                             \
+    $(SRCDIR)/CRC32_ARMV8.cpp                       \
+    $(SRCDIR)/CRC32_SSE42.cpp                       \
     $(SRCDIR)/CRC_OPT.cpp                           \
     $(SRCDIR)/DebugDump.cpp                         \
     $(SRCDIR)/Debugger.cpp                          \
@@ -58,6 +62,8 @@ MY_LOCAL_SRC_FILES :=                               \
     $(SRCDIR)/PaletteTexture.cpp                    \
     $(SRCDIR)/Performance.cpp                       \
     $(SRCDIR)/PostProcessor.cpp                     \
+    $(SRCDIR)/FrameCapture.cpp                      \
+    $(SRCDIR)/FrameCompare.cpp                      \
     $(SRCDIR)/RDP.cpp                               \
     $(SRCDIR)/RSP.cpp                               \
     $(SRCDIR)/S2DEX2.cpp                            \
@@ -69,6 +75,7 @@ MY_LOCAL_SRC_FILES :=                               \
     $(SRCDIR)/TextureFilterHandler.cpp              \
     $(SRCDIR)/Textures.cpp                          \
     $(SRCDIR)/Turbo3D.cpp                           \
+    $(SRCDIR)/VertexBatchCache.cpp                  \
     $(SRCDIR)/VI.cpp                                \
     $(SRCDIR)/ZlutTexture.cpp                       \
     $(SRCDIR)/ZSort.cpp                             \
@@ -100,6 +107,7 @@ MY_LOCAL_SRC_FILES :=                               \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_TextureManipulationObjectFactory.cpp   \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_UnbufferedDrawer.cpp                   \
     $(SRCDIR)/Graphics/OpenGLContext/opengl_Utils.cpp                              \
+    $(SRCDIR)/Graphics/OpenGLContext/opengl_TimerQueries.cpp                       \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerInputs.cpp                  \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerProgramBuilder.cpp          \
     $(SRCDIR)/Graphics/OpenGLContext/GLSL/glsl_CombinerProgramImpl.cpp             \
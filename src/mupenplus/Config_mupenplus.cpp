@@ -70,6 +70,10 @@ bool Config_SetDefault()
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultInt(g_configVideoGliden64, "CacheSize", config.texture.maxBytes / uMegabyte, "Size of texture cache in megabytes. Good value is VRAM*3/4");
 	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultInt(g_configVideoGliden64, "CachePolicy", config.texture.cachePolicy, "Texture cache eviction policy (0=least recently used, 1=2Q: textures used once are evicted before frequently used ones)");
+	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableTextureArray", config.texture.enableTextureArray, "Keep small textures in one texture array and wrap them in the shader, to save texture binds.");
+	assert(res == M64ERR_SUCCESS);
 	//#Emulation Settings
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableNoise", config.generalEmulation.enableNoise, "Enable color noise emulation.");
 	assert(res == M64ERR_SUCCESS);
@@ -77,6 +81,12 @@ bool Config_SetDefault()
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableHWLighting", config.generalEmulation.enableHWLighting, "Enable hardware per-pixel lighting.");
 	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableShaderLighting", config.generalEmulation.enableShaderLighting, "Calculate per-vertex lighting and texture coordinate generation in the vertex shader. Not used with per-pixel lighting.");
+	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableVertexCache", config.generalEmulation.enableVertexCache, "Reuse transformed and lit vertices of unchanged vertex data loaded with unchanged matrices and lights.");
+	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableDrawBatching", config.generalEmulation.enableDrawBatching, "Submit consecutive triangle draws with unchanged render state in one draw call.");
+	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "EnableShadersStorage", config.generalEmulation.enableShadersStorage, "Use persistent storage for compiled shaders.");
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultInt(g_configVideoGliden64, "CorrectTexrectCoords", config.generalEmulation.correctTexrectCoords, "Make texrect coordinates continuous to avoid black lines between them. (0=Off, 1=Auto, 2=Force)");
@@ -137,8 +147,14 @@ bool Config_SetDefault()
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "txDump", config.textureFilter.txDump, "Enable dump of loaded N64 textures.");
 	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "txHiresStream", config.textureFilter.txHiresStream, "Load hi-res textures in background on first use instead of loading the whole pack at startup.");
+	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultInt(g_configVideoGliden64, "txHiresCacheSize", config.textureFilter.txHiresCacheSize/uMegabyte, "Size of streamed hi-res textures cache in megabytes.");
+	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "txCacheCompression", config.textureFilter.txCacheCompression, "Zip textures cache.");
 	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "txBlockCompression", config.textureFilter.txBlockCompression, "Store enhanced and hi-res textures in GPU block compressed format (S3TC on desktop, ETC2 on GLES). Saves video memory at the cost of some quality.");
+	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "txForce16bpp", config.textureFilter.txForce16bpp, "Force use 16bit texture formats for HD textures.");
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "txSaveCache", config.textureFilter.txSaveCache, "Save texture cache to hard disk.");
@@ -181,6 +197,10 @@ bool Config_SetDefault()
 	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultBool(g_configVideoGliden64, "ShowPercent", config.onScreenDisplay.percent, "Show percent counter.");
 	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "ShowGPUTime", config.onScreenDisplay.gpuTime, "Show GPU time per frame, split into draw/blit/post-processing/readback stages. Requires GL timer queries.");
+	assert(res == M64ERR_SUCCESS);
+	res = ConfigSetDefaultBool(g_configVideoGliden64, "ShowStatistics", config.onScreenDisplay.statistics, "Show draw buffer, display list, vertex cache and texture cache statistics per frame.");
+	assert(res == M64ERR_SUCCESS);
 	res = ConfigSetDefaultInt(g_configVideoGliden64, "CountersPos", config.onScreenDisplay.pos,
 		"Counters position (1=top left, 2=top center, 4=top right, 8=bottom left, 16=bottom center, 32=bottom right)");
 	assert(res == M64ERR_SUCCESS);
@@ -190,6 +210,9 @@ bool Config_SetDefault()
 	res = ConfigSetDefaultInt(g_configVideoGliden64, "DebugDumpMode", config.debug.dumpMode, "Enable debug dump. Set 3 to normal or 7 to detailed dump.");
 	assert(res == M64ERR_SUCCESS);
 #endif
+	res = ConfigSetDefaultInt(g_configVideoGliden64, "FrameCaptureMode", config.debug.frameCapture,
+		"Record every presented frame to the user data folder (0=disable, 1=raw RGB, 2=Y4M, 3=compare with GLideN64_<rom>.golden.y4m and write a CSV report)");
+	assert(res == M64ERR_SUCCESS);
 
 	return ConfigSaveSection("Video-GLideN64") == M64ERR_SUCCESS;
 }
@@ -239,6 +262,10 @@ void Config_LoadCustomConfig()
 	if (result == M64ERR_SUCCESS) config.texture.bilinearMode = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "texture\\maxBytes", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.texture.maxBytes = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "texture\\cachePolicy", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.texture.cachePolicy = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "texture\\enableTextureArray", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.texture.enableTextureArray = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "texture\\screenShotFormat", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.texture.screenShotFormat = atoi(value);
 
@@ -248,6 +275,12 @@ void Config_LoadCustomConfig()
 	if (result == M64ERR_SUCCESS) config.generalEmulation.enableLOD = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\enableHWLighting", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.generalEmulation.enableHWLighting = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\enableShaderLighting", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.generalEmulation.enableShaderLighting = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\enableVertexCache", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.generalEmulation.enableVertexCache = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\enableDrawBatching", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.generalEmulation.enableDrawBatching = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\enableShadersStorage", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.generalEmulation.enableShadersStorage = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "generalEmulation\\correctTexrectCoords", value, sizeof(value));
@@ -298,10 +331,16 @@ void Config_LoadCustomConfig()
 	if (result == M64ERR_SUCCESS) config.textureFilter.txHresAltCRC = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txDump", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.textureFilter.txDump = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txHiresStream", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.textureFilter.txHiresStream = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txHiresCacheSize", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.textureFilter.txHiresCacheSize = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txForce16bpp", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.textureFilter.txForce16bpp = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txCacheCompression", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.textureFilter.txCacheCompression = atoi(value);
+	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txBlockCompression", value, sizeof(value));
+	if (result == M64ERR_SUCCESS) config.textureFilter.txBlockCompression = atoi(value);
 	result = ConfigExternalGetParameter(fileHandle, sectionName, "textureFilter\\txSaveCache", value, sizeof(value));
 	if (result == M64ERR_SUCCESS) config.textureFilter.txSaveCache = atoi(value);
 	ConfigExternalClose(fileHandle);
@@ -345,10 +384,15 @@ void Config_LoadConfig()
 	config.texture.bilinearMode = ConfigGetParamBool(g_configVideoGliden64, "bilinearMode");
 	config.texture.maxAnisotropy = ConfigGetParamInt(g_configVideoGliden64, "MaxAnisotropy");
 	config.texture.maxBytes = ConfigGetParamInt(g_configVideoGliden64, "CacheSize") * uMegabyte;
+	config.texture.cachePolicy = ConfigGetParamInt(g_configVideoGliden64, "CachePolicy");
+	config.texture.enableTextureArray = ConfigGetParamBool(g_configVideoGliden64, "EnableTextureArray");
 	//#Emulation Settings
 	config.generalEmulation.enableNoise = ConfigGetParamBool(g_configVideoGliden64, "EnableNoise");
 	config.generalEmulation.enableLOD = ConfigGetParamBool(g_configVideoGliden64, "EnableLOD");
 	config.generalEmulation.enableHWLighting = ConfigGetParamBool(g_configVideoGliden64, "EnableHWLighting");
+	config.generalEmulation.enableShaderLighting = ConfigGetParamBool(g_configVideoGliden64, "EnableShaderLighting");
+	config.generalEmulation.enableVertexCache = ConfigGetParamBool(g_configVideoGliden64, "EnableVertexCache");
+	config.generalEmulation.enableDrawBatching = ConfigGetParamBool(g_configVideoGliden64, "EnableDrawBatching");
 	config.generalEmulation.enableShadersStorage = ConfigGetParamBool(g_configVideoGliden64, "EnableShadersStorage");
 	config.generalEmulation.correctTexrectCoords = ConfigGetParamInt(g_configVideoGliden64, "CorrectTexrectCoords");
 	config.generalEmulation.enableNativeResTexrects = ConfigGetParamBool(g_configVideoGliden64, "EnableNativeResTexrects");
@@ -381,8 +425,11 @@ void Config_LoadConfig()
 	config.textureFilter.txHiresFullAlphaChannel = ConfigGetParamBool(g_configVideoGliden64, "txHiresFullAlphaChannel");
 	config.textureFilter.txHresAltCRC = ConfigGetParamBool(g_configVideoGliden64, "txHresAltCRC");
 	config.textureFilter.txDump = ConfigGetParamBool(g_configVideoGliden64, "txDump");
+	config.textureFilter.txHiresStream = ConfigGetParamBool(g_configVideoGliden64, "txHiresStream");
+	config.textureFilter.txHiresCacheSize = ConfigGetParamInt(g_configVideoGliden64, "txHiresCacheSize") * uMegabyte;
 	config.textureFilter.txForce16bpp = ConfigGetParamBool(g_configVideoGliden64, "txForce16bpp");
 	config.textureFilter.txCacheCompression = ConfigGetParamBool(g_configVideoGliden64, "txCacheCompression");
+	config.textureFilter.txBlockCompression = ConfigGetParamBool(g_configVideoGliden64, "txBlockCompression");
 	config.textureFilter.txSaveCache = ConfigGetParamBool(g_configVideoGliden64, "txSaveCache");
 	::mbstowcs(config.textureFilter.txPath, ConfigGetParamString(g_configVideoGliden64, "txPath"), PLUGIN_PATH_SIZE);
 
@@ -421,11 +468,14 @@ void Config_LoadConfig()
 	config.onScreenDisplay.fps = ConfigGetParamBool(g_configVideoGliden64, "ShowFPS");
 	config.onScreenDisplay.vis = ConfigGetParamBool(g_configVideoGliden64, "ShowVIS");
 	config.onScreenDisplay.percent = ConfigGetParamBool(g_configVideoGliden64, "ShowPercent");
+	config.onScreenDisplay.gpuTime = ConfigGetParamBool(g_configVideoGliden64, "ShowGPUTime");
+	config.onScreenDisplay.statistics = ConfigGetParamBool(g_configVideoGliden64, "ShowStatistics");
 	config.onScreenDisplay.pos = ConfigGetParamInt(g_configVideoGliden64, "CountersPos");
 
 #ifdef DEBUG_DUMP
 	config.debug.dumpMode = ConfigGetParamInt(g_configVideoGliden64, "DebugDumpMode");
 #endif
+	config.debug.frameCapture = ConfigGetParamInt(g_configVideoGliden64, "FrameCaptureMode");
 
 	if (config.generalEmulation.enableCustomSettings)
 		Config_LoadCustomConfig();
@@ -0,0 +1,151 @@
+// Randomized comparison of the vectorized UnswapCopyWrap and DWordInterleaveWrap
+// against the plain scalar code they replaced.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../convert.h"
+
+static u32 rngState = 0x9E3779B9;
+
+static
+u32 rand32()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static
+void RefUnswapCopyWrap(const u8 *src, u32 srcIdx, u8 *dest, u32 destIdx, u32 destMask, u32 numBytes)
+{
+	// copy leading bytes
+	u32 leadingBytes = srcIdx & 3;
+	if (leadingBytes != 0) {
+		leadingBytes = 4 - leadingBytes;
+		if ((u32)leadingBytes > numBytes)
+			leadingBytes = numBytes;
+		numBytes -= leadingBytes;
+
+		srcIdx ^= 3;
+		for (u32 i = 0; i < leadingBytes; i++) {
+			dest[destIdx&destMask] = src[srcIdx];
+			++destIdx;
+			--srcIdx;
+		}
+		srcIdx += 5;
+	}
+
+	// copy dwords
+	int numDWords = numBytes >> 2;
+	while (numDWords--) {
+		dest[(destIdx + 3) & destMask] = src[srcIdx++];
+		dest[(destIdx + 2) & destMask] = src[srcIdx++];
+		dest[(destIdx + 1) & destMask] = src[srcIdx++];
+		dest[(destIdx + 0) & destMask] = src[srcIdx++];
+		destIdx += 4;
+	}
+
+	// copy trailing bytes
+	int trailingBytes = numBytes & 3;
+	if (trailingBytes) {
+		srcIdx ^= 3;
+		for (int i = 0; i < trailingBytes; i++) {
+			dest[destIdx&destMask] = src[srcIdx];
+			++destIdx;
+			--srcIdx;
+		}
+	}
+}
+
+static
+void RefDWordInterleaveWrap(u32 *src, u32 srcIdx, u32 srcMask, u32 numQWords)
+{
+	u32 p0, idx0, idx1;
+	while (numQWords--)	{
+		idx0 = srcIdx++ & srcMask;
+		idx1 = srcIdx++ & srcMask;
+		p0 = src[idx0];
+		src[idx0] = src[idx1];
+		src[idx1] = p0;
+	}
+}
+
+// Power of two masks take the vector path, the others the scalar one.
+static
+u32 randomMask(u32 _maxMask)
+{
+	const u32 mask = (1U << (rand32() % 13)) - 1;
+	if (rand32() % 4 == 0)
+		return (mask & ~(1U << (rand32() % 12))) & _maxMask;
+	return mask & _maxMask;
+}
+
+static
+bool testUnswapCopyWrap(u32 _cases)
+{
+	const u32 tmemSize = 4096;
+	const u32 rdramSize = 16 * 1024;
+	std::vector<u8> rdram(rdramSize + 64);
+	std::vector<u8> tmem(tmemSize), refTmem(tmemSize);
+	for (u8 & b : rdram)
+		b = u8(rand32());
+
+	for (u32 c = 0; c < _cases; ++c) {
+		for (u32 i = 0; i < tmemSize; ++i)
+			tmem[i] = refTmem[i] = u8(rand32());
+
+		// Unaligned source pointers and indices, lengths of any size, destinations past the wrap point
+		const u32 srcOffset = rand32() % 16;
+		const u32 numBytes = rand32() % 2 == 0 ? rand32() % 64 : rand32() % (2 * tmemSize);
+		const u32 srcIdx = rand32() % (rdramSize - numBytes - 8);
+		const u32 destMask = randomMask(tmemSize - 1);
+		const u32 destIdx = rand32() % (4 * tmemSize);
+		const u8 * src = rdram.data() + srcOffset;
+
+		UnswapCopyWrap(src, srcIdx, tmem.data(), destIdx, destMask, numBytes);
+		RefUnswapCopyWrap(src, srcIdx, refTmem.data(), destIdx, destMask, numBytes);
+		if (memcmp(tmem.data(), refTmem.data(), tmemSize) != 0) {
+			printf("UnswapCopyWrap mismatch: src offset %u srcIdx %u destIdx %u destMask %x numBytes %u\n",
+				srcOffset, srcIdx, destIdx, destMask, numBytes);
+			return false;
+		}
+	}
+	return true;
+}
+
+static
+bool testDWordInterleaveWrap(u32 _cases)
+{
+	const u32 tmemWords = 1024;
+	std::vector<u32> tmem(tmemWords + 4), refTmem(tmemWords + 4);
+
+	for (u32 c = 0; c < _cases; ++c) {
+		for (u32 i = 0; i < tmem.size(); ++i)
+			tmem[i] = refTmem[i] = rand32();
+
+		const u32 srcOffset = rand32() % 4;
+		const u32 srcMask = randomMask(tmemWords - 1);
+		const u32 srcIdx = rand32() % (4 * tmemWords);
+		const u32 numQWords = rand32() % 2 == 0 ? rand32() % 16 : rand32() % tmemWords;
+
+		DWordInterleaveWrap(tmem.data() + srcOffset, srcIdx, srcMask, numQWords);
+		RefDWordInterleaveWrap(refTmem.data() + srcOffset, srcIdx, srcMask, numQWords);
+		if (memcmp(tmem.data(), refTmem.data(), tmem.size() * sizeof(u32)) != 0) {
+			printf("DWordInterleaveWrap mismatch: src offset %u srcIdx %u srcMask %x numQWords %u\n",
+				srcOffset, srcIdx, srcMask, numQWords);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 cases = 20000;
+	bool passed = testUnswapCopyWrap(cases);
+	passed = testDWordInterleaveWrap(cases) && passed;
+	printf("%s\n", passed ? "convert_test passed" : "convert_test FAILED");
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Throughput of the texture enhancement filters per filter and scale, run on the
+// calling thread and in row slices on the filter thread pool.
+// Also checks that the sliced output matches the single threaded one.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../GLideNHQ/TextureFilters.h"
+#include "../GLideNHQ/TxThreadPool.h"
+
+struct Filter
+{
+	const char * name;
+	uint32 filter;
+	uint32 scale;
+};
+
+static const Filter filters[] = {
+	{ "2xsai", X2SAI_ENHANCEMENT, 2 },
+	{ "hq2x", HQ2X_ENHANCEMENT, 2 },
+	{ "hq2xs", HQ2XS_ENHANCEMENT, 2 },
+	{ "lq2x", LQ2X_ENHANCEMENT, 2 },
+	{ "lq2xs", LQ2XS_ENHANCEMENT, 2 },
+	{ "hq4x", HQ4X_ENHANCEMENT, 4 },
+	{ "xbrz2x", BRZ2X_ENHANCEMENT, 2 },
+	{ "xbrz3x", BRZ3X_ENHANCEMENT, 3 },
+	{ "xbrz4x", BRZ4X_ENHANCEMENT, 4 },
+	{ "xbrz5x", BRZ5X_ENHANCEMENT, 5 },
+	{ "xbrz6x", BRZ6X_ENHANCEMENT, 6 },
+};
+
+// Flat colour blocks with diagonal edges, a dithered gradient and a transparent border,
+// like typical N64 textures.
+static
+void makeTexture(uint32 _width, uint32 _height, std::vector<uint32> & _tex)
+{
+	static const uint32 palette[] = { 0xFF2040C0, 0xFF30A050, 0xFFE0E0E0, 0xFF102030, 0xFF8060F0, 0xFFF0C020 };
+	_tex.resize(_width * _height);
+	for (uint32 y = 0; y < _height; ++y) {
+		for (uint32 x = 0; x < _width; ++x) {
+			uint32 c = palette[((x + y / 2) / 12 + (x / 2 + y) / 9) % 6];
+			if (y > _height / 2) {
+				const uint32 g = (x * 255 / _width + ((x ^ y) & 3) * 4) & 0xFF;
+				c = 0xFF000000 | (g << 16) | ((255 - g) << 8) | (y & 0x7F);
+			}
+			if (x < 2 || y < 2)
+				c &= 0x00FFFFFF;
+			_tex[y * _width + x] = c;
+		}
+	}
+}
+
+static
+uint32 checksum(const std::vector<uint32> & _data)
+{
+	uint32 hash = 2166136261U;
+	for (uint32 v : _data)
+		hash = (hash ^ v) * 16777619U;
+	return hash;
+}
+
+// Returns milliseconds per call.
+static
+double run(const Filter & _filter, bool _sliced, std::vector<uint32> & _src, uint32 _width, uint32 _height, std::vector<uint32> & _dst)
+{
+	// Enough calls for about 4M output texels, at least 3.
+	const uint32 calls = std::max(3U, (4U << 20) / (_width * _height * _filter.scale * _filter.scale));
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < calls; ++i) {
+		if (_sliced)
+			filter_8888_sliced(_src.data(), _width, _height, _dst.data(), _filter.filter);
+		else
+			filter_8888(_src.data(), _width, _height, _dst.data(), _filter.filter, 0);
+	}
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count() / calls;
+}
+
+int main(int argc, char* argv[])
+{
+	xbrz::init();
+
+	bool passed = true;
+	const uint32 sizes[] = { 64, 256 };
+	printf("%u threads\n", TxThreadPool::getInstance()->concurrency());
+	printf("%-8s %5s %10s %10s %10s %10s %10s\n", "filter", "size", "ms", "Mtexel/s", "sliced ms", "Mtexel/s", "checksum");
+	for (uint32 size : sizes) {
+		std::vector<uint32> src;
+		makeTexture(size, size, src);
+		for (const Filter & filter : filters) {
+			const uint32 dstSize = size * size * filter.scale * filter.scale;
+			std::vector<uint32> single(dstSize), sliced(dstSize);
+			const double ms = run(filter, false, src, size, size, single);
+			const double slicedMs = filter_8888_sliceable(filter.filter) ? run(filter, true, src, size, size, sliced) : 0.0;
+			// Throughput in output texels
+			printf("%-8s %5u %10.3f %10.1f %10.3f %10.1f   %08x", filter.name, size,
+				ms, dstSize / ms / 1000.0,
+				slicedMs, slicedMs > 0.0 ? dstSize / slicedMs / 1000.0 : 0.0,
+				checksum(single));
+			if (slicedMs > 0.0 && sliced != single) {
+				printf(" sliced output differs");
+				passed = false;
+			}
+			printf("\n");
+		}
+	}
+
+	TxThreadPool::getInstance()->shutdown();
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// Records a sequence of rendered frames as a golden Y4M stream, replays it with
+// changes and checks the per-frame results of the golden comparison.
+// Frames come from a small software renderer, since replaying display list
+// traces needs the emulator core and a GL context.
+
+#include <stdio.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../FrameCompare.h"
+
+static const u32 numFrames = 16;
+
+struct Change
+{
+	s32 noise = 0;			// added to every sample, alternating sign
+	u32 movedFrame = ~0U;	// frame whose sprite is drawn elsewhere
+	u32 resizedFrame = ~0U;	// frame rendered at another size
+};
+
+// A gradient background with a sprite moving across it, as bottom-up RGBA.
+static
+void renderFrame(u32 _frame, u32 _width, u32 _height, const Change & _change, std::vector<u8> & _rgba)
+{
+	_rgba.resize(_width * _height * 4);
+	const u32 spriteX = (_frame * 7 + (_frame == _change.movedFrame ? _width / 2 : 0)) % (_width - 8);
+	const u32 spriteY = (_frame * 3) % (_height - 8);
+	for (u32 y = 0; y < _height; ++y) {
+		for (u32 x = 0; x < _width; ++x) {
+			u8 * p = &_rgba[((_height - 1 - y) * _width + x) * 4];
+			const bool sprite = x >= spriteX && x < spriteX + 8 && y >= spriteY && y < spriteY + 8;
+			s32 c[3] = { s32(x * 255 / _width), s32(y * 255 / _height), sprite ? 240 : 64 };
+			for (u32 i = 0; i < 3; ++i) {
+				const s32 v = c[i] + (((x + y + i) & 1) != 0 ? _change.noise : -_change.noise);
+				p[i] = u8(v < 0 ? 0 : (v > 255 ? 255 : v));
+			}
+			p[3] = 255;
+		}
+	}
+}
+
+static
+std::string recordGolden(u32 _width, u32 _height, u32 _frames)
+{
+	std::ostringstream golden;
+	std::vector<u8> rgba, i420;
+	FrameCompare::writeY4MHeader(golden, _width, _height, 60);
+	for (u32 f = 0; f < _frames; ++f) {
+		renderFrame(f, _width, _height, Change(), rgba);
+		FrameCompare::convertToI420(rgba.data(), _width, _height, i420);
+		FrameCompare::writeY4MFrame(golden, i420);
+	}
+	return golden.str();
+}
+
+// Replays numFrames frames against _golden, as the frame compare capture mode does.
+// Returns the results, one character per frame: p(ass), f(ail), s(ize), m(issing).
+static
+std::string replay(const std::string & _golden, u32 _width, u32 _height, const Change & _change, bool _verbose)
+{
+	std::istringstream golden(_golden);
+	u32 goldenWidth, goldenHeight;
+	if (!FrameCompare::readY4MHeader(golden, goldenWidth, goldenHeight))
+		return "header";
+
+	std::string results;
+	std::vector<u8> rgba, i420, goldenFrame;
+	for (u32 f = 0; f < numFrames; ++f) {
+		const u32 width = f == _change.resizedFrame ? _width + 16 : _width;
+		renderFrame(f, width, _height, _change, rgba);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		char result;
+		FrameCompare::Result compared;
+		if (!FrameCompare::readY4MFrame(golden, goldenWidth, goldenHeight, goldenFrame))
+			result = 'm';
+		else if ((width & ~1U) != goldenWidth || (_height & ~1U) != goldenHeight)
+			result = 's';
+		else {
+			FrameCompare::convertToI420(rgba.data(), width, _height, i420);
+			compared = FrameCompare::compare(i420, goldenFrame);
+			result = compared.pass ? 'p' : 'f';
+		}
+		const f32 ms = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (_verbose)
+			printf("  frame %2u %.3f ms psnr %5.1f max %3u diff %5u %c\n",
+				f, ms, compared.psnr, compared.maxDiff, compared.diffSamples, result);
+		results += result;
+	}
+	return results;
+}
+
+static
+bool check(const char * _name, const std::string & _results, const std::string & _expected)
+{
+	const bool passed = _results == _expected;
+	printf("%-32s %s %s\n", _name, _results.c_str(), passed ? "ok" : ("expected " + _expected).c_str());
+	return passed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 width = 64, height = 48;
+	const std::string golden = recordGolden(width, height, numFrames);
+	const std::string allPass(numFrames, 'p');
+
+	bool passed = true;
+	printf("unchanged replay:\n");
+	passed = check("unchanged", replay(golden, width, height, Change(), true), allPass) && passed;
+
+	Change noise;
+	noise.noise = 3;
+	passed = check("noise within tolerance", replay(golden, width, height, noise, false), allPass) && passed;
+
+	Change moved;
+	moved.movedFrame = 5;
+	std::string expected = allPass;
+	expected[5] = 'f';
+	passed = check("moved sprite in frame 5", replay(golden, width, height, moved, false), expected) && passed;
+
+	// The golden frame of a resized frame is consumed, so later frames stay in step.
+	Change resized;
+	resized.resizedFrame = 9;
+	expected = allPass;
+	expected[9] = 's';
+	passed = check("resized frame 9", replay(golden, width, height, resized, false), expected) && passed;
+
+	const std::string shortGolden = recordGolden(width, height, numFrames - 4);
+	expected = std::string(numFrames - 4, 'p') + std::string(4, 'm');
+	passed = check("golden 4 frames short", replay(shortGolden, width, height, Change(), false), expected) && passed;
+
+	// The odd last row and column are not recorded.
+	const std::string oddGolden = recordGolden(width + 1, height + 1, numFrames);
+	passed = check("odd frame size", replay(oddGolden, width + 1, height + 1, Change(), false), allPass) && passed;
+
+	printf("%s\n", passed ? "frame_compare_test passed" : "frame_compare_test FAILED");
+	return passed ? 0 : 1;
+}